@@ -0,0 +1,446 @@
+#include "corpus.h"
+
+#include <cstdint>
+#include <cstdio>
+
+namespace jiayuancs {
+namespace jsoncpp {
+namespace bench {
+
+namespace {
+
+// splitmix64，不依赖标准库分布的实现，各平台生成的语料相同
+class Random final {
+ public:
+  explicit Random(std::uint64_t seed) : state_(seed) {}
+
+  std::uint64_t Next() {
+    std::uint64_t value = (state_ += 0x9E3779B97F4A7C15ULL);
+    value = (value ^ (value >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    value = (value ^ (value >> 27)) * 0x94D049BB133111EBULL;
+    return value ^ (value >> 31);
+  }
+
+  // [0, n)中的整数
+  std::uint64_t Below(std::uint64_t n) { return Next() % n; }
+  // [low, high)中的浮点数
+  double Uniform(double low, double high) {
+    return low + (high - low) * static_cast<double>(Next() >> 11) /
+                     static_cast<double>(1ULL << 53);
+  }
+  // 概率为percent%的事件
+  bool Chance(int percent) {
+    return Below(100) < static_cast<std::uint64_t>(percent);
+  }
+
+ private:
+  std::uint64_t state_;
+};
+
+const char *const kWords[] = {
+    "json",   "parser", "fast",   "value",  "object", "array",  "string",
+    "number", "stream", "token",  "buffer", "memory", "cache",  "thread",
+    "hello",  "world",  "today",  "great",  "photo",  "music",  "travel",
+    "coffee", "team",   "game",   "night",  "happy",  "follow", "share",
+};
+const std::size_t kWordCount = sizeof(kWords) / sizeof(kWords[0]);
+
+// 需要转义或多字节编码的片段
+const char *const kSpecials[] = {
+    "\\n",
+    "\\\"",
+    "\\\\",
+    "\\/",
+    "\\u00e9",
+    "\\u3042\\u3044",
+    "\\ud83d\\ude00",            // 代理对
+    "\xE4\xB8\xAD\xE6\x96\x87",  // UTF-8
+    "\xC3\xA9t\xC3\xA9",
+    "\xF0\x9F\x8E\x89",
+};
+const std::size_t kSpecialCount = sizeof(kSpecials) / sizeof(kSpecials[0]);
+
+void AppendInteger(long long value, std::string &out) {
+  out += std::to_string(value);
+}
+
+void AppendDouble(double value, std::string &out) {
+  char buffer[32];
+  std::snprintf(buffer, sizeof(buffer), "%.15g", value);
+  out += buffer;
+}
+
+void AppendKey(const char *key, std::string &out) {
+  out += '\"';
+  out += key;
+  out += "\": ";
+}
+
+// 由words个单词组成的句子，special_percent为插入特殊片段的概率
+void AppendSentence(Random &random, int words, int special_percent,
+                    std::string &out) {
+  out += '\"';
+  for (int i = 0; i < words; ++i) {
+    if (i != 0) {
+      out += ' ';
+    }
+    if (random.Chance(special_percent)) {
+      out += kSpecials[random.Below(kSpecialCount)];
+    } else {
+      out += kWords[random.Below(kWordCount)];
+    }
+  }
+  out += '\"';
+}
+
+// 由小写字母和数字组成的标识符
+void AppendIdentifier(Random &random, int length, std::string &out) {
+  static const char kChars[] = "abcdefghijklmnopqrstuvwxyz0123456789_";
+  out += '\"';
+  for (int i = 0; i < length; ++i) {
+    out += kChars[random.Below(sizeof(kChars) - 1)];
+  }
+  out += '\"';
+}
+
+void AppendUser(Random &random, std::string &out) {
+  long long id = static_cast<long long>(random.Below(3000000000ULL));
+  out += '{';
+  AppendKey("id", out);
+  AppendInteger(id, out);
+  out += ", ";
+  AppendKey("id_str", out);
+  out += '\"' + std::to_string(id) + "\", ";
+  AppendKey("name", out);
+  AppendSentence(random, 2, 30, out);
+  out += ", ";
+  AppendKey("screen_name", out);
+  AppendIdentifier(random, 10, out);
+  out += ", ";
+  AppendKey("location", out);
+  AppendSentence(random, 1, 50, out);
+  out += ", ";
+  AppendKey("description", out);
+  AppendSentence(random, 12, 15, out);
+  out += ", ";
+  AppendKey("url", out);
+  out += "null, ";
+  AppendKey("protected", out);
+  out += "false, ";
+  AppendKey("followers_count", out);
+  AppendInteger(random.Below(100000), out);
+  out += ", ";
+  AppendKey("friends_count", out);
+  AppendInteger(random.Below(5000), out);
+  out += ", ";
+  AppendKey("created_at", out);
+  out += "\"Mon Jul 23 14:20:29 +0000 2012\", ";
+  AppendKey("verified", out);
+  out += random.Chance(5) ? "true" : "false";
+  out += ", ";
+  AppendKey("lang", out);
+  out += random.Chance(50) ? "\"ja\", " : "\"en\", ";
+  AppendKey("profile_image_url", out);
+  out += "\"http:\\/\\/pbs.twimg.com\\/profile_images\\/";
+  out += std::to_string(random.Below(1000000000)) + "\\/a_normal.jpeg\"";
+  out += '}';
+}
+
+void AppendTweet(Random &random, std::string &out) {
+  long long id = 505874924095815681LL + random.Below(1000000000);
+  out += '{';
+  AppendKey("created_at", out);
+  out += "\"Sun Aug 31 00:29:15 +0000 2014\", ";
+  AppendKey("id", out);
+  AppendInteger(id, out);
+  out += ", ";
+  AppendKey("id_str", out);
+  out += '\"' + std::to_string(id) + "\", ";
+  AppendKey("text", out);
+  AppendSentence(random, 8 + static_cast<int>(random.Below(16)), 20, out);
+  out += ", ";
+  AppendKey("source", out);
+  out += "\"<a href=\\\"http:\\/\\/twitter.com\\/download\\/iphone\\\" "
+         "rel=\\\"nofollow\\\">Twitter for iPhone<\\/a>\", ";
+  AppendKey("truncated", out);
+  out += "false, ";
+  AppendKey("in_reply_to_status_id", out);
+  out += "null, ";
+  AppendKey("user", out);
+  AppendUser(random, out);
+  out += ", ";
+  AppendKey("entities", out);
+  out += '{';
+  AppendKey("hashtags", out);
+  out += '[';
+  for (int i = 0, n = static_cast<int>(random.Below(4)); i < n; ++i) {
+    out += i != 0 ? ", {" : "{";
+    AppendKey("text", out);
+    AppendSentence(random, 1, 30, out);
+    out += ", ";
+    AppendKey("indices", out);
+    long long begin = random.Below(100);
+    out += '[' + std::to_string(begin) + ", " + std::to_string(begin + 8) +
+           "]}";
+  }
+  out += "], ";
+  AppendKey("user_mentions", out);
+  out += '[';
+  for (int i = 0, n = static_cast<int>(random.Below(3)); i < n; ++i) {
+    out += i != 0 ? ", {" : "{";
+    AppendKey("screen_name", out);
+    AppendIdentifier(random, 8, out);
+    out += ", ";
+    AppendKey("id", out);
+    AppendInteger(random.Below(3000000000ULL), out);
+    out += '}';
+  }
+  out += "]}, ";
+  AppendKey("retweet_count", out);
+  AppendInteger(random.Below(1000), out);
+  out += ", ";
+  AppendKey("favorite_count", out);
+  AppendInteger(random.Below(1000), out);
+  out += ", ";
+  AppendKey("favorited", out);
+  out += "false, ";
+  AppendKey("lang", out);
+  out += "\"ja\"}";
+}
+
+// 以整数为key的object，值为名称
+void AppendNameTable(Random &random, int count, std::string &out) {
+  out += '{';
+  for (int i = 0; i < count; ++i) {
+    if (i != 0) {
+      out += ", ";
+    }
+    out += '\"' + std::to_string(205705993 + i * 7) + "\": ";
+    AppendSentence(random, 1 + static_cast<int>(random.Below(3)), 10, out);
+  }
+  out += '}';
+}
+
+void AppendPerformance(Random &random, int id, std::string &out) {
+  out += '{';
+  AppendKey("eventId", out);
+  AppendInteger(138586341 + random.Below(200) * 2, out);
+  out += ", ";
+  AppendKey("id", out);
+  AppendInteger(339887544 + id, out);
+  out += ", ";
+  AppendKey("logo", out);
+  out += "null, ";
+  AppendKey("name", out);
+  out += "null, ";
+  AppendKey("prices", out);
+  out += '[';
+  int categories = 2 + static_cast<int>(random.Below(4));
+  for (int i = 0; i < categories; ++i) {
+    out += i != 0 ? ", {" : "{";
+    AppendKey("amount", out);
+    AppendInteger(10000 + random.Below(900) * 250, out);
+    out += ", ";
+    AppendKey("audienceSubCategoryId", out);
+    out += "337100890, ";
+    AppendKey("seatCategoryId", out);
+    AppendInteger(338937295 + i, out);
+    out += '}';
+  }
+  out += "], ";
+  AppendKey("seatCategories", out);
+  out += '[';
+  for (int i = 0; i < categories; ++i) {
+    out += i != 0 ? ", {" : "{";
+    AppendKey("areas", out);
+    out += '[';
+    for (int j = 0, n = 3 + static_cast<int>(random.Below(8)); j < n; ++j) {
+      out += j != 0 ? ", {" : "{";
+      AppendKey("areaId", out);
+      AppendInteger(205705993 + random.Below(40) * 7, out);
+      out += ", ";
+      AppendKey("blockIds", out);
+      out += "[]}";
+    }
+    out += "], ";
+    AppendKey("seatCategoryId", out);
+    AppendInteger(338937295 + i, out);
+    out += '}';
+  }
+  out += "], ";
+  AppendKey("seatMapImage", out);
+  out += "null, ";
+  AppendKey("start", out);
+  AppendInteger(1372354200000LL + random.Below(100000) * 60000, out);
+  out += ", ";
+  AppendKey("venueCode", out);
+  out += "\"PLEYEL_PLEYEL\"}";
+}
+
+}  // namespace
+
+std::string MakeTwitter() {
+  Random random(1);
+  std::string out = "{\"statuses\": [";
+  for (int i = 0; i < 400; ++i) {
+    if (i != 0) {
+      out += ",\n";
+    }
+    AppendTweet(random, out);
+  }
+  out += "],\n\"search_metadata\": {\"completed_in\": 0.087, \"count\": 400, "
+         "\"query\": \"%E4%B8%80\", \"max_id\": 505874924095815681}}";
+  return out;
+}
+
+std::string MakeCanada() {
+  Random random(2);
+  std::string out =
+      "{\"type\": \"FeatureCollection\", \"features\": [{\"type\": "
+      "\"Feature\", \"properties\": {\"name\": \"Canada\"}, \"geometry\": "
+      "{\"type\": \"Polygon\", \"coordinates\": [";
+  for (int ring = 0; ring < 480; ++ring) {
+    out += ring != 0 ? ",\n[" : "[";
+    // 随机游走，坐标保留与真实数据相近的有效数字
+    double longitude = random.Uniform(-141.0, -52.0);
+    double latitude = random.Uniform(41.0, 83.0);
+    for (int i = 0, n = 100 + static_cast<int>(random.Below(260)); i < n;
+         ++i) {
+      longitude += random.Uniform(-0.01, 0.01);
+      latitude += random.Uniform(-0.01, 0.01);
+      out += i != 0 ? ",[" : "[";
+      AppendDouble(longitude, out);
+      out += ',';
+      AppendDouble(latitude, out);
+      out += ']';
+    }
+    out += ']';
+  }
+  out += "]}}]}";
+  return out;
+}
+
+std::string MakeCitm() {
+  Random random(3);
+  std::string out = "{\n";
+  AppendKey("areaNames", out);
+  AppendNameTable(random, 40, out);
+  out += ",\n";
+  AppendKey("audienceSubCategoryNames", out);
+  out += "{\"337100890\": \"Abonn\xC3\xA9\"},\n";
+  AppendKey("events", out);
+  out += '{';
+  for (int i = 0; i < 200; ++i) {
+    int id = 138586341 + i * 2;
+    out += i != 0 ? ",\n\"" : "\"";
+    out += std::to_string(id) + "\": {";
+    AppendKey("description", out);
+    out += "null, ";
+    AppendKey("id", out);
+    AppendInteger(id, out);
+    out += ", ";
+    AppendKey("logo", out);
+    out += random.Chance(50) ? "null" : "\"/images/UE0AAAAACEKo6QAAAAZDSVRN\"";
+    out += ", ";
+    AppendKey("name", out);
+    AppendSentence(random, 3, 10, out);
+    out += ", ";
+    AppendKey("subTopicIds", out);
+    out += '[' + std::to_string(337184269 + random.Below(20)) + ", " +
+           std::to_string(337184283 + random.Below(20)) + "], ";
+    AppendKey("subjectCode", out);
+    out += "null, ";
+    AppendKey("subtitle", out);
+    out += "null, ";
+    AppendKey("topicIds", out);
+    out += '[' + std::to_string(324846099 + random.Below(20)) + ", " +
+           std::to_string(107888604 + random.Below(20)) + "]}";
+  }
+  out += "},\n";
+  AppendKey("performances", out);
+  out += '[';
+  for (int i = 0; i < 1200; ++i) {
+    if (i != 0) {
+      out += ",\n";
+    }
+    AppendPerformance(random, i, out);
+  }
+  out += "],\n";
+  AppendKey("seatCategoryNames", out);
+  AppendNameTable(random, 60, out);
+  out += ",\n";
+  AppendKey("topicNames", out);
+  AppendNameTable(random, 30, out);
+  out += ",\n";
+  AppendKey("venueNames", out);
+  out += "{\"PLEYEL_PLEYEL\": \"Salle Pleyel\"}\n}";
+  return out;
+}
+
+std::string MakeDeepNesting() {
+  Random random(4);
+  const int kDepth = 200;
+  std::string out = "[";
+  for (int chain = 0; chain < 1000; ++chain) {
+    out += chain != 0 ? ",\n" : "";
+    // 交替嵌套array和object，每层另有一个标量
+    std::string close;
+    for (int level = 0; level < kDepth; ++level) {
+      if (level % 2 == 0) {
+        out += '[';
+        AppendInteger(random.Below(1000), out);
+        out += ',';
+        close += ']';
+      } else {
+        out += "{\"n\":";
+        out += random.Chance(50) ? "true" : "null";
+        out += ",\"v\":";
+        close += '}';
+      }
+    }
+    out += "\"leaf\"";
+    out.append(close.rbegin(), close.rend());
+  }
+  out += ']';
+  return out;
+}
+
+std::string MakeLargeArray() {
+  Random random(5);
+  std::string out = "[";
+  for (int i = 0; i < 500000; ++i) {
+    if (i != 0) {
+      out += ',';
+    }
+    switch (i % 3) {
+      case 0:
+        AppendInteger(static_cast<long long>(random.Below(2000000)) - 1000000,
+                      out);
+        break;
+      case 1:
+        AppendDouble(random.Uniform(-1000.0, 1000.0), out);
+        break;
+      default:
+        out += '\"';
+        out += kWords[random.Below(kWordCount)];
+        out += '\"';
+        break;
+    }
+  }
+  out += ']';
+  return out;
+}
+
+std::vector<Corpus> MakeAllCorpora() {
+  return {
+      {"twitter", MakeTwitter()},
+      {"canada", MakeCanada()},
+      {"citm_catalog", MakeCitm()},
+      {"deep_nesting", MakeDeepNesting()},
+      {"large_array", MakeLargeArray()},
+  };
+}
+
+}  // namespace bench
+}  // namespace jsoncpp
+}  // namespace jiayuancs
@@ -0,0 +1,36 @@
+// 性能测试使用的合成语料，由固定种子的伪随机数生成，每次运行内容完全相同
+
+#ifndef JSONCPP_BENCH_CORPUS_H_
+#define JSONCPP_BENCH_CORPUS_H_
+
+#include <string>
+#include <vector>
+
+namespace jiayuancs {
+namespace jsoncpp {
+namespace bench {
+
+struct Corpus {
+  std::string name;
+  std::string text;  // JSON文本
+};
+
+// 类似twitter.json：以字符串为主，含转义字符和非ASCII字符
+std::string MakeTwitter();
+// 类似canada.json：以浮点数坐标为主
+std::string MakeCanada();
+// 类似citm_catalog.json：以object为主，大量较短的key和整数
+std::string MakeCitm();
+// 多条嵌套很深的array和object链
+std::string MakeDeepNesting();
+// 一个很大的扁平array，元素为整数、浮点数和短字符串
+std::string MakeLargeArray();
+
+// 以上全部语料
+std::vector<Corpus> MakeAllCorpora();
+
+}  // namespace bench
+}  // namespace jsoncpp
+}  // namespace jiayuancs
+
+#endif  // JSONCPP_BENCH_CORPUS_H_
@@ -0,0 +1,246 @@
+// 性能测试：对每份语料测量解析、序列化、拷贝、比较和析构等操作，
+// 输出吞吐量(按JSON文本的字节数计算)、平均每个节点的耗时和内存分配次数
+//
+// 用法：jsoncpp_bench [--min-time=秒] [语料名...]
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
+#include <new>
+#include <string>
+#include <vector>
+
+#include "cbor.h"
+#include "corpus.h"
+#include "json.h"
+#include "msgpack.h"
+#include "parser.h"
+
+using namespace jiayuancs::jsoncpp;
+
+namespace {
+
+std::size_t g_allocations = 0;  // operator new被调用的次数
+
+}  // namespace
+
+// 替换全局的operator new以统计分配次数，标准库容器同样经过这里
+void *operator new(std::size_t size) {
+  ++g_allocations;
+  void *pointer = std::malloc(size != 0 ? size : 1);
+  if (pointer == nullptr) {
+    throw std::bad_alloc();
+  }
+  return pointer;
+}
+void *operator new[](std::size_t size) { return ::operator new(size); }
+void operator delete(void *pointer) noexcept { std::free(pointer); }
+void operator delete[](void *pointer) noexcept { std::free(pointer); }
+void operator delete(void *pointer, std::size_t) noexcept {
+  std::free(pointer);
+}
+void operator delete[](void *pointer, std::size_t) noexcept {
+  std::free(pointer);
+}
+
+namespace {
+
+typedef std::chrono::steady_clock Clock;
+
+// 记录一次操作的耗时和期间的分配次数，准备工作不计入
+class Timer final {
+ public:
+  void Start() {
+    allocations_ = g_allocations;
+    start_ = Clock::now();
+  }
+  void Stop() {
+    seconds_ = std::chrono::duration<double>(Clock::now() - start_).count();
+    allocations_ = g_allocations - allocations_;
+  }
+
+  double Seconds() const { return seconds_; }
+  std::size_t Allocations() const { return allocations_; }
+
+ private:
+  Clock::time_point start_;
+  double seconds_ = 0;
+  std::size_t allocations_ = 0;
+};
+
+struct Operation {
+  const char *name;
+  std::function<void(Timer &)> run;  // 须恰好调用一次Start()和Stop()
+};
+
+// 阻止编译器优化掉结果未被使用的操作
+volatile std::size_t g_sink = 0;
+
+std::size_t CountNodes(const Json &json) {
+  std::size_t count = 1;
+  if (json.IsArray()) {
+    for (const Json &element : json.GetConstArray()) {
+      count += CountNodes(element);
+    }
+  } else if (json.IsObject()) {
+    for (const auto &member : json.GetConstObject()) {
+      count += CountNodes(member.second);
+    }
+  }
+  return count;
+}
+
+void RunCorpus(const bench::Corpus &corpus, double min_time) {
+  const Json document = Parser(corpus.text).Parse();
+  const Json document_copy = document;
+  const std::string cbor_data = cbor::Encode(document);
+  const std::string msgpack_data = msgpack::Encode(document);
+  const std::size_t nodes = CountNodes(document);
+
+  std::vector<Operation> operations = {
+      {"parse",
+       [&](Timer &timer) {
+         timer.Start();
+         Json json = Parser(corpus.text).Parse();
+         timer.Stop();
+         g_sink += json.IsObject();
+       }},
+      {"parse (index)",
+       [&](Timer &timer) {
+         timer.Start();
+         Parser parser(corpus.text);
+         parser.UseStructuralIndex();
+         Json json = parser.Parse();
+         timer.Stop();
+         g_sink += json.IsObject();
+       }},
+      {"dump",
+       [&](Timer &timer) {
+         timer.Start();
+         std::string text = document.dump();
+         timer.Stop();
+         g_sink += text.size();
+       }},
+      {"copy",
+       [&](Timer &timer) {
+         timer.Start();
+         Json copy(document);
+         timer.Stop();
+         g_sink += copy.IsObject();
+       }},
+      {"operator==",
+       [&](Timer &timer) {
+         timer.Start();
+         bool equal = document == document_copy;
+         timer.Stop();
+         if (!equal) {
+           std::fprintf(stderr, "%s: copy differs\n", corpus.name.c_str());
+           std::exit(1);
+         }
+       }},
+      {"destroy",
+       [&](Timer &timer) {
+         Json *copy = new Json(document);
+         timer.Start();
+         delete copy;
+         timer.Stop();
+       }},
+      {"cbor encode",
+       [&](Timer &timer) {
+         timer.Start();
+         std::string data = cbor::Encode(document);
+         timer.Stop();
+         g_sink += data.size();
+       }},
+      {"cbor decode",
+       [&](Timer &timer) {
+         timer.Start();
+         Json json = cbor::Decode(cbor_data);
+         timer.Stop();
+         g_sink += json.IsObject();
+       }},
+      {"msgpack encode",
+       [&](Timer &timer) {
+         timer.Start();
+         std::string data = msgpack::Encode(document);
+         timer.Stop();
+         g_sink += data.size();
+       }},
+      {"msgpack decode",
+       [&](Timer &timer) {
+         timer.Start();
+         Json json = msgpack::Decode(msgpack_data);
+         timer.Stop();
+         g_sink += json.IsObject();
+       }},
+  };
+
+  std::printf("%s: %.1f KB, %zu nodes\n", corpus.name.c_str(),
+              corpus.text.size() / 1024.0, nodes);
+  std::printf("  %-16s %10s %10s %12s\n", "operation", "MB/s", "ns/node",
+              "allocs");
+  for (const Operation &operation : operations) {
+    // 至少重复3次且总时间不少于min_time，取最短的一次
+    Timer timer;
+    double best = 0;
+    double total = 0;
+    for (int i = 0; i < 3 || total < min_time; ++i) {
+      operation.run(timer);
+      total += timer.Seconds();
+      if (i == 0 || timer.Seconds() < best) {
+        best = timer.Seconds();
+      }
+    }
+    std::printf("  %-16s %10.1f %10.2f %12zu\n", operation.name,
+                corpus.text.size() / best / 1e6, best * 1e9 / nodes,
+                timer.Allocations());
+  }
+  std::printf("\n");
+}
+
+}  // namespace
+
+int main(int argc, char **argv) {
+  double min_time = 0.5;
+  std::vector<std::string> selected;
+  for (int i = 1; i < argc; ++i) {
+    if (std::strncmp(argv[i], "--min-time=", 11) == 0) {
+      min_time = std::atof(argv[i] + 11);
+    } else {
+      selected.push_back(argv[i]);
+    }
+  }
+
+#ifndef NDEBUG
+  std::fprintf(stderr,
+               "warning: built without NDEBUG, timings of an unoptimized "
+               "build are not representative; configure with "
+               "-DCMAKE_BUILD_TYPE=Release\n");
+#endif  // NDEBUG
+#ifdef JSONCPP_FLAT_OBJECT
+  std::printf("object type: ObjectMap (JSONCPP_FLAT_OBJECT=ON)\n\n");
+#else
+  std::printf("object type: std::map (JSONCPP_FLAT_OBJECT=OFF)\n\n");
+#endif  // JSONCPP_FLAT_OBJECT
+
+  bool found = selected.empty();
+  for (const bench::Corpus &corpus : bench::MakeAllCorpora()) {
+    bool wanted = selected.empty();
+    for (const std::string &name : selected) {
+      wanted = wanted || name == corpus.name;
+    }
+    if (wanted) {
+      found = true;
+      RunCorpus(corpus, min_time);
+    }
+  }
+  if (!found) {
+    std::fprintf(stderr,
+                 "unknown corpus; available: twitter canada citm_catalog "
+                 "deep_nesting large_array\n");
+    return 1;
+  }
+  return 0;
+}
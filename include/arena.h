@@ -0,0 +1,146 @@
+// 单调(monotonic)内存分配器，用于批量分配和整体释放Json对象树
+
+#ifndef JSONCPP_INCLUDE_ARENA_H_
+#define JSONCPP_INCLUDE_ARENA_H_
+
+#include <cstddef>
+#include <new>
+#include <type_traits>
+
+#include "jsoncpp_config.h"
+#include "stats.h"
+
+namespace jiayuancs {
+namespace jsoncpp {
+
+// 从大块内存中顺序分配，单独的释放操作什么也不做，
+// 调用Reset()或析构时一次性归还所有内存块
+// 对于自身还持有堆内存的对象(如超出短字符串优化长度的std::string)，
+// 可通过AddCleanup注册清理函数，Reset()时按注册的逆序调用
+// 非线程安全，每个线程应使用各自的Arena
+class Arena final {
+ public:
+  static const std::size_t kDefaultBlockSize = 64 * 1024;
+
+  explicit Arena(std::size_t block_size = kDefaultBlockSize);
+  // 优先使用调用者提供的缓冲区，用完后再从堆上分配新的内存块
+  // 缓冲区由调用者管理，不会被释放
+  Arena(void *buffer, std::size_t size,
+        std::size_t block_size = kDefaultBlockSize);
+  ~Arena();
+
+  Arena(const Arena &) = delete;
+  Arena &operator=(const Arena &) = delete;
+
+  // 分配size字节、按alignment对齐的内存，alignment须为2的幂
+  void *Allocate(std::size_t size, std::size_t alignment);
+
+  // 注册清理函数，Reset()或析构时调用cleanup(object)
+  void AddCleanup(void (*cleanup)(void *), void *object);
+  template <typename T>
+  void AddDestructor(T *object) {
+    AddCleanup(&Destroy<T>, object);
+  }
+
+  // 调用所有清理函数，归还所有从堆上分配的内存块
+  // 之前分配的内存全部失效，之后可继续使用该Arena
+  void Reset();
+
+  // 已分配给调用者的字节数(不含对齐填充)
+  std::size_t BytesUsed() const { return bytes_used_; }
+  // 从堆上申请的内存块总字节数
+  std::size_t BytesReserved() const { return bytes_reserved_; }
+
+ private:
+  struct Block {
+    Block *next;
+#ifdef JSONCPP_STATS
+    std::size_t size;  // 用于通知AllocationHook释放的字节数
+#endif  // JSONCPP_STATS
+  };
+  struct Cleanup {
+    void (*cleanup)(void *);
+    void *object;
+    Cleanup *next;
+  };
+
+  template <typename T>
+  static void Destroy(void *object) {
+    static_cast<T *>(object)->~T();
+  }
+
+  void *AllocateSlow(std::size_t size, std::size_t alignment);
+
+  std::size_t block_size_;
+  char *initial_buffer_;
+  std::size_t initial_size_;
+
+  char *cur_;          // 当前内存块中下一个可用字节
+  char *end_;          // 当前内存块的结束位置
+  Block *blocks_;      // 从堆上分配的内存块链表
+  Cleanup *cleanups_;  // 清理函数链表，其节点也分配在Arena上
+  std::size_t bytes_used_;
+  std::size_t bytes_reserved_;
+};
+
+// 基于Arena的标准库分配器，arena为nullptr时使用全局的operator new/delete
+// 拷贝构造容器时得到的新容器总是分配在堆上，因此从Arena中拷贝出的数据
+// 不受Arena释放的影响
+template <typename T>
+class ArenaAllocator {
+ public:
+  typedef T value_type;
+  typedef std::false_type propagate_on_container_copy_assignment;
+  typedef std::false_type propagate_on_container_move_assignment;
+  typedef std::false_type propagate_on_container_swap;
+
+  ArenaAllocator() noexcept : arena_(nullptr) {}
+  explicit ArenaAllocator(Arena *arena) noexcept : arena_(arena) {}
+  template <typename U>
+  ArenaAllocator(const ArenaAllocator<U> &other) noexcept
+      : arena_(other.arena()) {}
+
+  T *allocate(std::size_t n) {
+    if (arena_ == nullptr) {
+#ifdef JSONCPP_STATS
+      NotifyAllocate(n * sizeof(T));
+#endif  // JSONCPP_STATS
+      return static_cast<T *>(::operator new(n * sizeof(T)));
+    }
+    return static_cast<T *>(arena_->Allocate(n * sizeof(T), alignof(T)));
+  }
+  void deallocate(T *pointer, std::size_t n) noexcept {
+    if (arena_ == nullptr) {
+#ifdef JSONCPP_STATS
+      NotifyDeallocate(n * sizeof(T));
+#else
+      static_cast<void>(n);
+#endif  // JSONCPP_STATS
+      ::operator delete(pointer);
+    }
+  }
+
+  ArenaAllocator select_on_container_copy_construction() const {
+    return ArenaAllocator();
+  }
+
+  Arena *arena() const noexcept { return arena_; }
+
+ private:
+  Arena *arena_;
+};
+
+template <typename T, typename U>
+bool operator==(const ArenaAllocator<T> &lhs, const ArenaAllocator<U> &rhs) {
+  return lhs.arena() == rhs.arena();
+}
+
+template <typename T, typename U>
+bool operator!=(const ArenaAllocator<T> &lhs, const ArenaAllocator<U> &rhs) {
+  return !(lhs == rhs);
+}
+
+}  // namespace jsoncpp
+}  // namespace jiayuancs
+
+#endif  // JSONCPP_INCLUDE_ARENA_H_
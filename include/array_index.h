@@ -0,0 +1,88 @@
+// 按字段值查找array元素的哈希索引
+
+#ifndef JSONCPP_INCLUDE_ARRAY_INDEX_H_
+#define JSONCPP_INCLUDE_ARRAY_INDEX_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "json.h"
+
+namespace jiayuancs {
+namespace jsoncpp {
+
+// 为由object组成的array建立从某个字段的值到元素下标的哈希索引，例如：
+//   ArrayIndex index(users, "id");     // 按字段"id"
+//   ArrayIndex index(users, "/a/b");   // 按JSON Pointer(RFC 6901)指向的值
+//   std::size_t position;
+//   if (index.Find(42, position)) users[position] ...
+// 只索引null、bool、数字和字符串，字段不存在或值为array、object的元素不会被索引
+// 值按Json的operator==比较，整数1与浮点数1.0不相等
+//
+// 索引持有array的地址，不持有数据，array须比索引存活更久
+// 调用GetArray()、PushBack()、TakeArray()或对array整体赋值后，
+// 索引变为过期状态(Stale())，此时查找抛出异常，需调用Rebuild()重建。
+// 只读遍历应使用GetConstArray()，否则同样视为过期。以下修改不会被检测到，
+// 需要手动重建：通过operator[]原地修改元素，以及通过建立索引之前取得的
+// GetArray()的返回值修改array
+class ArrayIndex final {
+ public:
+  // path以'/'开头时视为JSON Pointer，否则视为字段名，为空时按元素自身的值索引
+  // array不是array类型、path格式错误或元素个数超过UINT32_MAX时
+  // 抛出std::logic_error
+  ArrayIndex(const Json &array, const std::string &path);
+
+  // 按array的当前内容重建索引
+  void Rebuild();
+
+  // 建立索引之后array是否被修改过，根据修改计数、元素个数和存储位置判断
+  // 调用了GetArray()但实际没有修改时同样视为过期
+  bool Stale() const;
+
+  // 查找第一个字段值等于value的元素，找到时写入其下标并返回true
+  // 索引过期时抛出std::logic_error，下同
+  bool Find(const Json &value, std::size_t &position) const;
+  // 所有字段值等于value的元素的下标，按升序排列
+  std::vector<std::size_t> FindAll(const Json &value) const;
+  // 字段值等于value的元素个数
+  std::size_t Count(const Json &value) const;
+
+  // 被索引的元素个数
+  std::size_t Size() const { return size_; }
+
+ private:
+  // 返回元素中path指向的值，不存在时返回nullptr
+  const Json *Resolve(const Json &element) const;
+  // 查找值等于value的分组，返回其编号，不存在时返回UINT32_MAX
+  std::uint32_t FindGroup(const Json &value, std::size_t hash) const;
+  // 检查索引是否过期，function_name用于错误信息
+  void CheckFresh(const char *function_name) const;
+
+  const Json *array_;
+  std::vector<std::string> path_;  // 已解码的各级路径
+
+  // 值相同的元素属于同一个分组，组内按下标升序串成链表，
+  // 避免重复值很多时(如按状态字段索引)哈希表退化
+  struct Group {
+    std::size_t hash;     // 值的哈希，探测时先比较哈希
+    std::uint32_t head;   // 第一个元素的下标
+    std::uint32_t tail;   // 最后一个元素的下标
+    std::uint32_t count;  // 元素个数
+  };
+  std::vector<std::uint32_t> slots_;  // 开放寻址，存放分组编号加1，0表示空槽
+  std::vector<Group> groups_;
+  std::vector<std::uint32_t> next_;  // 下一个同值元素的下标加1，0表示链表结束
+
+  // 建立索引时array的状态，用于判断是否过期
+  const Json *data_ = nullptr;
+  std::size_t array_size_ = 0;
+  std::uint32_t revision_ = 0;
+  std::size_t size_ = 0;
+};
+
+}  // namespace jsoncpp
+}  // namespace jiayuancs
+
+#endif  // JSONCPP_INCLUDE_ARRAY_INDEX_H_
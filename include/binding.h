@@ -0,0 +1,505 @@
+// C++结构体与JSON之间的直接绑定：解析时直接填充结构体，序列化时直接读取
+// 结构体，都不经过Json对象
+
+#ifndef JSONCPP_INCLUDE_BINDING_H_
+#define JSONCPP_INCLUDE_BINDING_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <map>
+#include <string>
+#include <type_traits>
+#include <vector>
+#if __cplusplus >= 201703L
+#include <optional>
+#endif
+
+#include "handler.h"
+#include "parser.h"
+
+// 在结构体所在的命名空间中声明结构体与JSON object的绑定，例如：
+//
+//   struct Order {
+//     long long id;
+//     double price;
+//     std::vector<Item> items;
+//   };
+//   JSONCPP_BIND(Order, id, price, items)
+//
+// 成员须为public，最多16个，key与成员名相同。成员的类型可以是bool、
+// 整数、浮点数、std::string、已绑定的结构体，以及元素为这些类型的
+// std::vector(std::vector<bool>除外)、std::map<std::string, T>和
+// std::optional(需C++17)
+// 宏生成的函数按key的哈希值switch，哈希值在编译期计算，
+// 两个成员名的哈希值相同时编译失败
+#define JSONCPP_BIND(Type, ...)                                             \
+  inline ::jiayuancs::jsoncpp::binding::Slot JsoncppBindMember(             \
+      Type &object, const std::string &key) {                               \
+    switch (::jiayuancs::jsoncpp::binding::HashKey(key.data(), key.size())) { \
+      JSONCPP_BIND_FOR_EACH(JSONCPP_BIND_MEMBER_CASE, __VA_ARGS__)          \
+      default:                                                              \
+        break;                                                              \
+    }                                                                       \
+    return ::jiayuancs::jsoncpp::binding::Slot{nullptr, nullptr};           \
+  }                                                                         \
+  inline void JsoncppBindWrite(::jiayuancs::jsoncpp::binding::Output &output, \
+                               const Type &object) {                        \
+    JSONCPP_BIND_FOR_EACH(JSONCPP_BIND_WRITE_MEMBER, __VA_ARGS__)           \
+  }
+
+namespace jiayuancs {
+namespace jsoncpp {
+namespace binding {
+
+class Reader;
+
+// 一个待填充的值：reader描述其类型，target指向其存储
+// reader为nullptr表示忽略该值(如未绑定的key)
+struct Slot {
+  const Reader *reader;
+  void *target;
+};
+
+// 某个C++类型从事件中读取值的方式，每个类型只有一个无状态的实例
+// 默认实现抛出类型不匹配的std::logic_error
+class Reader {
+ public:
+  virtual ~Reader() {}
+
+  virtual void Null(void *target) const;
+  virtual void Bool(void *target, bool value) const;
+  virtual void Int(void *target, long long value) const;
+  virtual void Double(void *target, double value) const;
+  virtual void String(void *target, const std::string &value) const;
+
+  // 开始填充array或object，返回容器本身的Slot
+  virtual Slot StartArray(void *target) const;
+  virtual Slot StartObject(void *target) const;
+  // 容器中下一个元素或key对应成员的Slot
+  virtual Slot Element(void *target) const;
+  virtual Slot Member(void *target, const std::string &key) const;
+
+  // 错误信息中期望的JSON类型
+  virtual const char *Expected() const = 0;
+
+ protected:
+  [[noreturn]] void Mismatch(const char *actual) const;
+};
+
+// 按Parser产生的事件填充root，未出现的成员保持原值，未绑定的key被跳过
+class BindingHandler final : public Handler {
+ public:
+  explicit BindingHandler(Slot root) : root_(root) {}
+
+  void OnNull() override;
+  void OnBool(bool value) override;
+  void OnInt(long long value) override;
+  void OnDouble(double value) override;
+  void OnString(const std::string &value) override;
+
+  void OnStartArray() override;
+  void OnEndArray() override;
+
+  void OnStartObject() override;
+  void OnKey(const std::string &key) override;
+  void OnEndObject() override;
+
+ private:
+  struct Frame {
+    Slot container;  // 正在填充的array或object
+    Slot member;     // object中最近一个key对应的成员
+    bool is_object;
+  };
+
+  // 下一个值对应的Slot
+  Slot Next();
+  void StartContainer(bool is_object);
+  void EndContainer();
+
+  Slot root_;
+  std::vector<Frame> stack_;
+  std::size_t skip_depth_ = 0;  // 大于0时正在跳过未绑定的array或object
+};
+
+// 以紧凑格式输出JSON，格式与Json::dump()相同
+class Output final {
+ public:
+  explicit Output(std::string &output) : output_(output) {}
+
+  void Null();
+  void Bool(bool value);
+  void Int(long long value);
+  void Unsigned(unsigned long long value);
+  void Double(double value);
+  void String(const std::string &value);
+
+  void StartArray();
+  void EndArray();
+
+  void StartObject();
+  void Key(const char *key, std::size_t size);
+  void EndObject();
+
+ private:
+  // 在前一个元素之后写入分隔符
+  void Separate();
+
+  std::string &output_;
+  bool need_separator_ = false;
+};
+
+// 编译期可用的FNV-1a哈希，用于按key查找成员
+constexpr std::uint64_t HashKey(const char *data, std::size_t size) {
+  std::uint64_t hash = 0xcbf29ce484222325ULL;
+  for (std::size_t i = 0; i < size; ++i) {
+    hash = (hash ^ static_cast<unsigned char>(data[i])) * 0x100000001b3ULL;
+  }
+  return hash;
+}
+
+// 类型T的读取方式和序列化方式，未特化时T应为JSONCPP_BIND绑定的结构体
+template <typename T, typename Enable = void>
+class Codec final : public Reader {
+ public:
+  static const Codec &Instance() {
+    static const Codec codec;
+    return codec;
+  }
+
+  Slot StartObject(void *target) const override { return Slot{this, target}; }
+  Slot Member(void *target, const std::string &key) const override {
+    return JsoncppBindMember(*static_cast<T *>(target), key);
+  }
+
+  static void Write(Output &output, const T &value) {
+    output.StartObject();
+    JsoncppBindWrite(output, value);
+    output.EndObject();
+  }
+
+  const char *Expected() const override { return "object"; }
+};
+
+template <>
+class Codec<bool> final : public Reader {
+ public:
+  static const Codec &Instance() {
+    static const Codec codec;
+    return codec;
+  }
+
+  void Bool(void *target, bool value) const override {
+    *static_cast<bool *>(target) = value;
+  }
+
+  static void Write(Output &output, bool value) { output.Bool(value); }
+
+  const char *Expected() const override { return "bool"; }
+};
+
+// 整数超出T的范围时抛出std::logic_error。解析器把超出long long范围的整数
+// 读作double，因此unsigned long long成员只能读入不超过INT64_MAX的值，
+// 序列化时则按无符号整数输出完整的取值范围
+template <typename T>
+class Codec<T, typename std::enable_if<std::is_integral<T>::value &&
+                                       !std::is_same<T, bool>::value>::type>
+    final : public Reader {
+ public:
+  static const Codec &Instance() {
+    static const Codec codec;
+    return codec;
+  }
+
+  void Int(void *target, long long value) const override {
+    bool in_range =
+        std::is_signed<T>::value
+            ? value >= static_cast<long long>(std::numeric_limits<T>::min()) &&
+                  value <=
+                      static_cast<long long>(std::numeric_limits<T>::max())
+            : value >= 0 && static_cast<unsigned long long>(value) <=
+                                std::numeric_limits<T>::max();
+    if (!in_range) {
+      Mismatch("out of range integer");
+    }
+    *static_cast<T *>(target) = static_cast<T>(value);
+  }
+
+  static void Write(Output &output, T value) {
+    if (std::is_signed<T>::value) {
+      output.Int(static_cast<long long>(value));
+    } else {
+      output.Unsigned(static_cast<unsigned long long>(value));
+    }
+  }
+
+  const char *Expected() const override { return "integer"; }
+};
+
+// 整数也可以读入浮点数成员
+template <typename T>
+class Codec<T, typename std::enable_if<std::is_floating_point<T>::value>::type>
+    final : public Reader {
+ public:
+  static const Codec &Instance() {
+    static const Codec codec;
+    return codec;
+  }
+
+  void Int(void *target, long long value) const override {
+    *static_cast<T *>(target) = static_cast<T>(value);
+  }
+  void Double(void *target, double value) const override {
+    *static_cast<T *>(target) = static_cast<T>(value);
+  }
+
+  static void Write(Output &output, T value) {
+    output.Double(static_cast<double>(value));
+  }
+
+  const char *Expected() const override { return "number"; }
+};
+
+template <>
+class Codec<std::string> final : public Reader {
+ public:
+  static const Codec &Instance() {
+    static const Codec codec;
+    return codec;
+  }
+
+  void String(void *target, const std::string &value) const override {
+    static_cast<std::string *>(target)->assign(value);
+  }
+
+  static void Write(Output &output, const std::string &value) {
+    output.String(value);
+  }
+
+  const char *Expected() const override { return "string"; }
+};
+
+// 读取时先清空原有的元素
+template <typename T>
+class Codec<std::vector<T>> final : public Reader {
+ public:
+  static const Codec &Instance() {
+    static const Codec codec;
+    return codec;
+  }
+
+  Slot StartArray(void *target) const override {
+    static_cast<std::vector<T> *>(target)->clear();
+    return Slot{this, target};
+  }
+  Slot Element(void *target) const override {
+    std::vector<T> *vector = static_cast<std::vector<T> *>(target);
+    vector->emplace_back();
+    return Slot{&Codec<T>::Instance(), &vector->back()};
+  }
+
+  static void Write(Output &output, const std::vector<T> &value) {
+    output.StartArray();
+    for (const T &element : value) {
+      Codec<T>::Write(output, element);
+    }
+    output.EndArray();
+  }
+
+  const char *Expected() const override { return "array"; }
+};
+
+// 读取时先清空原有的成员，重复的key以最后一次出现的值为准
+template <typename T>
+class Codec<std::map<std::string, T>> final : public Reader {
+ public:
+  static const Codec &Instance() {
+    static const Codec codec;
+    return codec;
+  }
+
+  Slot StartObject(void *target) const override {
+    static_cast<std::map<std::string, T> *>(target)->clear();
+    return Slot{this, target};
+  }
+  Slot Member(void *target, const std::string &key) const override {
+    T &member = (*static_cast<std::map<std::string, T> *>(target))[key];
+    member = T();
+    return Slot{&Codec<T>::Instance(), &member};
+  }
+
+  static void Write(Output &output, const std::map<std::string, T> &value) {
+    output.StartObject();
+    for (const auto &member : value) {
+      output.Key(member.first.data(), member.first.size());
+      Codec<T>::Write(output, member.second);
+    }
+    output.EndObject();
+  }
+
+  const char *Expected() const override { return "object"; }
+};
+
+#if __cplusplus >= 201703L
+// null对应空值；作为结构体成员时，空值不输出
+template <typename T>
+class Codec<std::optional<T>> final : public Reader {
+ public:
+  static const Codec &Instance() {
+    static const Codec codec;
+    return codec;
+  }
+
+  void Null(void *target) const override {
+    static_cast<std::optional<T> *>(target)->reset();
+  }
+  void Bool(void *target, bool value) const override {
+    Inner().Bool(Emplace(target), value);
+  }
+  void Int(void *target, long long value) const override {
+    Inner().Int(Emplace(target), value);
+  }
+  void Double(void *target, double value) const override {
+    Inner().Double(Emplace(target), value);
+  }
+  void String(void *target, const std::string &value) const override {
+    Inner().String(Emplace(target), value);
+  }
+  Slot StartArray(void *target) const override {
+    return Inner().StartArray(Emplace(target));
+  }
+  Slot StartObject(void *target) const override {
+    return Inner().StartObject(Emplace(target));
+  }
+
+  static void Write(Output &output, const std::optional<T> &value) {
+    if (value) {
+      Codec<T>::Write(output, *value);
+    } else {
+      output.Null();
+    }
+  }
+
+  const char *Expected() const override { return Inner().Expected(); }
+
+ private:
+  static const Reader &Inner() { return Codec<T>::Instance(); }
+  static void *Emplace(void *target) {
+    return &static_cast<std::optional<T> *>(target)->emplace();
+  }
+};
+#endif  // __cplusplus >= 201703L
+
+// 以下供JSONCPP_BIND生成的代码使用
+template <typename T>
+Slot Field(T &member) {
+  return Slot{&Codec<T>::Instance(), &member};
+}
+
+template <typename T>
+void WriteMember(Output &output, const char *key, std::size_t size,
+                 const T &member) {
+  output.Key(key, size);
+  Codec<T>::Write(output, member);
+}
+
+#if __cplusplus >= 201703L
+template <typename T>
+void WriteMember(Output &output, const char *key, std::size_t size,
+                 const std::optional<T> &member) {
+  if (member) {
+    output.Key(key, size);
+    Codec<T>::Write(output, *member);
+  }
+}
+#endif  // __cplusplus >= 201703L
+
+// 解析一个值并填充object，类型不匹配或整数超出范围时抛出std::logic_error，
+// 此时object可能已被部分修改。输入有语法错误时抛出与Parser::Parse()相同的异常
+template <typename T>
+void Parse(Parser &parser, T &object) {
+  BindingHandler handler(Field(object));
+  parser.Parse(handler);
+}
+template <typename T>
+void Parse(const std::string &text, T &object) {
+  Parser parser(text);
+  Parse(parser, object);
+}
+
+// 序列化object，追加到output末尾
+template <typename T>
+void Dump(const T &object, std::string &output) {
+  Output writer(output);
+  Codec<T>::Write(writer, object);
+}
+template <typename T>
+std::string Dump(const T &object) {
+  std::string output;
+  Dump(object, output);
+  return output;
+}
+
+}  // namespace binding
+}  // namespace jsoncpp
+}  // namespace jiayuancs
+
+#define JSONCPP_BIND_MEMBER_CASE(member)                                     \
+  case ::jiayuancs::jsoncpp::binding::HashKey(#member, sizeof(#member) - 1): \
+    if (key.size() == sizeof(#member) - 1 && key.compare(#member) == 0) {    \
+      return ::jiayuancs::jsoncpp::binding::Field(object.member);            \
+    }                                                                        \
+    break;
+
+#define JSONCPP_BIND_WRITE_MEMBER(member)                            \
+  ::jiayuancs::jsoncpp::binding::WriteMember(output, #member,        \
+                                             sizeof(#member) - 1, \
+                                             object.member);
+
+// 对每个参数调用F，最多16个参数
+#define JSONCPP_BIND_EXPAND(x) x
+#define JSONCPP_BIND_CONCAT(a, b) JSONCPP_BIND_CONCAT_IMPL(a, b)
+#define JSONCPP_BIND_CONCAT_IMPL(a, b) a##b
+#define JSONCPP_BIND_COUNT(...)                                             \
+  JSONCPP_BIND_EXPAND(JSONCPP_BIND_COUNT_IMPL(                              \
+      __VA_ARGS__, 16, 15, 14, 13, 12, 11, 10, 9, 8, 7, 6, 5, 4, 3, 2, 1))
+#define JSONCPP_BIND_COUNT_IMPL(_1, _2, _3, _4, _5, _6, _7, _8, _9, _10,  \
+                                _11, _12, _13, _14, _15, _16, N, ...)     \
+  N
+#define JSONCPP_BIND_FOR_EACH(F, ...)                                     \
+  JSONCPP_BIND_EXPAND(JSONCPP_BIND_CONCAT(JSONCPP_BIND_FOR_EACH_,         \
+                                          JSONCPP_BIND_COUNT(__VA_ARGS__))( \
+      F, __VA_ARGS__))
+#define JSONCPP_BIND_FOR_EACH_1(F, x) F(x)
+#define JSONCPP_BIND_FOR_EACH_2(F, x, ...) \
+  F(x) JSONCPP_BIND_EXPAND(JSONCPP_BIND_FOR_EACH_1(F, __VA_ARGS__))
+#define JSONCPP_BIND_FOR_EACH_3(F, x, ...) \
+  F(x) JSONCPP_BIND_EXPAND(JSONCPP_BIND_FOR_EACH_2(F, __VA_ARGS__))
+#define JSONCPP_BIND_FOR_EACH_4(F, x, ...) \
+  F(x) JSONCPP_BIND_EXPAND(JSONCPP_BIND_FOR_EACH_3(F, __VA_ARGS__))
+#define JSONCPP_BIND_FOR_EACH_5(F, x, ...) \
+  F(x) JSONCPP_BIND_EXPAND(JSONCPP_BIND_FOR_EACH_4(F, __VA_ARGS__))
+#define JSONCPP_BIND_FOR_EACH_6(F, x, ...) \
+  F(x) JSONCPP_BIND_EXPAND(JSONCPP_BIND_FOR_EACH_5(F, __VA_ARGS__))
+#define JSONCPP_BIND_FOR_EACH_7(F, x, ...) \
+  F(x) JSONCPP_BIND_EXPAND(JSONCPP_BIND_FOR_EACH_6(F, __VA_ARGS__))
+#define JSONCPP_BIND_FOR_EACH_8(F, x, ...) \
+  F(x) JSONCPP_BIND_EXPAND(JSONCPP_BIND_FOR_EACH_7(F, __VA_ARGS__))
+#define JSONCPP_BIND_FOR_EACH_9(F, x, ...) \
+  F(x) JSONCPP_BIND_EXPAND(JSONCPP_BIND_FOR_EACH_8(F, __VA_ARGS__))
+#define JSONCPP_BIND_FOR_EACH_10(F, x, ...) \
+  F(x) JSONCPP_BIND_EXPAND(JSONCPP_BIND_FOR_EACH_9(F, __VA_ARGS__))
+#define JSONCPP_BIND_FOR_EACH_11(F, x, ...) \
+  F(x) JSONCPP_BIND_EXPAND(JSONCPP_BIND_FOR_EACH_10(F, __VA_ARGS__))
+#define JSONCPP_BIND_FOR_EACH_12(F, x, ...) \
+  F(x) JSONCPP_BIND_EXPAND(JSONCPP_BIND_FOR_EACH_11(F, __VA_ARGS__))
+#define JSONCPP_BIND_FOR_EACH_13(F, x, ...) \
+  F(x) JSONCPP_BIND_EXPAND(JSONCPP_BIND_FOR_EACH_12(F, __VA_ARGS__))
+#define JSONCPP_BIND_FOR_EACH_14(F, x, ...) \
+  F(x) JSONCPP_BIND_EXPAND(JSONCPP_BIND_FOR_EACH_13(F, __VA_ARGS__))
+#define JSONCPP_BIND_FOR_EACH_15(F, x, ...) \
+  F(x) JSONCPP_BIND_EXPAND(JSONCPP_BIND_FOR_EACH_14(F, __VA_ARGS__))
+#define JSONCPP_BIND_FOR_EACH_16(F, x, ...) \
+  F(x) JSONCPP_BIND_EXPAND(JSONCPP_BIND_FOR_EACH_15(F, __VA_ARGS__))
+
+#endif  // JSONCPP_INCLUDE_BINDING_H_
@@ -0,0 +1,38 @@
+// Json与CBOR(RFC 8949)之间的转换
+
+#ifndef JSONCPP_INCLUDE_CBOR_H_
+#define JSONCPP_INCLUDE_CBOR_H_
+
+#include <cstddef>
+#include <string>
+
+#include "handler.h"
+#include "json.h"
+
+namespace jiayuancs {
+namespace jsoncpp {
+namespace cbor {
+
+// 类型对应关系：null、bool对应简单值，kInt对应整数(主类型0和1)，
+// kDouble对应float64，string对应文本字符串，array和object对应定长的
+// 数组和映射。编码时整数使用最短的长度
+
+// 将json编码为CBOR，追加到output末尾
+void Encode(const Json &json, std::string &output);
+std::string Encode(const Json &json);
+
+// 解码data中的一个数据项，之后不能有多余的字节
+// 额外支持不定长的字符串、数组和映射，float16和float32，
+// 超出long long范围的整数转为double，标签(tag)被忽略，undefined视为null
+// 格式错误、映射的key不是文本字符串、遇到字节串等无法表示的类型，
+// 或者数组、映射和标签的嵌套超过1000层时抛出std::logic_error
+Json Decode(const char *data, std::size_t length);
+Json Decode(const std::string &data);
+// 同上，但按顺序产生Handler事件，不构建Json对象
+void Decode(const char *data, std::size_t length, Handler &handler);
+
+}  // namespace cbor
+}  // namespace jsoncpp
+}  // namespace jiayuancs
+
+#endif  // JSONCPP_INCLUDE_CBOR_H_
@@ -0,0 +1,40 @@
+// 事件驱动(SAX)解析接口
+
+#ifndef JSONCPP_INCLUDE_HANDLER_H_
+#define JSONCPP_INCLUDE_HANDLER_H_
+
+#include <string>
+
+namespace jiayuancs {
+namespace jsoncpp {
+
+// 解析器按输入顺序调用各回调函数，不构建Json对象
+// 所有回调默认什么也不做，派生类只需重写关心的事件
+// 字符串参数仅在回调期间有效，如需保留应自行复制
+// 回调中抛出的异常会终止解析并传播给Parser::Parse的调用者
+class Handler {
+ public:
+  virtual ~Handler() {}
+
+  virtual void OnNull() {}
+  virtual void OnBool(bool /* value */) {}
+  virtual void OnInt(long long /* value */) {}
+  virtual void OnDouble(double /* value */) {}
+  virtual void OnString(const std::string & /* value */) {}
+
+  virtual void OnStartArray() {}
+  virtual void OnEndArray() {}
+
+  // object中的每个成员依次产生OnKey事件和一个值的事件
+  virtual void OnStartObject() {}
+  virtual void OnKey(const std::string & /* key */) {}
+  // 启用Parser::UseKeyPool()时，已驻留的key产生该事件而不是OnKey，key在
+  // KeyPool析构或Clear()之前有效，可以保存其地址。默认转发给OnKey
+  virtual void OnInternedKey(const std::string &key) { OnKey(key); }
+  virtual void OnEndObject() {}
+};
+
+}  // namespace jsoncpp
+}  // namespace jiayuancs
+
+#endif  // JSONCPP_INCLUDE_HANDLER_H_
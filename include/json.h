@@ -3,12 +3,21 @@
 #ifndef JSONCPP_INCLUDE_JSON_H_
 #define JSONCPP_INCLUDE_JSON_H_
 
+#include <cstdint>
 #include <initializer_list>
 #include <map>
 #include <ostream>
 #include <string>
+#include <tuple>
+#include <utility>
 #include <vector>
 
+#include "arena.h"
+#include "jsoncpp_config.h"
+#include "object_key.h"
+#include "object_map.h"
+#include "string_view.h"
+
 namespace jiayuancs {
 namespace jsoncpp {
 
@@ -19,14 +28,30 @@ bool operator!=(const Json &lhs, const Json &rhs);
 
 std::ostream &operator<<(std::ostream &os, const Json &rhs);
 
+class ArrayIndex;
+
 class Json final {
   friend bool operator==(const Json &lhs, const Json &rhs);
   friend bool operator!=(const Json &lhs, const Json &rhs);
   friend std::ostream &operator<<(std::ostream &os, const Json &rhs);
+  // 通过修改计数判断索引是否过期
+  friend class ArrayIndex;
 
  public:
-  typedef std::vector<Json> ArrayType;
-  typedef std::map<std::string, Json> ObjectType;
+  // 容器使用ArenaAllocator，默认仍分配在堆上，见Json(JsonType, Arena &)
+  typedef std::vector<Json, ArenaAllocator<Json>> ArrayType;
+  // object的key为ObjectKey(见object_key.h)，可隐式转换为std::string，
+  // 查找时可直接使用std::string或const char*
+#ifdef JSONCPP_FLAT_OBJECT
+  // 成员按插入顺序连续存放，序列化时保持插入顺序
+  typedef ObjectMap<Json, ArenaAllocator<std::pair<ObjectKey, Json>>>
+      ObjectType;
+#else
+  // 成员按key的字典序存放，序列化时按key排序
+  typedef std::map<ObjectKey, Json, ObjectKeyLess,
+                   ArenaAllocator<std::pair<const ObjectKey, Json>>>
+      ObjectType;
+#endif
   enum JsonType { kNull, kBool, kInt, kDouble, kString, kArray, kObject };
 
   // 构造函数
@@ -39,13 +64,28 @@ class Json final {
   Json(double value);
   Json(const char *value);
   Json(const std::string &value);
+  Json(StringView value);
   Json(const std::initializer_list<Json> &li);
   // 使用初始化列表构造object对象时会与array的构造函数冲突，故删除
   // Json(const std::initializer_list<std::pair<const std::string, Json>> &li);
+  Json(const ArrayType &value);
   Json(const ObjectType &value);
+  // 移动构造：接管参数的数据，不拷贝
+  Json(Json &&json) noexcept;  // json变为null类型
+  Json(std::string &&value);
+  Json(ArrayType &&value);
+  Json(ObjectType &&value);
+
+  // 在arena上分配string、array或object的存储空间，这些空间随arena一起释放，
+  // 析构时不再逐个释放；拷贝这样的对象会得到完全位于堆上的深拷贝
+  // 注意：向arena上的容器中添加的值应同样分配在arena上，
+  // 否则这些值持有的堆内存在arena释放时不会被回收
+  Json(JsonType json_type, Arena &arena);
+  Json(const std::string &value, Arena &arena);
 
   // 赋值运算符通常是返回该对象的引用
   Json &operator=(const Json &rhs);
+  Json &operator=(Json &&rhs) noexcept;
 
   // 析构函数
   ~Json();
@@ -61,45 +101,119 @@ class Json final {
   Json &operator[](const std::string &key);
 
   // 其他函数
-  // 序列化字符串，缩进为indent
+  // 序列化为JSON文本，字符串中的特殊字符按JSON规则转义
+  // indent为0时输出紧凑的单行格式，否则每个元素单独一行，每层缩进indent个空格
   std::string dump(unsigned indent = 0) const;
   void dump(std::ostream &os, unsigned indent = 0) const;
 
-  bool IsNull() { return type_ == kNull; }
-  bool IsBool() { return type_ == kBool; }
-  bool IsInteger() { return type_ == kInt; }
-  bool IsDouble() { return type_ == kDouble; }
-  bool IsString() { return type_ == kString; }
-  bool IsArray() { return type_ == kArray; }
-  bool IsObject() { return type_ == kObject; }
+  JsonType Type() const {
+    return tag() == kShortStringTag ? kString : static_cast<JsonType>(tag());
+  }
+  bool IsNull() const { return tag() == kNull; }
+  bool IsBool() const { return tag() == kBool; }
+  bool IsInteger() const { return tag() == kInt; }
+  bool IsDouble() const { return tag() == kDouble; }
+  bool IsString() const { return Type() == kString; }
+  bool IsArray() const { return tag() == kArray; }
+  bool IsObject() const { return tag() == kObject; }
 
   const bool GetBool() const;
   const long long GetInteger() const;
   const double GetDouble() const;
-  const std::string &GetString() const;
+  // 返回的视图在该对象被修改或析构之前有效，可隐式转换为std::string
+  StringView GetString() const;
+
+  // 取出数据(移动而不是拷贝)，之后该对象中的string、array或object为空
+  // 用法：std::string value = std::move(json).TakeString();
+  // 注意：取出的数据若位于arena上，仍随arena一起释放
+  std::string TakeString() &&;
+  ArrayType TakeArray() &&;
+  ObjectType TakeObject() &&;
 
   // Array操作
   ArrayType &GetArray();
   const ArrayType &GetConstArray() const;
+  // 在末尾添加元素，null类型自动转为array
+  void PushBack(const Json &value) { EmplaceBack(value); }
+  void PushBack(Json &&value) { EmplaceBack(std::move(value)); }
+  // 用args在末尾直接构造元素，返回新元素的引用
+  template <typename... Args>
+  Json &EmplaceBack(Args &&...args) {
+    ArrayType &array = MutableArray("function Json::EmplaceBack()");
+    array.emplace_back(std::forward<Args>(args)...);
+    return array.back();
+  }
 
   // Object操作
   ObjectType &GetObject();
   const ObjectType &GetConstObject() const;
+  // 用args直接构造key对应的值，key已存在时替换原有的值，null类型自动转为object
+  template <typename... Args>
+  Json &Emplace(ObjectKey key, Args &&...args) {
+    ObjectType &object = MutableObject("function Json::Emplace()");
+    auto iter = object.find(key);
+    if (iter != object.end()) {
+      iter->second = Json(std::forward<Args>(args)...);
+      return iter->second;
+    }
+    return object
+        .emplace(std::piecewise_construct,
+                 std::forward_as_tuple(std::move(key)),
+                 std::forward_as_tuple(std::forward<Args>(args)...))
+        .first->second;
+  }
 
  private:
+  // 返回用于修改的容器，null类型自动转换，其他类型抛出异常
+  ArrayType &MutableArray(const char *function_name);
+  ObjectType &MutableObject(const char *function_name);
+
   // 释放内存，类型置为kNull
   void clear();
   // 深拷贝
   void copy(const Json &json);
+  // 接管json的数据，json变为null类型
+  void move(Json &json) noexcept;
+  // 设置为字符串，短字符串内联存储，长字符串分配在堆上
+  void assign_string(const char *data, std::size_t size);
+
+  // 不超过该长度的字符串直接存放在Json对象内部，不分配堆内存
+  static const std::size_t kShortStringCapacity = 14;
+  // 内部类型标记：除JsonType的各取值外，kShortStringTag表示内联的短字符串
+  static const unsigned char kShortStringTag = kObject + 1;
+
+  // 各种表示方式的第一个字节都是类型标记，属于共同初始序列，
+  // 无论当前使用哪种表示，都可以通过value_.tag读取
+  struct ValueRep {
+    unsigned char tag;
+    bool arena_owned;  // string、array或object的存储空间是否位于arena上
+    // 修改计数，调用GetArray()、TakeArray()或对整个对象赋值时递增，
+    // 供ArrayIndex判断索引是否过期。位于原有的填充字节中，不增加Json的大小
+    std::uint32_t revision;
+    union {
+      bool bool_value;
+      long long int_value;
+      double double_value;
+      std::string *string_pointer;  // 长字符串
+      ArrayType *array_pointer;
+      ObjectType *object_pointer;
+    };
+  };
+  struct ShortStringRep {
+    unsigned char tag;
+    unsigned char size;
+    char data[kShortStringCapacity];
+  };
+
+  unsigned char tag() const { return value_.tag; }
+  // 短字符串占用了修改计数所在的字节，视为0
+  std::uint32_t revision() const {
+    return tag() == kShortStringTag ? 0 : value_.revision;
+  }
 
-  JsonType type_;
   union {
-    bool bool_value_;
-    long long int_value_;
-    double double_value_;
-    std::string *string_pointer_;
-    ArrayType *array_pointer_;
-    ObjectType *object_pointer_;
+    ValueRep value_;
+    ShortStringRep short_;
   };
 };
 
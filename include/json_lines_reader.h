@@ -0,0 +1,110 @@
+// JSON Lines(NDJSON)的多线程读取器
+
+#ifndef JSONCPP_INCLUDE_JSON_LINES_READER_H_
+#define JSONCPP_INCLUDE_JSON_LINES_READER_H_
+
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <istream>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "json.h"
+
+namespace jiayuancs {
+namespace jsoncpp {
+
+struct JsonLinesOptions {
+  // 解析线程数，0表示使用std::thread::hardware_concurrency()
+  unsigned threads = 0;
+  // 每个分块的大致字节数，分块总是在换行符之后结束，超长的行单独成块
+  std::size_t chunk_size = 1 << 20;
+  // 已读入但尚未被取走的分块数上限，0表示线程数的2倍
+  // 调用者取走文档的速度跟不上解析速度时，解析线程在此处阻塞
+  std::size_t max_pending_chunks = 0;
+};
+
+// 一行输入的解析结果
+struct JsonLinesRecord {
+  Json value;               // 解析得到的文档，出错时为null
+  std::size_t line_no = 0;  // 该文档在整个输入中的行号(从1开始)
+  std::string error;        // 错误信息，解析成功时为空
+
+  bool ok() const { return error.empty(); }
+};
+
+// 每行一个JSON文档，空行(只含空白字符)被跳过
+// 输入按行切分为分块，由多个线程并行解析，Next()按输入顺序返回每个文档。
+// 某一行的语法错误只影响该行，错误信息中的行号为该行在整个输入中的行号
+class JsonLinesReader final {
+ public:
+  // 不复制输入数据，调用者需保证data在读取器析构之前有效
+  JsonLinesReader(const char *data, std::size_t length,
+                  const JsonLinesOptions &options = JsonLinesOptions());
+  explicit JsonLinesReader(
+      const std::string &str,
+      const JsonLinesOptions &options = JsonLinesOptions())
+      : JsonLinesReader(str.data(), str.size(), options) {}
+  // 按分块从流中读取，内存占用只与分块大小和max_pending_chunks有关
+  // 读取器析构之前不得再访问is
+  explicit JsonLinesReader(
+      std::istream &is, const JsonLinesOptions &options = JsonLinesOptions());
+
+  JsonLinesReader(const JsonLinesReader &) = delete;
+  JsonLinesReader &operator=(const JsonLinesReader &) = delete;
+
+  // 尚未解析的分块被丢弃
+  ~JsonLinesReader();
+
+  // 按输入顺序取出下一个文档，所有文档都已取出时返回false
+  bool Next(JsonLinesRecord &record);
+
+ private:
+  struct Chunk {
+    std::string buffer;  // 从流中读取时持有分块数据
+    const char *begin = nullptr;
+    const char *end = nullptr;
+    std::size_t first_line_no = 0;  // 分块第一行的行号
+    std::vector<JsonLinesRecord> records;
+    bool done = false;  // 是否已解析完毕
+  };
+
+  void Start(const JsonLinesOptions &options);
+  void WorkerLoop();
+  // 从内存或流中切出下一个分块，输入结束时返回false
+  // 调用者需持有input_mutex_
+  bool SliceChunk(Chunk &chunk);
+  bool ReadChunk(Chunk &chunk);
+  static void ParseChunk(Chunk &chunk);
+
+  std::size_t chunk_size_ = 0;
+  std::size_t max_pending_chunks_ = 0;
+
+  // 以下成员由input_mutex_保护
+  std::mutex input_mutex_;
+  const char *next_ = nullptr;  // 内存输入中下一个分块的起始位置
+  const char *end_ = nullptr;
+  std::istream *is_ = nullptr;    // 为nullptr时从内存读取
+  std::string carry_;             // 流输入中上一个分块之后不完整的行
+  std::size_t next_line_no_ = 1;  // 下一个分块第一行的行号
+
+  // 以下成员由mutex_保护
+  std::mutex mutex_;
+  bool input_exhausted_ = false;
+  bool stop_ = false;
+  std::condition_variable space_cv_;  // pending_有空位或需要退出
+  std::condition_variable ready_cv_;  // 有分块解析完毕或输入结束
+  // 按输入顺序排列的分块，由Next()从头部取走
+  std::deque<std::unique_ptr<Chunk>> pending_;
+  std::size_t next_record_ = 0;  // pending_头部分块中下一个要返回的文档
+  std::vector<std::thread> workers_;
+};
+
+}  // namespace jsoncpp
+}  // namespace jiayuancs
+
+#endif  // JSONCPP_INCLUDE_JSON_LINES_READER_H_
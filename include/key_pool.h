@@ -0,0 +1,47 @@
+// object成员key的驻留(intern)表，可在多个解析器之间共享
+
+#ifndef JSONCPP_INCLUDE_KEY_POOL_H_
+#define JSONCPP_INCLUDE_KEY_POOL_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <unordered_set>
+
+namespace jiayuancs {
+namespace jsoncpp {
+
+// 内容相同的key只保存一份，驻留后的字符串不可修改，
+// 其地址在KeyPool析构或调用Clear()之前保持不变，因此可直接按地址比较
+// 典型用法是在解析大量结构相同的文档(如NDJSON)时，为所有Parser提供同一个KeyPool
+// 非线程安全，每个线程应使用各自的KeyPool
+class KeyPool final {
+ public:
+  // max_keys限制驻留的key的数量，防止key不重复的输入使其无限增长
+  explicit KeyPool(std::size_t max_keys = SIZE_MAX) : max_keys_(max_keys) {}
+
+  KeyPool(const KeyPool &) = delete;
+  KeyPool &operator=(const KeyPool &) = delete;
+
+  // 返回与key内容相同的驻留字符串，驻留表已满且key不在表中时返回nullptr
+  const std::string *Intern(const std::string &key);
+
+  // 查找已驻留的key，不存在时返回nullptr
+  const std::string *Find(const std::string &key) const;
+
+  // 已驻留的key的数量
+  std::size_t Size() const { return keys_.size(); }
+
+  // 清空驻留表，之前返回的所有指针以及引用驻留key的Json对象均失效
+  void Clear() { keys_.clear(); }
+
+ private:
+  // unordered_set的元素在rehash时不会移动，地址保持不变
+  std::unordered_set<std::string> keys_;
+  std::size_t max_keys_;
+};
+
+}  // namespace jsoncpp
+}  // namespace jiayuancs
+
+#endif  // JSONCPP_INCLUDE_KEY_POOL_H_
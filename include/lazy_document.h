@@ -0,0 +1,89 @@
+// 按需(延迟)解析的JSON文档
+
+#ifndef JSONCPP_INCLUDE_LAZY_DOCUMENT_H_
+#define JSONCPP_INCLUDE_LAZY_DOCUMENT_H_
+
+#include <cstddef>
+#include <string>
+
+#include "json.h"
+
+namespace jiayuancs {
+namespace jsoncpp {
+
+class LazyDocument;
+
+// 指向文档中某个值的轻量游标，不持有数据，不得比所属文档存活更久
+// 访问成员或元素时只向前扫描到目标位置，不需要的子树仅按括号和引号匹配跳过，
+// 不构建Json对象，也不校验被跳过的内容
+class LazyValue final {
+  friend class LazyDocument;
+
+ public:
+  // 根据值的第一个字符判断类型
+  Json::JsonType Type() const;
+  bool IsNull() const { return Type() == Json::kNull; }
+  bool IsBool() const { return Type() == Json::kBool; }
+  bool IsInteger() const { return Type() == Json::kInt; }
+  bool IsDouble() const { return Type() == Json::kDouble; }
+  bool IsString() const { return Type() == Json::kString; }
+  bool IsArray() const { return Type() == Json::kArray; }
+  bool IsObject() const { return Type() == Json::kObject; }
+
+  // 查找object成员，key存在时写入value并返回true
+  // 存在重复的key时返回最后一次出现的值，与Parser的结果一致
+  bool Find(const std::string &key, LazyValue &value) const;
+  // 类型不是object或者key不存在时抛出std::logic_error
+  LazyValue operator[](const char *key) const;
+  LazyValue operator[](const std::string &key) const;
+  // 类型不是array或者下标越界时抛出std::logic_error
+  LazyValue operator[](const int index) const;
+
+  // 解析标量，类型不匹配时抛出std::logic_error
+  bool GetBool() const;
+  long long GetInteger() const;
+  double GetDouble() const;
+  std::string GetString() const;
+
+  // 完整解析该值(包括整个子树)，得到普通的Json对象
+  Json ToJson() const;
+
+ private:
+  LazyValue(const char *begin, const char *cur, const char *end)
+      : begin_(begin), cur_(cur), end_(end) {}
+
+  void ThrowError(const char *pos, const char *info_str) const;
+
+  const char *begin_;  // 文档起始位置，用于计算出错的行号
+  const char *cur_;    // 该值的第一个字符
+  const char *end_;    // 文档结束位置
+};
+
+// 创建文档时不做任何解析，通过Root()或operator[]按需访问
+// 与Parser相同，除了基于右值string的构造函数外不复制输入数据
+class LazyDocument final {
+ public:
+  LazyDocument(const char *data, std::size_t length);
+  LazyDocument(const char *str);
+  LazyDocument(const std::string &str);
+  LazyDocument(std::string &&str);
+
+  // 文档可能指向自身的缓冲区，禁止拷贝
+  LazyDocument(const LazyDocument &) = delete;
+  LazyDocument &operator=(const LazyDocument &) = delete;
+
+  LazyValue Root() const;
+  LazyValue operator[](const char *key) const { return Root()[key]; }
+  LazyValue operator[](const std::string &key) const { return Root()[key]; }
+  LazyValue operator[](const int index) const { return Root()[index]; }
+
+ private:
+  std::string buffer_;  // 需要文档持有输入数据时使用
+  const char *begin_;
+  const char *end_;
+};
+
+}  // namespace jsoncpp
+}  // namespace jiayuancs
+
+#endif  // JSONCPP_INCLUDE_LAZY_DOCUMENT_H_
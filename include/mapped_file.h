@@ -0,0 +1,42 @@
+// 只读的内存映射文件
+
+#ifndef JSONCPP_INCLUDE_MAPPED_FILE_H_
+#define JSONCPP_INCLUDE_MAPPED_FILE_H_
+
+#include <cstddef>
+#include <string>
+
+namespace jiayuancs {
+namespace jsoncpp {
+
+// 将整个文件以只读方式映射到内存，析构时解除映射
+// 文件内容按需从页缓存读入，不需要先复制到用户缓冲区，
+// 可将Data()和Size()直接交给Parser、LazyDocument或JsonLinesReader
+// 不支持mmap的平台上退化为一次性读入内部缓冲区
+class MappedFile final {
+ public:
+  // 文件无法打开或映射时抛出std::runtime_error
+  explicit MappedFile(const std::string &path);
+  ~MappedFile();
+
+  MappedFile(const MappedFile &) = delete;
+  MappedFile &operator=(const MappedFile &) = delete;
+
+  // 空文件的Data()为nullptr
+  const char *Data() const { return data_; }
+  std::size_t Size() const { return size_; }
+
+  // 提示内核将按顺序访问，加大预读，并尽早回收已读过的页面
+  void AdviseSequential();
+
+ private:
+  const char *data_ = nullptr;
+  std::size_t size_ = 0;
+  bool mapped_ = false;  // data_是否指向映射区域
+  std::string buffer_;   // 不支持mmap时持有文件内容
+};
+
+}  // namespace jsoncpp
+}  // namespace jiayuancs
+
+#endif  // JSONCPP_INCLUDE_MAPPED_FILE_H_
@@ -0,0 +1,37 @@
+// Json与MessagePack之间的转换
+
+#ifndef JSONCPP_INCLUDE_MSGPACK_H_
+#define JSONCPP_INCLUDE_MSGPACK_H_
+
+#include <cstddef>
+#include <string>
+
+#include "handler.h"
+#include "json.h"
+
+namespace jiayuancs {
+namespace jsoncpp {
+namespace msgpack {
+
+// 类型对应关系：null对应nil，bool对应true/false，kInt对应整数族，
+// kDouble对应float64，string对应str族，array和object对应array族和map族。
+// 编码时整数、字符串和容器的长度都使用最短的格式
+
+// 将json编码为MessagePack，追加到output末尾
+void Encode(const Json &json, std::string &output);
+std::string Encode(const Json &json);
+
+// 解码data中的一个对象，之后不能有多余的字节
+// 额外支持float32，超出long long范围的uint64转为double
+// 格式错误、map的key不是str、遇到bin、ext等无法表示的类型，
+// 或者array和map的嵌套超过1000层时抛出std::logic_error
+Json Decode(const char *data, std::size_t length);
+Json Decode(const std::string &data);
+// 同上，但按顺序产生Handler事件，不构建Json对象
+void Decode(const char *data, std::size_t length, Handler &handler);
+
+}  // namespace msgpack
+}  // namespace jsoncpp
+}  // namespace jiayuancs
+
+#endif  // JSONCPP_INCLUDE_MSGPACK_H_
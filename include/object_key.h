@@ -0,0 +1,92 @@
+// object成员的key，Json::ObjectType以其作为key类型
+
+#ifndef JSONCPP_INCLUDE_OBJECT_KEY_H_
+#define JSONCPP_INCLUDE_OBJECT_KEY_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string>
+
+#include "string_view.h"
+
+namespace jiayuancs {
+namespace jsoncpp {
+
+// 只读的key，占16字节：不超过14字节的key直接存放在对象内部，更长的key
+// 在堆上分配一块恰好容纳其内容的内存，KeyPool驻留的key(见key_pool.h)
+// 只保存其地址，不复制内容
+// 可隐式转换为StringView和std::string，与字符串之间使用StringView的比较
+// 运算符。内容相同的两个驻留key地址相同，比较时直接按地址判断相等
+class ObjectKey final {
+ public:
+  ObjectKey() {
+    inline_.tag = kInline;
+    inline_.size = 0;
+  }
+  ObjectKey(const char *key) { Assign(key, std::strlen(key)); }
+  ObjectKey(const std::string &key) { Assign(key.data(), key.size()); }
+  ObjectKey(StringView key) { Assign(key.data(), key.size()); }
+
+  ObjectKey(const ObjectKey &other);
+  ObjectKey(ObjectKey &&other) noexcept;
+  ObjectKey &operator=(const ObjectKey &other);
+  ObjectKey &operator=(ObjectKey &&other) noexcept;
+  ~ObjectKey() { Release(); }
+
+  // 引用interned的内容而不复制，interned须比返回的key及其所有拷贝存活更久
+  static ObjectKey FromInterned(const std::string &interned);
+
+  const char *data() const {
+    return tag() == kInline ? inline_.data : pointer_.data;
+  }
+  std::size_t size() const {
+    return tag() == kInline ? inline_.size : pointer_.size;
+  }
+  bool empty() const { return size() == 0; }
+  // 是否引用KeyPool中的驻留字符串
+  bool IsInterned() const { return tag() == kInterned; }
+
+  std::string ToString() const { return std::string(data(), size()); }
+  operator StringView() const { return StringView(data(), size()); }
+  operator std::string() const { return ToString(); }
+
+ private:
+  enum Tag : unsigned char { kInline, kHeap, kInterned };
+
+  static const std::size_t kInlineCapacity = 14;
+
+  void Assign(const char *data, std::size_t size);
+  void Release();
+
+  unsigned char tag() const { return inline_.tag; }
+
+  // 两种表示方式的第一个字节都是类型标记，属于共同初始序列
+  struct InlineRep {
+    unsigned char tag;
+    unsigned char size;
+    char data[kInlineCapacity];
+  };
+  struct PointerRep {
+    unsigned char tag;
+    std::uint32_t size;
+    const char *data;  // kHeap时由该对象拥有
+  };
+
+  union {
+    InlineRep inline_;
+    PointerRep pointer_;
+  };
+};
+
+// 按字典序比较，可以直接用std::string或const char*查找而不构造ObjectKey
+struct ObjectKeyLess {
+  typedef void is_transparent;
+
+  bool operator()(StringView lhs, StringView rhs) const { return lhs < rhs; }
+};
+
+}  // namespace jsoncpp
+}  // namespace jiayuancs
+
+#endif  // JSONCPP_INCLUDE_OBJECT_KEY_H_
@@ -0,0 +1,283 @@
+// 按插入顺序存放成员的object容器，可替代std::map作为Json::ObjectType
+
+#ifndef JSONCPP_INCLUDE_OBJECT_MAP_H_
+#define JSONCPP_INCLUDE_OBJECT_MAP_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <initializer_list>
+#include <memory>
+#include <stdexcept>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+#include "object_key.h"
+#include "string_view.h"
+
+namespace jiayuancs {
+namespace jsoncpp {
+
+// 成员连续存放在一个vector中，遍历顺序即插入顺序
+// 成员较少时线性查找，超过kIndexThreshold后额外维护一个开放寻址的哈希索引
+// 接口与std::map的常用部分保持一致，但插入和删除会使迭代器及成员的引用失效
+// key为ObjectKey，查找时可直接使用std::string、const char*或StringView
+// 注意：不要通过迭代器修改成员的key，否则哈希索引会失效
+template <typename T,
+          typename Allocator = std::allocator<std::pair<ObjectKey, T>>>
+class ObjectMap {
+ public:
+  typedef ObjectKey key_type;
+  typedef T mapped_type;
+  typedef std::pair<ObjectKey, T> value_type;
+  typedef Allocator allocator_type;
+  typedef std::size_t size_type;
+
+ private:
+  typedef std::vector<value_type, Allocator> EntryList;
+  typedef typename std::allocator_traits<Allocator>::template rebind_alloc<
+      std::uint32_t>
+      IndexAllocator;
+  // 槽中存放成员下标加1，0表示空槽
+  typedef std::vector<std::uint32_t, IndexAllocator> IndexTable;
+
+ public:
+  typedef typename EntryList::iterator iterator;
+  typedef typename EntryList::const_iterator const_iterator;
+
+  // 成员数超过该值时建立哈希索引
+  static const size_type kIndexThreshold = 16;
+
+  ObjectMap() = default;
+  explicit ObjectMap(const Allocator &allocator)
+      : entries_(allocator), index_(IndexAllocator(allocator)) {}
+  // 与std::map相同，重复的key只保留第一次出现的值
+  ObjectMap(std::initializer_list<value_type> li,
+            const Allocator &allocator = Allocator())
+      : ObjectMap(allocator) {
+    for (const value_type &value : li) {
+      insert(value);
+    }
+  }
+
+  allocator_type get_allocator() const { return entries_.get_allocator(); }
+
+  iterator begin() { return entries_.begin(); }
+  iterator end() { return entries_.end(); }
+  const_iterator begin() const { return entries_.begin(); }
+  const_iterator end() const { return entries_.end(); }
+  const_iterator cbegin() const { return entries_.cbegin(); }
+  const_iterator cend() const { return entries_.cend(); }
+
+  bool empty() const { return entries_.empty(); }
+  size_type size() const { return entries_.size(); }
+  void reserve(size_type n) { entries_.reserve(n); }
+
+  void clear() {
+    entries_.clear();
+    index_.clear();
+  }
+
+  iterator find(StringView key) { return entries_.begin() + Position(key); }
+  const_iterator find(StringView key) const {
+    return entries_.begin() + Position(key);
+  }
+  size_type count(StringView key) const {
+    return Position(key) == entries_.size() ? 0 : 1;
+  }
+
+  T &at(StringView key) {
+    iterator iter = find(key);
+    if (iter == end()) {
+      throw std::out_of_range("function ObjectMap::at() key not found");
+    }
+    return iter->second;
+  }
+  const T &at(StringView key) const {
+    const_iterator iter = find(key);
+    if (iter == end()) {
+      throw std::out_of_range("function ObjectMap::at() key not found");
+    }
+    return iter->second;
+  }
+
+  T &operator[](const ObjectKey &key) {
+    size_type position = Position(key);
+    if (position != entries_.size()) {
+      return entries_[position].second;
+    }
+    return Append(std::piecewise_construct, std::forward_as_tuple(key),
+                  std::forward_as_tuple())
+        .second;
+  }
+  T &operator[](ObjectKey &&key) {
+    size_type position = Position(key);
+    if (position != entries_.size()) {
+      return entries_[position].second;
+    }
+    return Append(std::piecewise_construct,
+                  std::forward_as_tuple(std::move(key)),
+                  std::forward_as_tuple())
+        .second;
+  }
+
+  // 参数与std::map::emplace相同；key已存在时不插入，返回已有的成员
+  template <typename... Args>
+  std::pair<iterator, bool> emplace(Args &&...args) {
+    // 先在末尾构造新成员再检查key是否重复，避免拷贝key
+    entries_.emplace_back(std::forward<Args>(args)...);
+    size_type last = entries_.size() - 1;
+    size_type position = Position(entries_.back().first, last);
+    if (position != last) {
+      entries_.pop_back();
+      return std::make_pair(entries_.begin() + position, false);
+    }
+    OnAppend();
+    return std::make_pair(entries_.end() - 1, true);
+  }
+  std::pair<iterator, bool> insert(const value_type &value) {
+    return emplace(value);
+  }
+  std::pair<iterator, bool> insert(value_type &&value) {
+    return emplace(std::move(value));
+  }
+
+  // 删除成员，保持其余成员的相对顺序
+  iterator erase(const_iterator position) {
+    iterator result = entries_.erase(position);
+    RebuildIndex();
+    return result;
+  }
+  size_type erase(StringView key) {
+    const_iterator iter = find(key);
+    if (iter == cend()) {
+      return 0;
+    }
+    erase(iter);
+    return 1;
+  }
+
+ private:
+  template <typename... Args>
+  value_type &Append(Args &&...args) {
+    entries_.emplace_back(std::forward<Args>(args)...);
+    OnAppend();
+    return entries_.back();
+  }
+
+  // 在前limit个成员中查找key，返回其下标，未找到时返回limit
+  size_type Position(StringView key) const {
+    return Position(key, entries_.size());
+  }
+  size_type Position(StringView key, size_type limit) const {
+    if (index_.empty()) {
+      for (size_type i = 0; i < limit; ++i) {
+        if (entries_[i].first == key) {
+          return i;
+        }
+      }
+      return limit;
+    }
+
+    size_type mask = index_.size() - 1;
+    for (size_type slot = Hash(key) & mask; index_[slot] != 0;
+         slot = (slot + 1) & mask) {
+      size_type i = index_[slot] - 1;
+      if (i < limit && entries_[i].first == key) {
+        return i;
+      }
+    }
+    return limit;
+  }
+
+  // 新成员已位于末尾，按需建立或更新哈希索引
+  void OnAppend() {
+    if (index_.empty()) {
+      if (entries_.size() > kIndexThreshold) {
+        RebuildIndex();
+      }
+      return;
+    }
+    // 装载因子不超过1/2
+    if (entries_.size() * 2 > index_.size()) {
+      RebuildIndex();
+      return;
+    }
+    InsertIndex(entries_.size() - 1);
+  }
+
+  void RebuildIndex() {
+    index_.clear();
+    if (entries_.size() <= kIndexThreshold) {
+      return;
+    }
+    size_type capacity = 1;
+    while (capacity < entries_.size() * 4) {
+      capacity <<= 1;
+    }
+    index_.assign(capacity, 0);
+    for (size_type i = 0; i < entries_.size(); ++i) {
+      InsertIndex(i);
+    }
+  }
+
+  void InsertIndex(size_type position) {
+    size_type mask = index_.size() - 1;
+    size_type slot = Hash(entries_[position].first) & mask;
+    while (index_[slot] != 0) {
+      slot = (slot + 1) & mask;
+    }
+    index_[slot] = static_cast<std::uint32_t>(position + 1);
+  }
+
+  // FNV-1a
+  static size_type Hash(StringView key) {
+    std::uint64_t hash = 0xcbf29ce484222325ULL;
+    for (char ch : key) {
+      hash = (hash ^ static_cast<unsigned char>(ch)) * 0x100000001b3ULL;
+    }
+    return static_cast<size_type>(hash);
+  }
+
+  EntryList entries_;
+  IndexTable index_;  // 为空表示尚未建立索引
+};
+
+template <typename T, typename Allocator>
+const typename ObjectMap<T, Allocator>::size_type
+    ObjectMap<T, Allocator>::kIndexThreshold;
+
+// 与成员顺序无关：key集合相同且对应的值相等即相等
+template <typename T, typename Allocator>
+bool operator==(const ObjectMap<T, Allocator> &lhs,
+                const ObjectMap<T, Allocator> &rhs) {
+  if (lhs.size() != rhs.size()) {
+    return false;
+  }
+  // 成员顺序通常相同，先按顺序比较，遇到不同的key后再逐个查找
+  auto liter = lhs.begin();
+  auto riter = rhs.begin();
+  for (; liter != lhs.end() && liter->first == riter->first; ++liter, ++riter) {
+    if (!(liter->second == riter->second)) {
+      return false;
+    }
+  }
+  for (; liter != lhs.end(); ++liter) {
+    auto iter = rhs.find(liter->first);
+    if (iter == rhs.end() || !(iter->second == liter->second)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+template <typename T, typename Allocator>
+bool operator!=(const ObjectMap<T, Allocator> &lhs,
+                const ObjectMap<T, Allocator> &rhs) {
+  return !(lhs == rhs);
+}
+
+}  // namespace jsoncpp
+}  // namespace jiayuancs
+
+#endif  // JSONCPP_INCLUDE_OBJECT_MAP_H_
@@ -3,55 +3,239 @@
 #ifndef JSONCPP_INCLUDE_PARSER_H_
 #define JSONCPP_INCLUDE_PARSER_H_
 
-#include <sstream>
-#ifndef NDEBUG
-#include <iostream>
-#endif  // NDEBUG
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <istream>
+#include <string>
+#include <vector>
 
+#include "handler.h"
 #include "json.h"
+#include "jsoncpp_config.h"
+#include "key_pool.h"
+#include "projection.h"
+#include "stats.h"
+#include "tracer.h"
 
 namespace jiayuancs {
 namespace jsoncpp {
 
+// 解析器直接在一段连续的内存上逐字节扫描，不经过istream
+// 注意：除了基于istream和右值string的构造函数外，解析器都不会复制输入数据，
+// 调用者需保证输入缓冲区在解析期间有效
 class Parser final {
  public:
-  Parser(std::istream &is) : in_str_(&is), need_delete_(false), line_no_(1) {}
-  Parser(const std::string &is)
-      : in_str_(new std::istringstream(is)), need_delete_(true), line_no_(1) {}
-  ~Parser();
+  Parser(const char *data, std::size_t length)
+      : begin_(data), cur_(data), end_(data + length) {}
+  Parser(const char *str);
+  Parser(const std::string &str)
+      : begin_(str.data()), cur_(begin_), end_(begin_ + str.size()) {}
+  // 右值字符串由解析器接管，避免悬垂引用
+  Parser(std::string &&str);
+  // 一次性读入流中剩余的全部数据，然后在内部缓冲区上解析
+  Parser(std::istream &is);
 
+  // 以内存映射方式打开文件并解析一个值，字符串和数字直接从映射的页面中解码，
+  // 返回前解除映射。文件无法打开时抛出std::runtime_error
+  static Json ParseFile(const std::string &path);
+  // 同上，但所有string、array和object都分配在arena上
+  static Json ParseFile(const std::string &path, Arena &arena);
+
+  // 解析器可能指向自身的缓冲区，禁止拷贝
+  Parser(const Parser &) = delete;
+  Parser &operator=(const Parser &) = delete;
+
+  // 启用两阶段解析：先用SIMD指令为整个输入构建结构字符索引(见
+  // structural_index.h)，之后按索引逐个取出token，不再逐字节跳过空白字符；
+  // 字符串的结束位置也直接取自索引，不含转义字符的字符串整段复制。
+  // 适合字符串较长或空白较多的大段输入，由短数字组成的紧凑输入反而因构建
+  // 索引而变慢。输入超过4GB时不启用；按投影解析和并行解析时不使用索引
+  void UseStructuralIndex();
+
+  // 使用pool驻留object的key(见key_pool.h)，pool可在多个解析器之间共享，
+  // 且须在解析期间有效。启用后Handler::OnInternedKey收到的是驻留字符串，
+  // 相同的key在不同文档中具有相同的地址，可以按地址比较
+  // Parse()构建的object直接引用驻留的key而不复制，因此得到的Json对象及其
+  // 拷贝不得比pool存活更久，在此之前也不能调用pool的Clear()
+  // KeyPool不是线程安全的，ParseParallel()的工作线程不驻留key
+  void UseKeyPool(KeyPool &pool) { key_pool_ = &pool; }
+
+  // 设置输入第一行的行号(默认为1)，解析较大文本中的片段时，
+  // 错误信息中的行号可以直接对应原文
+  void SetFirstLineNo(std::size_t line_no) { first_line_no_ = line_no; }
+
+#ifdef JSONCPP_STATS
+  // 之后的每次解析都将统计信息累加到stats中(见stats.h)，nullptr表示停止统计
+  // stats须在解析期间有效。统计时ParseParallel()改为串行解析
+  void CollectStats(ParseStats *stats) { stats_ = stats; }
+#endif  // JSONCPP_STATS
+
+#ifdef JSONCPP_TRACE
+  // 之后读取的每个token都交给tracer(见tracer.h)，nullptr表示停止跟踪
+  // tracer须在解析期间有效。跟踪时ParseParallel()改为串行解析
+  void SetTracer(TokenTracer *tracer) { tracer_ = tracer; }
+#endif  // JSONCPP_TRACE
+
+  // 解析一个值并构建Json对象
   Json Parse();
+  // 同上，但所有string、array和object都分配在arena上(见arena.h)，
+  // 整棵树随arena的Reset()或析构一次性释放，释放之前不得再访问该对象
+  Json Parse(Arena &arena);
+  // 解析一个值，按输入顺序产生事件，不构建Json对象
+  // Parse()本身就是在该接口上构建Json对象的一个Handler
+  void Parse(Handler &handler);
+  // 只解析projection选中的部分(见projection.h)，其余的值只按括号和字符串边界
+  // 跳过，不解码字符串、不转换数字，也不校验其内容
+  Json Parse(const Projection &projection);
+  // 同上，只为选中的部分产生事件
+  void Parse(const Projection &projection, Handler &handler);
+  // 并行解析一个大文档：顶层为array或object时，先快速扫描出深度为1的
+  // 元素边界，将元素分组后在threads个线程(0表示全部CPU核心)上并行解析，
+  // 最后按顺序拼接。结果与Parse()相同；输入有错误时改用串行解析，
+  // 抛出与Parse()相同的异常。输入较小或顶层不是容器时直接串行解析。
+  // 并行解析时不使用key驻留和结构字符索引
+  Json ParseParallel(unsigned threads = 0);
+
+  // 跳过空白字符后是否已到达输入末尾，用于检查解析出的值之后是否还有多余的字符
+  bool AtEnd() {
+    SkipSpace();
+    return cur_ == end_;
+  }
 
  private:
-  void SkipSpace();
+  static bool IsSpace(char ch) {
+    return ch == ' ' || ch == '\t' || ch == '\n' || ch == '\r';
+  }
   // 内联函数应定义(而不是仅声明)在头文件中
+  void SkipSpace() {
+    if (cur_ == end_ || !IsSpace(*cur_)) {
+      return;
+    }
+    if (use_index_) {
+      // 字符串外的非空白字符都是结构位置，因此上一个token之后紧跟空白字符时，
+      // 到下一个结构位置之前都是空白字符
+      cur_ = begin_ + *next_structural_;
+      return;
+    }
+    do {
+      ++cur_;
+    } while (cur_ != end_ && IsSpace(*cur_));
+  }
+  // 移动到下一个结构位置并将其标记为已读取。紧跟在标量之后的多余字符
+  // (如truex中的x)不是结构位置，此时停在该字符上，交给调用者报错
+  void NextStructural() {
+    const char *next = begin_ + *next_structural_;
+    if (cur_ == next || (cur_ != end_ && IsSpace(*cur_))) {
+      cur_ = next;
+      // 不越过末尾的哨兵
+      if (next != end_) {
+        ++next_structural_;
+      }
+    }
+  }
   int GetNextToken() {
-    SkipSpace();
-#ifndef NDEBUG
-    int ch_debug = in_str_->peek();
-    if (ch_debug == EOF) {
-      std::clog << "EOF";
+    if (use_index_) {
+      NextStructural();
     } else {
-      std::clog << static_cast<char>(ch_debug);
+      SkipSpace();
+    }
+#ifdef JSONCPP_TRACE
+    if (tracer_ != nullptr) {
+      tracer_->OnToken(static_cast<std::size_t>(cur_ - begin_),
+                       cur_ == end_ ? EOF : static_cast<unsigned char>(*cur_));
+    }
+#endif  // JSONCPP_TRACE
+    if (cur_ == end_) {
+      return EOF;
+    }
+    return static_cast<unsigned char>(*cur_++);
+  }
+  // 退回刚读取的token
+  void UngetToken() {
+    --cur_;
+    if (use_index_ && next_structural_ != indexes_.data() &&
+        begin_ + next_structural_[-1] == cur_) {
+      --next_structural_;
     }
-    std::clog << std::endl;
-#endif  // NDEBUG
-    return in_str_->get();
   }
+  // cur_被直接移动后，跳过索引中位于cur_之前的结构位置
+  void SyncIndex();
+  // 根据当前位置计算行号，便于排错（仅在出错时计算）
+  std::size_t LineNo() const;
   void ThrowError(const char *info_str);
   void ThrowError(const char *info_str, const char value);
   void ThrowError(const char *info_str, const char *value);
 
-  Json ParseNull();
-  Json ParseBool(bool value);
-  Json ParseNumber(bool positive);
-  std::string ParseString();
-  Json ParseArray();
-  Json ParseObject();
+  // 各Parse()的公共入口，node为nullptr时解析整个值，否则按投影解析
+  // 启用统计时用StatsCollector包装handler
+  template <typename HandlerType>
+  void ParseRoot(HandlerType &handler, const Projection::Node *node);
+  template <typename HandlerType>
+  void ParseSelected(HandlerType &handler, const Projection::Node *node);
+  // 语法分析函数，HandlerType为Handler或其派生类
+  // 使用模板可以让内部的Json构建器直接调用回调函数，不经过虚函数
+  template <typename HandlerType>
+  void ParseValue(HandlerType &handler);
+  template <typename HandlerType>
+  void ParseNumber(bool positive, HandlerType &handler);
+  template <typename HandlerType>
+  void ParseArray(HandlerType &handler);
+  template <typename HandlerType>
+  void ParseObject(HandlerType &handler);
+  // 解析object的一个成员("key" : value)
+  template <typename HandlerType>
+  void ParseMember(HandlerType &handler);
+  // 解析逗号分隔的count个数组元素或object成员，输入中不含外层括号，
+  // 结果作为一个完整的array或object交给handler
+  template <typename HandlerType>
+  void ParseElementRange(HandlerType &handler, bool is_object,
+                         std::size_t count);
+  // 按投影的节点解析一个值，node未选中整个子树时只进入容器
+  template <typename HandlerType>
+  void ParseProjected(HandlerType &handler, const Projection::Node &node);
+  template <typename HandlerType>
+  void ParseProjectedArray(HandlerType &handler, const Projection::Node &node);
+  template <typename HandlerType>
+  void ParseProjectedObject(HandlerType &handler,
+                            const Projection::Node &node);
+  // node为nullptr或下一个值不会产生任何事件时返回false
+  bool Selects(const Projection::Node *node);
+  // 跳过一个未选中的值
+  void SkipUnselected();
+  void ParseNull();
+  void ParseBool(bool value);
+  // 解析字符串(起始引号已读取)，结果存入string_buffer_
+  // \u转义按UTF-8编码，支持UTF-16代理对。启用结构字符索引时，
+  // 索引中的下一个位置即为结束引号
+  void ParseString();
+  // 读取\u之后的4位十六进制数
+  unsigned ParseHex4();
+  // 把刚解析出的key(位于string_buffer_)交给handler，
+  // 启用key驻留且驻留成功时产生OnInternedKey事件
+  template <typename HandlerType>
+  void EmitKey(HandlerType &handler);
+
+  std::string buffer_;  // 需要解析器持有输入数据时使用
+  const char *begin_;   // 输入数据起始位置
+  const char *cur_;     // 当前扫描位置
+  const char *end_;     // 输入数据结束位置
+
+  std::string string_buffer_;  // 复用的字符串解码缓冲区
+
+  bool use_index_ = false;  // 是否启用结构字符索引
+  // 结构位置(相对begin_的偏移量)，末尾追加输入长度作为哨兵
+  std::vector<std::uint32_t> indexes_;
+  const std::uint32_t *next_structural_ = nullptr;  // 下一个未读取的结构位置
 
-  std::istream *in_str_;
-  bool need_delete_;
-  int line_no_;
+  KeyPool *key_pool_ = nullptr;  // 为nullptr时不驻留key
+  std::size_t first_line_no_ = 1;  // 输入第一行的行号
+#ifdef JSONCPP_STATS
+  ParseStats *stats_ = nullptr;  // 为nullptr时不统计
+#endif  // JSONCPP_STATS
+#ifdef JSONCPP_TRACE
+  TokenTracer *tracer_ = nullptr;  // 为nullptr时不跟踪
+#endif  // JSONCPP_TRACE
 };
 
 }  // namespace jsoncpp
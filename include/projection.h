@@ -0,0 +1,57 @@
+// 解析时的字段投影：只构建选中的部分
+
+#ifndef JSONCPP_INCLUDE_PROJECTION_H_
+#define JSONCPP_INCLUDE_PROJECTION_H_
+
+#include <initializer_list>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace jiayuancs {
+namespace jsoncpp {
+
+// 一组以JSON Pointer(RFC 6901)表示的路径，'*'匹配任意key或array下标，例如：
+//   Projection projection({"/user/id", "/items/*/price"});
+//   Json record = Parser(line).Parse(projection);
+// 结果保持原有的嵌套结构，但只含选中的值及通往它们的object和array：
+// object只保留匹配的成员，array只保留匹配的元素(下标因此可能改变)，
+// 路径经过的容器即使没有匹配的内容也会保留(为空)
+// 空串选中整个文档
+class Projection final {
+  friend class Parser;
+
+ public:
+  // 路径格式错误时抛出std::logic_error
+  Projection(std::initializer_list<std::string> paths);
+  explicit Projection(const std::vector<std::string> &paths);
+
+ private:
+  // 路径前缀树中的一个节点
+  struct Node {
+    // 选中以该节点为根的整个子树
+    bool all = false;
+    std::map<std::string, std::unique_ptr<Node>> children;
+    // '*'，同时已合并到children的每个节点中
+    std::unique_ptr<Node> wildcard;
+
+    // object成员key对应的子节点，不匹配时返回nullptr
+    const Node *Child(const std::string &key) const;
+    // array第index个元素对应的子节点，不匹配时返回nullptr
+    const Node *Element(std::size_t index) const;
+  };
+
+  void Add(const std::string &path);
+  // 将src的所有路径合并到dst
+  static void Merge(Node &dst, const Node &src);
+  // 将wildcard合并到各个具名的子节点，使查找时只需检查一个节点
+  static void Normalize(Node &node);
+
+  Node root_;
+};
+
+}  // namespace jsoncpp
+}  // namespace jiayuancs
+
+#endif  // JSONCPP_INCLUDE_PROJECTION_H_
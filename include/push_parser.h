@@ -0,0 +1,115 @@
+// 增量(推送式)JSON解析器
+
+#ifndef JSONCPP_INCLUDE_PUSH_PARSER_H_
+#define JSONCPP_INCLUDE_PUSH_PARSER_H_
+
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "handler.h"
+#include "json.h"
+
+namespace jiayuancs {
+namespace jsoncpp {
+
+// 输入按任意大小的分块依次交给Feed()，解析状态在分块之间保持，
+// 分块可以在字符串、数字、转义序列或字面量(true/false/null)的中间断开
+// 产生Handler事件时，除了尚未结束的容器栈和当前字符串(或数字)外
+// 不保存任何输入，内存占用只与嵌套深度和最长的字符串有关
+// 与Parser的区别：顶层数字必须由Finish()或其后的字符结束
+class PushParser final {
+ public:
+  enum Status {
+    kNeedMoreData,  // 值尚未结束，需要更多输入
+    kComplete,      // 已解析出一个完整的值
+    kError,         // 语法错误，见Error()
+  };
+
+  // 构建Json对象，完成后通过Value()取得
+  PushParser();
+  // 按输入顺序产生事件，不构建Json对象，handler须在解析期间有效
+  // 回调中抛出的异常会传播给Feed()的调用者，之后解析器只能Reset()
+  explicit PushParser(Handler &handler);
+
+  PushParser(const PushParser &) = delete;
+  PushParser &operator=(const PushParser &) = delete;
+
+  ~PushParser();
+
+  // 解析一个分块。值结束后不再读取后面的字符，Consumed()返回本次读取的字节数，
+  // 剩余的字节可以交给Reset()之后的下一个文档
+  // 状态为kComplete或kError后再调用Feed()不读取任何字符，直接返回当前状态
+  Status Feed(const char *data, std::size_t length);
+  Status Feed(const std::string &data) {
+    return Feed(data.data(), data.size());
+  }
+  // 输入已全部给出；值尚未结束时为错误
+  Status Finish();
+
+  // 最近一次Feed()读取的字节数
+  std::size_t Consumed() const { return consumed_; }
+  // 语法错误信息，格式与Parser相同：syntax error in line N: ...
+  const std::string &Error() const { return error_; }
+  // 解析得到的Json对象(仅适用于构建Json对象的解析器)，可移出
+  Json &Value() { return root_; }
+
+  // 清空状态，准备解析下一个文档
+  void Reset();
+
+ private:
+  enum State {
+    kValue,               // 期待一个值
+    kArrayFirst,          // '['之后，期待第一个元素或']'
+    kArrayNext,           // 数组元素之后，期待','或']'
+    kObjectFirst,         // '{'之后，期待第一个key或'}'
+    kObjectKey,           // object中的','之后，期待key
+    kObjectColon,         // key之后，期待':'
+    kObjectNext,          // object成员之后，期待','或'}'
+    kString,              // 字符串内部
+    kStringEscape,        // 字符串中的'\'之后
+    kStringHex,           // \u之后的4位十六进制数
+    kSurrogateBackslash,  // 高位代理之后，期待'\'
+    kSurrogateU,          // 高位代理之后，期待'u'
+    kNumber,              // 数字内部
+    kLiteral,             // true、false或null内部
+    kDone,                // 值已结束
+    kFailed,              // 出现语法错误
+  };
+
+  // 从cur指向的字符开始一个新的值
+  void StartValue(const char *&cur);
+  // 一个值结束，回到所在容器的状态
+  void EndValue();
+  void EndContainer();
+  void FinishString();
+  void FinishNumber();
+  void FinishHex();
+  void Fail(const char *info_str);
+  void Fail(const char *info_str, char value);
+  Status CurrentStatus() const;
+
+  Handler *handler_;
+  Json root_;                         // 构建Json对象时的结果
+  std::unique_ptr<Handler> builder_;  // 构建Json对象时使用的Handler
+
+  State state_ = kValue;
+  std::vector<char> stack_;  // 尚未结束的容器，'['或'{'
+  std::string token_;        // 当前字符串(已解码)或数字
+  bool string_is_key_ = false;
+  const char *literal_ = nullptr;  // 当前字面量
+  std::size_t literal_pos_ = 0;    // 已匹配的字符数
+  unsigned hex_value_ = 0;
+  int hex_digits_ = 0;
+  unsigned high_surrogate_ = 0;  // 等待低位代理时的高位代理，否则为0
+
+  std::size_t line_no_ = 1;  // 当前行号，用于错误信息
+  std::size_t consumed_ = 0;
+  std::string error_;
+};
+
+}  // namespace jsoncpp
+}  // namespace jiayuancs
+
+#endif  // JSONCPP_INCLUDE_PUSH_PARSER_H_
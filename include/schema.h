@@ -0,0 +1,109 @@
+// JSON Schema校验：将schema编译为校验程序，可校验已解析的Json对象，
+// 也可以在解析过程中逐个事件地校验
+
+#ifndef JSONCPP_INCLUDE_SCHEMA_H_
+#define JSONCPP_INCLUDE_SCHEMA_H_
+
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "handler.h"
+#include "json.h"
+#include "parser.h"
+
+namespace jiayuancs {
+namespace jsoncpp {
+
+// 支持draft 2020-12的以下关键字：type、enum、const、minimum、maximum、
+// exclusiveMinimum、exclusiveMaximum、minLength、maxLength、pattern、
+// minItems、maxItems、items、minProperties、maxProperties、required、
+// properties和additionalProperties，以及true/false形式的schema
+// title、description等注释性关键字被忽略，其他关键字(如$ref、oneOf)
+// 以及格式错误的schema在编译时抛出std::logic_error
+// pattern使用不回溯的匹配，耗时与字符串长度成正比，因此不支持反向引用和
+// 前后查找，使用这些语法的pattern同样在编译时抛出std::logic_error
+// 数字一律按数值比较：enum和const中(包括嵌套在array、object中的)1与1.0相等，
+// 整数与边界比较时不转换为double，不会因舍入损失精度
+// 编译后的程序不可修改，拷贝Schema只增加引用计数，可在多个线程中同时使用
+class Schema final {
+ public:
+  explicit Schema(const Json &schema);
+
+  // 校验json，不符合时返回false，error不为nullptr时写入第一处错误，如
+  // schema violation at "/items/0/price": number below minimum
+  bool Validate(const Json &json, std::string *error = nullptr) const;
+
+  // 解析一个值并构建Json对象，同时校验：遇到第一处不符合schema的值时
+  // 立即停止解析，抛出与Validate()的错误信息相同的std::logic_error
+  Json Parse(Parser &parser) const;
+
+ private:
+  friend class SchemaValidator;
+  struct Program;
+
+  std::shared_ptr<const Program> program_;
+};
+
+// 按schema校验产生的事件，通过校验的事件再转发给next(可为nullptr)
+// 可用于Parser::Parse(Handler &)和PushParser，只校验不构建Json对象时
+// 内存占用与嵌套深度成正比。遇到第一处不符合schema的值时抛出std::logic_error
+// 对array或object使用enum或const时，需要先构建该值再比较
+class SchemaValidator final : public Handler {
+ public:
+  explicit SchemaValidator(const Schema &schema, Handler *next = nullptr);
+  ~SchemaValidator() override;
+
+  void OnNull() override;
+  void OnBool(bool value) override;
+  void OnInt(long long value) override;
+  void OnDouble(double value) override;
+  void OnString(const std::string &value) override;
+
+  void OnStartArray() override;
+  void OnEndArray() override;
+
+  void OnStartObject() override;
+  void OnKey(const std::string &key) override;
+  void OnInternedKey(const std::string &key) override;
+  void OnEndObject() override;
+
+ private:
+  // 尚未结束的array或object
+  struct Frame {
+    int node;           // 对应的schema节点，-1表示不受约束
+    bool is_object;
+    std::size_t count;  // 已开始的元素或成员个数
+    std::size_t seen;   // 在seen_中记录required成员是否出现的起始位置
+    int member;         // 当前成员的schema节点
+    std::string key;    // 当前成员的key，用于错误信息
+  };
+
+  // 开始一个新的值，返回其schema节点
+  int Enter();
+  // 按当前object的schema检查成员key
+  void CheckKey(const std::string &key);
+  void Scalar(const Json &value);
+  void StartContainer(bool is_object);
+  void EndContainer(bool is_object);
+  // 当前位置的JSON Pointer
+  std::string Path() const;
+  [[noreturn]] void Fail(const std::string &reason) const;
+
+  std::shared_ptr<const Schema::Program> program_;
+  Handler *next_;
+  std::vector<Frame> stack_;
+  std::vector<char> seen_;
+
+  // 对array或object使用enum时，先在capture_中构建该值，结束后整体校验
+  Json capture_;
+  std::unique_ptr<Handler> capture_builder_;
+  std::size_t capture_depth_ = 0;
+  int capture_node_ = -1;
+};
+
+}  // namespace jsoncpp
+}  // namespace jiayuancs
+
+#endif  // JSONCPP_INCLUDE_SCHEMA_H_
@@ -0,0 +1,81 @@
+// 解析和内存分配的统计接口，仅在定义宏JSONCPP_STATS时可用，
+// 未定义时相关代码全部不参与编译，没有任何运行时开销
+
+#ifndef JSONCPP_INCLUDE_STATS_H_
+#define JSONCPP_INCLUDE_STATS_H_
+
+#include "jsoncpp_config.h"
+
+#ifdef JSONCPP_STATS
+
+#include <cstddef>
+
+namespace jiayuancs {
+namespace jsoncpp {
+
+// Parser::CollectStats()累加的统计信息，可用于对线上流量抽样
+struct ParseStats {
+  std::size_t parses = 0;           // 统计的解析次数
+  std::size_t bytes_consumed = 0;   // 成功解析的输入字节数
+  std::size_t node_counts[7] = {};  // 各类型的节点数，下标为Json::JsonType
+  std::size_t max_depth = 0;        // array和object的最大嵌套深度
+  std::size_t string_bytes = 0;     // 解码后的字符串(含key)的字节数
+  std::size_t escape_count = 0;     // 字符串中的转义序列个数
+  std::size_t allocation_count = 0;  // 解析期间在堆上分配内存的次数
+  std::size_t allocation_bytes = 0;  // 解析期间在堆上分配的字节数
+
+  void Reset() { *this = ParseStats(); }
+};
+
+// 观察jsoncpp在堆上分配和释放的内存：Json的string、array和object存储，
+// 容器经由ArenaAllocator申请的内存，以及Arena的内存块
+// 钩子按线程设置，因此分配可以归属到当前线程上的某次操作
+class AllocationHook {
+ public:
+  virtual ~AllocationHook() {}
+
+  virtual void OnAllocate(std::size_t bytes) = 0;
+  virtual void OnDeallocate(std::size_t /* bytes */) {}
+};
+
+// 设置当前线程的钩子，返回原来的钩子，nullptr表示不观察
+AllocationHook *SetAllocationHook(AllocationHook *hook);
+AllocationHook *GetAllocationHook();
+
+// 库内部在堆上分配或释放内存时调用
+inline void NotifyAllocate(std::size_t bytes) {
+  AllocationHook *hook = GetAllocationHook();
+  if (hook != nullptr) {
+    hook->OnAllocate(bytes);
+  }
+}
+inline void NotifyDeallocate(std::size_t bytes) {
+  AllocationHook *hook = GetAllocationHook();
+  if (hook != nullptr) {
+    hook->OnDeallocate(bytes);
+  }
+}
+
+// 在作用域内为当前线程设置钩子，离开时恢复原来的钩子
+class ScopedAllocationHook final {
+ public:
+  explicit ScopedAllocationHook(AllocationHook *hook)
+      : previous_(SetAllocationHook(hook)) {}
+  ~ScopedAllocationHook() { SetAllocationHook(previous_); }
+
+  ScopedAllocationHook(const ScopedAllocationHook &) = delete;
+  ScopedAllocationHook &operator=(const ScopedAllocationHook &) = delete;
+
+  // 设置之前的钩子
+  AllocationHook *Previous() const { return previous_; }
+
+ private:
+  AllocationHook *previous_;
+};
+
+}  // namespace jsoncpp
+}  // namespace jiayuancs
+
+#endif  // JSONCPP_STATS
+
+#endif  // JSONCPP_INCLUDE_STATS_H_
@@ -0,0 +1,74 @@
+// 只读字符串视图(C++14中没有std::string_view)
+
+#ifndef JSONCPP_INCLUDE_STRING_VIEW_H_
+#define JSONCPP_INCLUDE_STRING_VIEW_H_
+
+#include <cstddef>
+#include <cstring>
+#include <ostream>
+#include <string>
+#if __cplusplus >= 201703L
+#include <string_view>
+#endif
+
+namespace jiayuancs {
+namespace jsoncpp {
+
+// 指向一段不属于自己的字符，不负责其生命周期
+// 可隐式转换为std::string，便于与使用std::string的代码配合
+class StringView final {
+ public:
+  StringView() : data_(""), size_(0) {}
+  StringView(const char *data, std::size_t size) : data_(data), size_(size) {}
+  StringView(const char *str) : data_(str), size_(std::strlen(str)) {}
+  StringView(const std::string &str) : data_(str.data()), size_(str.size()) {}
+
+  const char *data() const { return data_; }
+  std::size_t size() const { return size_; }
+  bool empty() const { return size_ == 0; }
+  const char *begin() const { return data_; }
+  const char *end() const { return data_ + size_; }
+  char operator[](std::size_t index) const { return data_[index]; }
+
+  std::string ToString() const { return std::string(data_, size_); }
+  operator std::string() const { return ToString(); }
+#if __cplusplus >= 201703L
+  operator std::string_view() const { return std::string_view(data_, size_); }
+#endif
+
+  // 字典序比较，返回负数、0或正数
+  int Compare(StringView other) const {
+    std::size_t length = size_ < other.size_ ? size_ : other.size_;
+    int result = length == 0 ? 0 : std::memcmp(data_, other.data_, length);
+    if (result != 0) {
+      return result;
+    }
+    return size_ == other.size_ ? 0 : (size_ < other.size_ ? -1 : 1);
+  }
+
+ private:
+  const char *data_;
+  std::size_t size_;
+};
+
+// 指向同一段字符(如同一个驻留的key)时不比较内容
+inline bool operator==(StringView lhs, StringView rhs) {
+  return lhs.size() == rhs.size() &&
+         (lhs.data() == rhs.data() || lhs.size() == 0 ||
+          std::memcmp(lhs.data(), rhs.data(), lhs.size()) == 0);
+}
+
+inline bool operator!=(StringView lhs, StringView rhs) { return !(lhs == rhs); }
+
+inline bool operator<(StringView lhs, StringView rhs) {
+  return lhs.Compare(rhs) < 0;
+}
+
+inline std::ostream &operator<<(std::ostream &os, StringView rhs) {
+  return os.write(rhs.data(), rhs.size());
+}
+
+}  // namespace jsoncpp
+}  // namespace jiayuancs
+
+#endif  // JSONCPP_INCLUDE_STRING_VIEW_H_
@@ -0,0 +1,39 @@
+// 结构字符索引：两阶段解析中的第一阶段
+
+#ifndef JSONCPP_INCLUDE_STRUCTURAL_INDEX_H_
+#define JSONCPP_INCLUDE_STRUCTURAL_INDEX_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace jiayuancs {
+namespace jsoncpp {
+
+// 第一阶段按64字节分块扫描输入，为每个分块计算引号、反斜杠、空白字符和
+// 结构字符({}[]:,)的位掩码，据此排除字符串内部的字符，最终得到所有
+// "结构位置"的偏移量：
+//   - 字符串外的结构字符
+//   - 字符串的起始引号和结束引号
+//   - 字符串外每个标量(数字、true、false、null等)的第一个字符
+// 第二阶段的解析器(见Parser::UseStructuralIndex())按顺序逐个取出这些位置
+// 作为token，并由结束引号的位置直接得到字符串的长度
+enum SimdLevel { kScalar, kSse2, kAvx2 };
+
+// 运行时检测当前CPU支持的最高指令集
+SimdLevel DetectSimdLevel();
+
+// 使用指定指令集构建索引，结果按偏移量升序写入indexes（会先清空），
+// 其容量恰好比结果多一个元素
+// 输入长度不得超过UINT32_MAX
+void BuildStructuralIndex(const char *data, std::size_t length,
+                          std::vector<std::uint32_t> &indexes,
+                          SimdLevel level);
+// 使用DetectSimdLevel()选出的指令集构建索引
+void BuildStructuralIndex(const char *data, std::size_t length,
+                          std::vector<std::uint32_t> &indexes);
+
+}  // namespace jsoncpp
+}  // namespace jiayuancs
+
+#endif  // JSONCPP_INCLUDE_STRUCTURAL_INDEX_H_
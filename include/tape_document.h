@@ -0,0 +1,165 @@
+// 只读的扁平(tape)文档表示
+
+#ifndef JSONCPP_INCLUDE_TAPE_DOCUMENT_H_
+#define JSONCPP_INCLUDE_TAPE_DOCUMENT_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "json.h"
+#include "string_view.h"
+
+namespace jiayuancs {
+namespace jsoncpp {
+
+class MappedFile;
+class TapeDocument;
+
+// 指向tape中某个值的轻量游标，不持有数据，不得比所属文档存活更久
+// 访问object成员和array元素时按顺序跳过前面的兄弟节点(容器整体一步跳过)
+class JsonView final {
+  friend class TapeDocument;
+
+ public:
+  // 按顺序遍历array的元素或object的成员，例如：
+  //   for (const JsonView::Iterator &child : view) {
+  //     child.Key();  // 仅object
+  //     child.Value();
+  //   }
+  class Iterator final {
+    friend class JsonView;
+
+   public:
+    // object成员的key，遍历array时不得调用
+    StringView Key() const;
+    // array的元素或object成员的值
+    JsonView Value() const;
+
+    Iterator &operator++();
+    const Iterator &operator*() const { return *this; }
+    bool operator==(const Iterator &rhs) const { return index_ == rhs.index_; }
+    bool operator!=(const Iterator &rhs) const { return index_ != rhs.index_; }
+
+   private:
+    Iterator(const JsonView &container, std::size_t index);
+
+    const std::uint64_t *tape_;
+    const char *strings_;
+    bool is_object_;
+    std::size_t index_;  // 当前元素(或成员的key)在tape中的下标
+  };
+
+  Json::JsonType Type() const;
+  bool IsNull() const { return Type() == Json::kNull; }
+  bool IsBool() const { return Type() == Json::kBool; }
+  bool IsInteger() const { return Type() == Json::kInt; }
+  bool IsDouble() const { return Type() == Json::kDouble; }
+  bool IsString() const { return Type() == Json::kString; }
+  bool IsArray() const { return Type() == Json::kArray; }
+  bool IsObject() const { return Type() == Json::kObject; }
+
+  // 类型不匹配时抛出std::logic_error
+  bool GetBool() const;
+  long long GetInteger() const;
+  double GetDouble() const;
+  // 返回的字符串直接指向文档的字符串区，以'\0'结尾
+  StringView GetString() const;
+
+  // array的元素个数或object的成员个数(重复的key分别计数)，
+  // 其他类型抛出std::logic_error
+  std::size_t Size() const;
+
+  // 查找object成员，key存在时写入value并返回true
+  // 存在重复的key时返回最后一次出现的值，与Parser的结果一致
+  bool Find(StringView key, JsonView &value) const;
+  // 类型不是object或者key不存在时抛出std::logic_error
+  JsonView operator[](const char *key) const;
+  JsonView operator[](const std::string &key) const;
+  // 类型不是array或者下标越界时抛出std::logic_error
+  JsonView operator[](const int index) const;
+
+  // 类型不是array或object时抛出std::logic_error
+  Iterator begin() const;
+  Iterator end() const;
+
+  // 复制为普通的Json对象
+  Json ToJson() const;
+
+ private:
+  JsonView(const std::uint64_t *tape, const char *strings, std::size_t index)
+      : tape_(tape), strings_(strings), index_(index) {}
+
+  const std::uint64_t *tape_;
+  const char *strings_;
+  std::size_t index_;  // 该值在tape中的下标
+};
+
+// 整个文档存放在一段连续的64位字(tape)和一段字符串区中，不含任何指针，
+// 可以原样保存到文件，再通过内存映射直接加载，加载时不做任何解析
+//
+// tape中每个字的高8位为标记，低56位为附加信息：
+//   n、t、f        null、true、false
+//   l、d           整数、浮点数，下一个字为其二进制表示
+//   s              字符串，附加信息为字符串区中的偏移量，下一个字为长度
+//   [ {            容器开始，附加信息为对应结束字的下标，下一个字为元素(成员)个数
+//   ] }            容器结束，附加信息为对应开始字的下标
+// object的成员依次存放key(字符串)和值
+class TapeDocument final {
+ public:
+  // 解析JSON文本，语法错误时与Parser相同抛出std::logic_error
+  static TapeDocument Parse(const char *data, std::size_t length);
+  static TapeDocument Parse(const std::string &str) {
+    return Parse(str.data(), str.size());
+  }
+  // 从Json对象构建
+  static TapeDocument FromJson(const Json &json);
+
+  // 以内存映射方式加载Save()保存的文件，不复制数据
+  // 只校验文件头，文件内容须由Save()生成；
+  // 文件无法打开时抛出std::runtime_error，格式不正确时抛出std::logic_error
+  static TapeDocument Load(const std::string &path);
+  // 同上，但数据来自调用者的缓冲区(Serialize()的结果)，
+  // 地址8字节对齐时不复制数据，此时调用者需保证缓冲区在文档析构之前有效
+  static TapeDocument Load(const char *data, std::size_t length);
+
+  TapeDocument(TapeDocument &&) = default;
+  TapeDocument &operator=(TapeDocument &&) = default;
+  // 视图指向文档自身的存储，禁止拷贝
+  TapeDocument(const TapeDocument &) = delete;
+  TapeDocument &operator=(const TapeDocument &) = delete;
+
+  ~TapeDocument();
+
+  // 保存为可直接加载的二进制文件，字节序与本机相同
+  // 文件无法写入时抛出std::runtime_error
+  void Save(const std::string &path) const;
+  // 同上，但追加到output末尾，可再通过Load(const char *, std::size_t)加载
+  void Serialize(std::string &output) const;
+
+  JsonView Root() const { return JsonView(tape_, strings_, 0); }
+  JsonView operator[](const char *key) const { return Root()[key]; }
+  JsonView operator[](const std::string &key) const { return Root()[key]; }
+  JsonView operator[](const int index) const { return Root()[index]; }
+
+ private:
+  TapeDocument() = default;
+  // 指向自身存储
+  void Attach();
+
+  std::vector<std::uint64_t> tape_storage_;
+  std::vector<char> string_storage_;
+  std::shared_ptr<MappedFile> file_;  // 通过内存映射加载时持有映射
+
+  const std::uint64_t *tape_ = nullptr;
+  std::size_t tape_size_ = 0;
+  const char *strings_ = nullptr;
+  std::size_t strings_size_ = 0;
+};
+
+}  // namespace jsoncpp
+}  // namespace jiayuancs
+
+#endif  // JSONCPP_INCLUDE_TAPE_DOCUMENT_H_
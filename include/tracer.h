@@ -0,0 +1,69 @@
+// 解析器的token跟踪接口，仅在定义宏JSONCPP_TRACE时可用，
+// 未定义时相关代码全部不参与编译，没有任何运行时开销
+
+#ifndef JSONCPP_INCLUDE_TRACER_H_
+#define JSONCPP_INCLUDE_TRACER_H_
+
+#include "jsoncpp_config.h"
+
+#ifdef JSONCPP_TRACE
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+namespace jiayuancs {
+namespace jsoncpp {
+
+// 通过Parser::SetTracer()设置，解析器每读取一个token调用一次OnToken
+class TokenTracer {
+ public:
+  virtual ~TokenTracer() {}
+
+  // offset为token相对输入起始位置的偏移量，token为EOF时表示已到达输入末尾
+  // 解析器退回后再次读取的token会以相同的offset再通知一次
+  virtual void OnToken(std::size_t offset, int token) = 0;
+  // 解析器抛出语法错误之前调用，message与异常的错误信息相同
+  virtual void OnError(std::size_t /* offset */,
+                       const std::string & /* message */) {}
+};
+
+// 在环形缓冲区中保留最近的capacity个token，解析出错后可用Dump()
+// 查看出错之前的token序列，而不必在解析过程中输出任何内容
+// 同一位置连续读取的token只记录一次
+class RingBufferTracer final : public TokenTracer {
+ public:
+  struct Entry {
+    std::size_t offset;
+    int token;
+  };
+
+  explicit RingBufferTracer(std::size_t capacity = 64);
+
+  void OnToken(std::size_t offset, int token) override;
+  void OnError(std::size_t offset, const std::string &message) override;
+
+  // 按读取顺序返回保留的token
+  std::vector<Entry> Entries() const;
+  // 记录过的token总数，包括已被覆盖的
+  std::size_t TotalTokens() const { return total_; }
+  // 最近一次语法错误的信息，没有错误时为空
+  const std::string &Error() const { return error_; }
+
+  // 每行一个token，格式为"偏移量: token"，有错误时最后一行为错误信息
+  std::string Dump() const;
+  void Clear();
+
+ private:
+  std::vector<Entry> entries_;  // 环形缓冲区
+  std::size_t total_ = 0;
+  std::size_t error_offset_ = 0;
+  std::string error_;
+};
+
+}  // namespace jsoncpp
+}  // namespace jiayuancs
+
+#endif  // JSONCPP_TRACE
+
+#endif  // JSONCPP_INCLUDE_TRACER_H_
@@ -0,0 +1,98 @@
+#include "arena.h"
+
+#include <cstdint>
+
+namespace jiayuancs {
+namespace jsoncpp {
+
+namespace {
+
+char *AlignUp(char *pointer, std::size_t alignment) {
+  std::uintptr_t value = reinterpret_cast<std::uintptr_t>(pointer);
+  value = (value + alignment - 1) & ~(std::uintptr_t(alignment) - 1);
+  return reinterpret_cast<char *>(value);
+}
+
+}  // namespace
+
+const std::size_t Arena::kDefaultBlockSize;
+
+Arena::Arena(std::size_t block_size) : Arena(nullptr, 0, block_size) {}
+
+Arena::Arena(void *buffer, std::size_t size, std::size_t block_size)
+    : block_size_(block_size),
+      initial_buffer_(static_cast<char *>(buffer)),
+      initial_size_(size),
+      cur_(initial_buffer_),
+      end_(initial_buffer_ + size),
+      blocks_(nullptr),
+      cleanups_(nullptr),
+      bytes_used_(0),
+      bytes_reserved_(0) {}
+
+Arena::~Arena() { Reset(); }
+
+void *Arena::Allocate(std::size_t size, std::size_t alignment) {
+  char *result = AlignUp(cur_, alignment);
+  if (cur_ != nullptr && result <= end_ &&
+      size <= static_cast<std::size_t>(end_ - result)) {
+    cur_ = result + size;
+    bytes_used_ += size;
+    return result;
+  }
+  return AllocateSlow(size, alignment);
+}
+
+void *Arena::AllocateSlow(std::size_t size, std::size_t alignment) {
+  // 内存块头部存放链表指针，剩余部分用于分配
+  std::size_t needed = sizeof(Block) + size + alignment;
+  std::size_t block_size = needed > block_size_ ? needed : block_size_;
+  Block *block = static_cast<Block *>(::operator new(block_size));
+  block->next = blocks_;
+  blocks_ = block;
+#ifdef JSONCPP_STATS
+  block->size = block_size;
+  NotifyAllocate(block_size);
+#endif  // JSONCPP_STATS
+  bytes_reserved_ += block_size;
+
+  char *result = AlignUp(reinterpret_cast<char *>(block + 1), alignment);
+  cur_ = result + size;
+  end_ = reinterpret_cast<char *>(block) + block_size;
+  bytes_used_ += size;
+  return result;
+}
+
+void Arena::AddCleanup(void (*cleanup)(void *), void *object) {
+  Cleanup *node =
+      static_cast<Cleanup *>(Allocate(sizeof(Cleanup), alignof(Cleanup)));
+  node->cleanup = cleanup;
+  node->object = object;
+  node->next = cleanups_;
+  cleanups_ = node;
+}
+
+void Arena::Reset() {
+  // 清理函数链表的节点位于内存块中，须在释放内存块之前调用
+  for (Cleanup *node = cleanups_; node != nullptr; node = node->next) {
+    node->cleanup(node->object);
+  }
+  cleanups_ = nullptr;
+
+  while (blocks_ != nullptr) {
+    Block *next = blocks_->next;
+#ifdef JSONCPP_STATS
+    NotifyDeallocate(blocks_->size);
+#endif  // JSONCPP_STATS
+    ::operator delete(blocks_);
+    blocks_ = next;
+  }
+
+  cur_ = initial_buffer_;
+  end_ = initial_buffer_ + initial_size_;
+  bytes_used_ = 0;
+  bytes_reserved_ = 0;
+}
+
+}  // namespace jsoncpp
+}  // namespace jiayuancs
@@ -0,0 +1,241 @@
+#include "array_index.h"
+
+#include <cstring>
+#include <stdexcept>
+
+#include "json_pointer.h"
+
+namespace jiayuancs {
+namespace jsoncpp {
+
+namespace {
+
+const std::uint32_t kNoGroup = UINT32_MAX;
+
+std::size_t Mix(std::uint64_t value) {
+  // splitmix64的最后一步，使相邻的整数分散到不同的槽
+  value ^= value >> 30;
+  value *= 0xBF58476D1CE4E5B9ULL;
+  value ^= value >> 27;
+  value *= 0x94D049BB133111EBULL;
+  value ^= value >> 31;
+  return static_cast<std::size_t>(value);
+}
+
+// FNV-1a，直接作用于StringView，不需要构造std::string
+std::size_t HashBytes(const char *data, std::size_t size) {
+  std::uint64_t hash = 0xCBF29CE484222325ULL;
+  for (std::size_t i = 0; i < size; ++i) {
+    hash ^= static_cast<unsigned char>(data[i]);
+    hash *= 0x100000001B3ULL;
+  }
+  return Mix(hash);
+}
+
+// 只支持标量，相等的值(按operator==)哈希值相同
+std::size_t HashValue(const Json &value) {
+  switch (value.Type()) {
+    case Json::kNull:
+      return 0;
+    case Json::kBool:
+      return value.GetBool() ? 1 : 2;
+    case Json::kInt:
+      return Mix(static_cast<std::uint64_t>(value.GetInteger()));
+    case Json::kDouble: {
+      // 0.0与-0.0相等，哈希值也必须相同
+      double number = value.GetDouble() + 0.0;
+      std::uint64_t bits;
+      std::memcpy(&bits, &number, sizeof(bits));
+      return Mix(bits ^ 0x5555555555555555ULL);
+    }
+    case Json::kString: {
+      StringView str = value.GetString();
+      return HashBytes(str.data(), str.size());
+    }
+    default:
+      return 0;
+  }
+}
+
+bool IsScalar(const Json &value) {
+  return !value.IsArray() && !value.IsObject();
+}
+
+// JSON Pointer中的array下标：不含多余的前导0
+bool ParseArrayIndex(const std::string &token, std::size_t &index) {
+  if (token.empty() || token.size() > 18 ||
+      (token.size() > 1 && token[0] == '0')) {
+    return false;
+  }
+  index = 0;
+  for (char ch : token) {
+    if (ch < '0' || ch > '9') {
+      return false;
+    }
+    index = index * 10 + (ch - '0');
+  }
+  return true;
+}
+
+}  // namespace
+
+ArrayIndex::ArrayIndex(const Json &array, const std::string &path)
+    : array_(&array) {
+  if (!array.IsArray()) {
+    throw std::logic_error("ArrayIndex: type error, requires array");
+  }
+  if (!path.empty() && path[0] == '/') {
+    if (!ParseJsonPointer(path, path_)) {
+      throw std::logic_error("ArrayIndex: invalid JSON Pointer: " + path);
+    }
+  } else if (!path.empty()) {
+    path_.push_back(path);
+  }
+  Rebuild();
+}
+
+void ArrayIndex::Rebuild() {
+  if (!array_->IsArray()) {
+    throw std::logic_error(
+        "function ArrayIndex::Rebuild() type error, requires array");
+  }
+  const Json::ArrayType &array = array_->GetConstArray();
+  if (array.size() >= UINT32_MAX) {
+    throw std::logic_error("function ArrayIndex::Rebuild() too many elements");
+  }
+
+  data_ = array.data();
+  array_size_ = array.size();
+  revision_ = array_->revision();
+  size_ = 0;
+  groups_.clear();
+  next_.assign(array.size(), 0);
+
+  // 装载因子不超过1/2
+  std::size_t capacity = 16;
+  while (capacity < array.size() * 2) {
+    capacity <<= 1;
+  }
+  slots_.assign(capacity, 0);
+  std::size_t mask = capacity - 1;
+
+  for (std::size_t i = 0; i < array.size(); ++i) {
+    const Json *value = Resolve(array[i]);
+    if (value == nullptr || !IsScalar(*value)) {
+      continue;
+    }
+    ++size_;
+
+    std::uint32_t position = static_cast<std::uint32_t>(i);
+    std::size_t hash = HashValue(*value);
+    std::size_t slot = hash & mask;
+    for (; slots_[slot] != 0; slot = (slot + 1) & mask) {
+      Group &group = groups_[slots_[slot] - 1];
+      if (group.hash == hash && *Resolve(array[group.head]) == *value) {
+        next_[group.tail] = position + 1;
+        group.tail = position;
+        ++group.count;
+        break;
+      }
+    }
+    if (slots_[slot] == 0) {
+      groups_.push_back(Group{hash, position, position, 1});
+      slots_[slot] = static_cast<std::uint32_t>(groups_.size());
+    }
+  }
+}
+
+bool ArrayIndex::Stale() const {
+  if (!array_->IsArray()) {
+    return true;
+  }
+  const Json::ArrayType &array = array_->GetConstArray();
+  return array_->revision() != revision_ || array.data() != data_ ||
+         array.size() != array_size_;
+}
+
+bool ArrayIndex::Find(const Json &value, std::size_t &position) const {
+  CheckFresh("function ArrayIndex::Find()");
+  std::uint32_t group = FindGroup(value, HashValue(value));
+  if (group == kNoGroup) {
+    return false;
+  }
+  position = groups_[group].head;
+  return true;
+}
+
+std::vector<std::size_t> ArrayIndex::FindAll(const Json &value) const {
+  CheckFresh("function ArrayIndex::FindAll()");
+  std::vector<std::size_t> positions;
+  std::uint32_t group = FindGroup(value, HashValue(value));
+  if (group == kNoGroup) {
+    return positions;
+  }
+  positions.reserve(groups_[group].count);
+  for (std::uint32_t i = groups_[group].head + 1; i != 0; i = next_[i - 1]) {
+    positions.push_back(i - 1);
+  }
+  return positions;
+}
+
+std::size_t ArrayIndex::Count(const Json &value) const {
+  CheckFresh("function ArrayIndex::Count()");
+  std::uint32_t group = FindGroup(value, HashValue(value));
+  return group == kNoGroup ? 0 : groups_[group].count;
+}
+
+const Json *ArrayIndex::Resolve(const Json &element) const {
+  const Json *value = &element;
+  for (const std::string &token : path_) {
+    if (value->IsObject()) {
+      const Json::ObjectType &object = value->GetConstObject();
+      auto iter = object.find(token);
+      if (iter == object.end()) {
+        return nullptr;
+      }
+      value = &iter->second;
+    } else if (value->IsArray()) {
+      const Json::ArrayType &array = value->GetConstArray();
+      std::size_t index;
+      if (!ParseArrayIndex(token, index) || index >= array.size()) {
+        return nullptr;
+      }
+      value = &array[index];
+    } else {
+      return nullptr;
+    }
+  }
+  return value;
+}
+
+std::uint32_t ArrayIndex::FindGroup(const Json &value,
+                                    std::size_t hash) const {
+  if (!IsScalar(value)) {
+    return kNoGroup;
+  }
+  const Json::ArrayType &array = array_->GetConstArray();
+  std::size_t mask = slots_.size() - 1;
+  for (std::size_t slot = hash & mask; slots_[slot] != 0;
+       slot = (slot + 1) & mask) {
+    std::uint32_t group = slots_[slot] - 1;
+    if (groups_[group].hash != hash) {
+      continue;
+    }
+    // 原地修改过的元素可能不再有该字段
+    const Json *head = Resolve(array[groups_[group].head]);
+    if (head != nullptr && *head == value) {
+      return group;
+    }
+  }
+  return kNoGroup;
+}
+
+void ArrayIndex::CheckFresh(const char *function_name) const {
+  if (Stale()) {
+    throw std::logic_error(std::string(function_name) +
+                           " the array has been modified, call Rebuild()");
+  }
+}
+
+}  // namespace jsoncpp
+}  // namespace jiayuancs
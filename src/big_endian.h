@@ -0,0 +1,54 @@
+// 大端字节序的读写(库内部使用)
+
+#ifndef JSONCPP_SRC_BIG_ENDIAN_H_
+#define JSONCPP_SRC_BIG_ENDIAN_H_
+
+#include <cstdint>
+#include <cstring>
+#include <string>
+
+namespace jiayuancs {
+namespace jsoncpp {
+
+// 将value的低size个字节按大端顺序追加到output末尾
+inline void AppendBigEndian(std::uint64_t value, int size,
+                            std::string &output) {
+  char bytes[8];
+  for (int i = size - 1; i >= 0; --i) {
+    bytes[i] = static_cast<char>(value & 0xFF);
+    value >>= 8;
+  }
+  output.append(bytes, size);
+}
+
+// 按大端顺序读取size个字节
+inline std::uint64_t ReadBigEndian(const char *data, int size) {
+  std::uint64_t value = 0;
+  for (int i = 0; i < size; ++i) {
+    value = (value << 8) | static_cast<unsigned char>(data[i]);
+  }
+  return value;
+}
+
+inline std::uint64_t DoubleToBits(double value) {
+  std::uint64_t bits;
+  std::memcpy(&bits, &value, sizeof(bits));
+  return bits;
+}
+
+inline double BitsToDouble(std::uint64_t bits) {
+  double value;
+  std::memcpy(&value, &bits, sizeof(value));
+  return value;
+}
+
+inline float BitsToFloat(std::uint32_t bits) {
+  float value;
+  std::memcpy(&value, &bits, sizeof(value));
+  return value;
+}
+
+}  // namespace jsoncpp
+}  // namespace jiayuancs
+
+#endif  // JSONCPP_SRC_BIG_ENDIAN_H_
@@ -0,0 +1,223 @@
+#include "binding.h"
+
+#include <stdexcept>
+
+#include "number_writer.h"
+#include "writer.h"
+
+namespace jiayuancs {
+namespace jsoncpp {
+namespace binding {
+
+void Reader::Null(void * /* target */) const { Mismatch("null"); }
+
+void Reader::Bool(void * /* target */, bool /* value */) const {
+  Mismatch("bool");
+}
+
+void Reader::Int(void * /* target */, long long /* value */) const {
+  Mismatch("integer");
+}
+
+void Reader::Double(void * /* target */, double /* value */) const {
+  Mismatch("number");
+}
+
+void Reader::String(void * /* target */,
+                    const std::string & /* value */) const {
+  Mismatch("string");
+}
+
+Slot Reader::StartArray(void * /* target */) const { Mismatch("array"); }
+
+Slot Reader::StartObject(void * /* target */) const { Mismatch("object"); }
+
+Slot Reader::Element(void * /* target */) const { Mismatch("array"); }
+
+Slot Reader::Member(void * /* target */,
+                    const std::string & /* key */) const {
+  Mismatch("object");
+}
+
+void Reader::Mismatch(const char *actual) const {
+  throw std::logic_error(std::string("binding error: expected ") +
+                         Expected() + ", but got " + actual);
+}
+
+Slot BindingHandler::Next() {
+  if (stack_.empty()) {
+    return root_;
+  }
+  Frame &frame = stack_.back();
+  if (frame.is_object) {
+    return frame.member;
+  }
+  return frame.container.reader->Element(frame.container.target);
+}
+
+void BindingHandler::OnNull() {
+  if (skip_depth_ != 0) {
+    return;
+  }
+  Slot slot = Next();
+  if (slot.reader != nullptr) {
+    slot.reader->Null(slot.target);
+  }
+}
+
+void BindingHandler::OnBool(bool value) {
+  if (skip_depth_ != 0) {
+    return;
+  }
+  Slot slot = Next();
+  if (slot.reader != nullptr) {
+    slot.reader->Bool(slot.target, value);
+  }
+}
+
+void BindingHandler::OnInt(long long value) {
+  if (skip_depth_ != 0) {
+    return;
+  }
+  Slot slot = Next();
+  if (slot.reader != nullptr) {
+    slot.reader->Int(slot.target, value);
+  }
+}
+
+void BindingHandler::OnDouble(double value) {
+  if (skip_depth_ != 0) {
+    return;
+  }
+  Slot slot = Next();
+  if (slot.reader != nullptr) {
+    slot.reader->Double(slot.target, value);
+  }
+}
+
+void BindingHandler::OnString(const std::string &value) {
+  if (skip_depth_ != 0) {
+    return;
+  }
+  Slot slot = Next();
+  if (slot.reader != nullptr) {
+    slot.reader->String(slot.target, value);
+  }
+}
+
+void BindingHandler::OnStartArray() { StartContainer(false); }
+
+void BindingHandler::OnEndArray() { EndContainer(); }
+
+void BindingHandler::OnStartObject() { StartContainer(true); }
+
+void BindingHandler::OnKey(const std::string &key) {
+  if (skip_depth_ != 0) {
+    return;
+  }
+  Frame &frame = stack_.back();
+  frame.member = frame.container.reader->Member(frame.container.target, key);
+}
+
+void BindingHandler::OnEndObject() { EndContainer(); }
+
+void BindingHandler::StartContainer(bool is_object) {
+  if (skip_depth_ != 0) {
+    ++skip_depth_;
+    return;
+  }
+  Slot slot = Next();
+  if (slot.reader == nullptr) {
+    // 未绑定的key对应的array或object，跳过其中的所有事件
+    skip_depth_ = 1;
+    return;
+  }
+  Slot container = is_object ? slot.reader->StartObject(slot.target)
+                             : slot.reader->StartArray(slot.target);
+  stack_.push_back(Frame{container, Slot{nullptr, nullptr}, is_object});
+}
+
+void BindingHandler::EndContainer() {
+  if (skip_depth_ != 0) {
+    --skip_depth_;
+    return;
+  }
+  stack_.pop_back();
+}
+
+void Output::Null() {
+  Separate();
+  output_.append("null", 4);
+}
+
+void Output::Bool(bool value) {
+  Separate();
+  if (value) {
+    output_.append("true", 4);
+  } else {
+    output_.append("false", 5);
+  }
+}
+
+void Output::Int(long long value) {
+  Separate();
+  char buffer[number::kMaxNumberLength];
+  output_.append(buffer, number::WriteInteger(value, buffer));
+}
+
+void Output::Unsigned(unsigned long long value) {
+  Separate();
+  char buffer[number::kMaxNumberLength];
+  output_.append(buffer, number::WriteUnsigned(value, buffer));
+}
+
+void Output::Double(double value) {
+  Separate();
+  char buffer[number::kMaxNumberLength];
+  output_.append(buffer, number::WriteDouble(value, buffer));
+}
+
+void Output::String(const std::string &value) {
+  Separate();
+  Writer(output_, 0).WriteString(value);
+}
+
+void Output::StartArray() {
+  Separate();
+  output_.push_back('[');
+  need_separator_ = false;
+}
+
+void Output::EndArray() {
+  output_.push_back(']');
+  need_separator_ = true;
+}
+
+void Output::StartObject() {
+  Separate();
+  output_.push_back('{');
+  need_separator_ = false;
+}
+
+void Output::Key(const char *key, std::size_t size) {
+  Separate();
+  Writer(output_, 0).WriteString(StringView(key, size));
+  output_.append(" : ", 3);
+  need_separator_ = false;
+}
+
+void Output::EndObject() {
+  output_.push_back('}');
+  need_separator_ = true;
+}
+
+void Output::Separate() {
+  if (need_separator_) {
+    output_.append(", ", 2);
+  }
+  need_separator_ = true;
+}
+
+}  // namespace binding
+}  // namespace jsoncpp
+}  // namespace jiayuancs
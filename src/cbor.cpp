@@ -0,0 +1,370 @@
+#include "cbor.h"
+
+#include <climits>
+#include <cmath>
+#include <cstdint>
+#include <sstream>
+#include <stdexcept>
+
+#include "big_endian.h"
+#include "dom_builder.h"
+
+namespace jiayuancs {
+namespace jsoncpp {
+namespace cbor {
+
+namespace {
+
+// 主类型
+enum MajorType {
+  kUnsigned = 0,
+  kNegative = 1,
+  kBytes = 2,
+  kText = 3,
+  kArray = 4,
+  kMap = 5,
+  kTag = 6,
+  kSimple = 7,
+};
+
+// 附加信息为31表示不定长，主类型7中表示break
+const unsigned kIndefinite = 31;
+const char kBreak = '\xFF';
+
+// 数组、映射和标签的最大嵌套深度，防止恶意输入耗尽栈空间
+const int kMaxDepth = 1000;
+
+// 写入数据项的头部，参数使用最短的编码
+void WriteHead(MajorType major, std::uint64_t argument, std::string &output) {
+  char initial = static_cast<char>(major << 5);
+  if (argument < 24) {
+    output += static_cast<char>(initial | argument);
+  } else if (argument <= 0xFF) {
+    output += static_cast<char>(initial | 24);
+    AppendBigEndian(argument, 1, output);
+  } else if (argument <= 0xFFFF) {
+    output += static_cast<char>(initial | 25);
+    AppendBigEndian(argument, 2, output);
+  } else if (argument <= 0xFFFFFFFF) {
+    output += static_cast<char>(initial | 26);
+    AppendBigEndian(argument, 4, output);
+  } else {
+    output += static_cast<char>(initial | 27);
+    AppendBigEndian(argument, 8, output);
+  }
+}
+
+void WriteText(const char *data, std::size_t size, std::string &output) {
+  WriteHead(kText, size, output);
+  output.append(data, size);
+}
+
+void EncodeValue(const Json &json, std::string &output) {
+  switch (json.Type()) {
+    case Json::kNull:
+      output += '\xF6';
+      break;
+    case Json::kBool:
+      output += json.GetBool() ? '\xF5' : '\xF4';
+      break;
+    case Json::kInt: {
+      long long value = json.GetInteger();
+      if (value >= 0) {
+        WriteHead(kUnsigned, static_cast<std::uint64_t>(value), output);
+      } else {
+        // 负整数n编码为-1-n，不会溢出
+        WriteHead(kNegative, static_cast<std::uint64_t>(-1 - value), output);
+      }
+      break;
+    }
+    case Json::kDouble:
+      output += '\xFB';
+      AppendBigEndian(DoubleToBits(json.GetDouble()), 8, output);
+      break;
+    case Json::kString: {
+      StringView value = json.GetString();
+      WriteText(value.data(), value.size(), output);
+      break;
+    }
+    case Json::kArray: {
+      const Json::ArrayType &array = json.GetConstArray();
+      WriteHead(kArray, array.size(), output);
+      for (const Json &element : array) {
+        EncodeValue(element, output);
+      }
+      break;
+    }
+    case Json::kObject: {
+      const Json::ObjectType &object = json.GetConstObject();
+      WriteHead(kMap, object.size(), output);
+      for (const auto &member : object) {
+        WriteText(member.first.data(), member.first.size(), output);
+        EncodeValue(member.second, output);
+      }
+      break;
+    }
+    default:
+      break;
+  }
+}
+
+// IEEE 754半精度浮点数
+double HalfToDouble(unsigned half) {
+  int exponent = (half >> 10) & 0x1F;
+  unsigned mantissa = half & 0x3FF;
+  double value;
+  if (exponent == 0) {
+    value = std::ldexp(mantissa, -24);
+  } else if (exponent == 31) {
+    value = mantissa == 0 ? HUGE_VAL : std::nan("");
+  } else {
+    value = std::ldexp(mantissa + 1024, exponent - 25);
+  }
+  return (half & 0x8000) != 0 ? -value : value;
+}
+
+class Decoder final {
+ public:
+  Decoder(const char *data, std::size_t length, Handler &handler)
+      : begin_(data), cur_(data), end_(data + length), handler_(handler) {}
+
+  void Decode() {
+    DecodeItem();
+    if (cur_ != end_) {
+      ThrowError("unexpected bytes after the data item");
+    }
+  }
+
+ private:
+  void DecodeItem() {
+    Need(1);
+    unsigned char initial = static_cast<unsigned char>(*cur_++);
+    unsigned info = initial & 0x1F;
+    switch (initial >> 5) {
+      case kUnsigned: {
+        std::uint64_t value = ReadArgument(info);
+        if (value <= LLONG_MAX) {
+          handler_.OnInt(static_cast<long long>(value));
+        } else {
+          handler_.OnDouble(static_cast<double>(value));
+        }
+        return;
+      }
+      case kNegative: {
+        std::uint64_t value = ReadArgument(info);
+        if (value <= LLONG_MAX) {
+          handler_.OnInt(-1 - static_cast<long long>(value));
+        } else {
+          handler_.OnDouble(-1.0 - static_cast<double>(value));
+        }
+        return;
+      }
+      case kBytes:
+        ThrowError("byte strings are not supported");
+      case kText:
+        ReadText(info);
+        handler_.OnString(string_buffer_);
+        return;
+      case kArray:
+        Enter();
+        handler_.OnStartArray();
+        if (info == kIndefinite) {
+          while (!AtBreak()) {
+            DecodeItem();
+          }
+        } else {
+          for (std::uint64_t n = ReadLength(info); n != 0; --n) {
+            DecodeItem();
+          }
+        }
+        handler_.OnEndArray();
+        --depth_;
+        return;
+      case kMap:
+        Enter();
+        handler_.OnStartObject();
+        if (info == kIndefinite) {
+          while (!AtBreak()) {
+            DecodeMember();
+          }
+        } else {
+          for (std::uint64_t n = ReadLength(info); n != 0; --n) {
+            DecodeMember();
+          }
+        }
+        handler_.OnEndObject();
+        --depth_;
+        return;
+      case kTag:
+        // 忽略标签，只解码其内容
+        ReadArgument(info);
+        Enter();
+        DecodeItem();
+        --depth_;
+        return;
+      default:
+        DecodeSimple(info);
+        return;
+    }
+  }
+
+  // 进入一层嵌套
+  void Enter() {
+    if (++depth_ > kMaxDepth) {
+      ThrowError("nesting too deep");
+    }
+  }
+
+  void DecodeMember() {
+    Need(1);
+    unsigned char initial = static_cast<unsigned char>(*cur_++);
+    if ((initial >> 5) != kText) {
+      ThrowError("map keys must be text strings");
+    }
+    ReadText(initial & 0x1F);
+    handler_.OnKey(string_buffer_);
+    DecodeItem();
+  }
+
+  void DecodeSimple(unsigned info) {
+    switch (info) {
+      case 20:
+        handler_.OnBool(false);
+        return;
+      case 21:
+        handler_.OnBool(true);
+        return;
+      case 22:
+      case 23:  // undefined
+        handler_.OnNull();
+        return;
+      case 25:
+        Need(2);
+        handler_.OnDouble(HalfToDouble(ReadBigEndian(cur_, 2)));
+        cur_ += 2;
+        return;
+      case 26:
+        Need(4);
+        handler_.OnDouble(BitsToFloat(ReadBigEndian(cur_, 4)));
+        cur_ += 4;
+        return;
+      case 27:
+        Need(8);
+        handler_.OnDouble(BitsToDouble(ReadBigEndian(cur_, 8)));
+        cur_ += 8;
+        return;
+      case kIndefinite:
+        ThrowError("unexpected break");
+      default:
+        ThrowError("unsupported simple value");
+    }
+  }
+
+  std::uint64_t ReadArgument(unsigned info) {
+    if (info < 24) {
+      return info;
+    }
+    if (info > 27) {
+      ThrowError("invalid additional information");
+    }
+    int size = 1 << (info - 24);
+    Need(size);
+    std::uint64_t value = ReadBigEndian(cur_, size);
+    cur_ += size;
+    return value;
+  }
+
+  // 数组和映射的长度，每个数据项至少占1个字节，不会超过剩余的字节数
+  std::uint64_t ReadLength(unsigned info) {
+    std::uint64_t length = ReadArgument(info);
+    if (length > static_cast<std::uint64_t>(end_ - cur_)) {
+      ThrowError("unexpected end of input");
+    }
+    return length;
+  }
+
+  // 读取文本字符串(初始字节已读取)，结果存入string_buffer_
+  void ReadText(unsigned info) {
+    string_buffer_.clear();
+    if (info != kIndefinite) {
+      AppendText(info);
+      return;
+    }
+    // 不定长字符串由若干个定长的文本字符串组成
+    while (!AtBreak()) {
+      unsigned char initial = static_cast<unsigned char>(*cur_++);
+      if ((initial >> 5) != kText || (initial & 0x1F) == kIndefinite) {
+        ThrowError("invalid indefinite-length string");
+      }
+      AppendText(initial & 0x1F);
+    }
+  }
+
+  void AppendText(unsigned info) {
+    std::uint64_t length = ReadArgument(info);
+    Need(length);
+    string_buffer_.append(cur_, static_cast<std::size_t>(length));
+    cur_ += length;
+  }
+
+  // 下一个字节为break时读取它并返回true
+  bool AtBreak() {
+    Need(1);
+    if (*cur_ == kBreak) {
+      ++cur_;
+      return true;
+    }
+    return false;
+  }
+
+  void Need(std::uint64_t size) {
+    if (size > static_cast<std::uint64_t>(end_ - cur_)) {
+      ThrowError("unexpected end of input");
+    }
+  }
+
+  [[noreturn]] void ThrowError(const char *info_str) {
+    std::ostringstream error_info;
+    error_info << "invalid CBOR at byte " << (cur_ - begin_) << ": "
+               << info_str;
+    throw std::logic_error(error_info.str());
+  }
+
+  const char *begin_;
+  const char *cur_;
+  const char *end_;
+  Handler &handler_;
+  std::string string_buffer_;  // 复用的字符串缓冲区
+  int depth_ = 0;              // 当前的嵌套深度
+};
+
+}  // namespace
+
+void Encode(const Json &json, std::string &output) {
+  EncodeValue(json, output);
+}
+
+std::string Encode(const Json &json) {
+  std::string output;
+  EncodeValue(json, output);
+  return output;
+}
+
+Json Decode(const char *data, std::size_t length) {
+  Json root;
+  DomBuilder builder(root, nullptr);
+  Decode(data, length, builder);
+  return root;
+}
+
+Json Decode(const std::string &data) {
+  return Decode(data.data(), data.size());
+}
+
+void Decode(const char *data, std::size_t length, Handler &handler) {
+  Decoder(data, length, handler).Decode();
+}
+
+}  // namespace cbor
+}  // namespace jsoncpp
+}  // namespace jiayuancs
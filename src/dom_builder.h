@@ -0,0 +1,93 @@
+// 在事件接口上构建Json对象(库内部使用)
+
+#ifndef JSONCPP_SRC_DOM_BUILDER_H_
+#define JSONCPP_SRC_DOM_BUILDER_H_
+
+#include <string>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+#include "arena.h"
+#include "handler.h"
+#include "json.h"
+
+namespace jiayuancs {
+namespace jsoncpp {
+
+// Parser和PushParser共用的Json构建器
+// 容器先插入父节点再入栈，子节点直接在最终位置上构建，解析过程中不拷贝任何值
+class DomBuilder final : public Handler {
+ public:
+  // arena为nullptr时所有节点都分配在堆上
+  DomBuilder(Json &root, Arena *arena) : root_(root), arena_(arena) {}
+
+  void OnNull() override { Emplace(); }
+  void OnBool(bool value) override { Emplace(value); }
+  void OnInt(long long value) override { Emplace(value); }
+  void OnDouble(double value) override { Emplace(value); }
+  void OnString(const std::string &value) override { EmplaceStorage(value); }
+
+  void OnStartArray() override {
+    stack_.push_back(EmplaceStorage(Json::kArray));
+  }
+  void OnEndArray() override { stack_.pop_back(); }
+
+  void OnStartObject() override {
+    stack_.push_back(EmplaceStorage(Json::kObject));
+  }
+  void OnKey(const std::string &key) override { key_ = ObjectKey(key); }
+  // 驻留的key只保存其地址，构建的Json对象引用KeyPool中的字符串
+  void OnInternedKey(const std::string &key) override {
+    key_ = ObjectKey::FromInterned(key);
+  }
+  void OnEndObject() override { stack_.pop_back(); }
+
+ private:
+  // string、array和object需要额外的存储空间，启用arena时分配在arena上
+  template <typename T>
+  Json *EmplaceStorage(const T &value) {
+    if (arena_ != nullptr) {
+      return Emplace(value, *arena_);
+    }
+    return Emplace(value);
+  }
+
+  // 用args在当前容器中构造新元素，返回新元素的地址
+  // 父容器在子容器出栈前不会被修改，因此返回的地址在入栈期间一直有效
+  template <typename... Args>
+  Json *Emplace(Args &...args) {
+    if (stack_.empty()) {
+      root_ = Json(args...);
+      return &root_;
+    }
+
+    Json &parent = *stack_.back();
+    if (parent.IsArray()) {
+      Json::ArrayType &array = parent.GetArray();
+      array.emplace_back(args...);
+      return &array.back();
+    }
+
+    // 重复的key以最后一次出现的值为准
+    // key_在下一次OnKey之前不再使用，直接移入新节点
+    Json::ObjectType &object = parent.GetObject();
+    auto result = object.emplace(std::piecewise_construct,
+                                 std::forward_as_tuple(std::move(key_)),
+                                 std::forward_as_tuple(args...));
+    if (!result.second) {
+      result.first->second = Json(args...);
+    }
+    return &result.first->second;
+  }
+
+  Json &root_;
+  Arena *arena_;
+  std::vector<Json *> stack_;  // 尚未结束的容器
+  ObjectKey key_;              // 当前object成员的key
+};
+
+}  // namespace jsoncpp
+}  // namespace jiayuancs
+
+#endif  // JSONCPP_SRC_DOM_BUILDER_H_
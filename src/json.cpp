@@ -1,31 +1,88 @@
 #include "json.h"
 
-#include <sstream>
+#include <cstring>
+#include <new>
 #include <stdexcept>
+#include <tuple>
+#include <utility>
+
+#include "stats.h"
+#include "writer.h"
 
 namespace jiayuancs {
 namespace jsoncpp {
 
+// 短字符串优化的前提是Json对象足够紧凑
+static_assert(sizeof(Json) <= 16, "Json should fit in 16 bytes");
+
+namespace {
+
+#ifdef JSONCPP_STATS
+// 对象本身之外另行持有的堆内存，只有std::string需要计算
+template <typename T>
+std::size_t ExtraBytes(const T &) {
+  return 0;
+}
+std::size_t ExtraBytes(const std::string &value) {
+  static const std::size_t kInlineCapacity = std::string().capacity();
+  return value.capacity() > kInlineCapacity ? value.capacity() + 1 : 0;
+}
+#endif  // JSONCPP_STATS
+
+// 在堆上创建和销毁Json的string、array和object存储
+template <typename T, typename... Args>
+T *NewStorage(Args &&...args) {
+  T *storage = new T(std::forward<Args>(args)...);
+#ifdef JSONCPP_STATS
+  NotifyAllocate(sizeof(T) + ExtraBytes(*storage));
+#endif  // JSONCPP_STATS
+  return storage;
+}
+
+template <typename T>
+void DeleteStorage(T *storage) {
+#ifdef JSONCPP_STATS
+  NotifyDeallocate(sizeof(T) + ExtraBytes(*storage));
+#endif  // JSONCPP_STATS
+  delete storage;
+}
+
+// 返回key对应的值，key不存在时插入null。已有的key直接查找，不构造ObjectKey
+template <typename Key>
+Json &FindOrInsert(Json::ObjectType &object, const Key &key) {
+  auto iter = object.find(key);
+  if (iter != object.end()) {
+    return iter->second;
+  }
+  return object
+      .emplace(std::piecewise_construct, std::forward_as_tuple(key),
+               std::forward_as_tuple())
+      .first->second;
+}
+
+}  // namespace
+
 bool operator==(const Json &lhs, const Json &rhs) {
-  if (lhs.type_ != rhs.type_) return false;
+  if (lhs.Type() != rhs.Type()) return false;
 
-  switch (lhs.type_) {
+  switch (lhs.Type()) {
     case Json::kNull:
       return true;
     case Json::kBool:
-      return lhs.bool_value_ == rhs.bool_value_;
+      return lhs.value_.bool_value == rhs.value_.bool_value;
     case Json::kInt:
-      return lhs.int_value_ == rhs.int_value_;
+      return lhs.value_.int_value == rhs.value_.int_value;
     case Json::kDouble:
-      return lhs.double_value_ == rhs.double_value_;
+      return lhs.value_.double_value == rhs.value_.double_value;
     case Json::kString:
-      return *lhs.string_pointer_ == *rhs.string_pointer_;
+      return lhs.GetString() == rhs.GetString();
     case Json::kArray:
       // 逐元素对比
-      if (lhs.array_pointer_->size() == rhs.array_pointer_->size()) {
-        auto liter = lhs.array_pointer_->cbegin();
-        auto riter = rhs.array_pointer_->cbegin();
-        for (; liter != lhs.array_pointer_->cend(); ++liter, ++riter) {
+      if (lhs.value_.array_pointer->size() ==
+          rhs.value_.array_pointer->size()) {
+        auto liter = lhs.value_.array_pointer->cbegin();
+        auto riter = rhs.value_.array_pointer->cbegin();
+        for (; liter != lhs.value_.array_pointer->cend(); ++liter, ++riter) {
           if (*liter != *riter) {
             return false;
           }
@@ -34,18 +91,8 @@ bool operator==(const Json &lhs, const Json &rhs) {
       }
       return false;
     case Json::kObject:
-      // 逐元素比较
-      if (lhs.object_pointer_->size() == rhs.object_pointer_->size()) {
-        auto liter = lhs.object_pointer_->cbegin();
-        auto riter = rhs.object_pointer_->cbegin();
-        for (; liter != lhs.object_pointer_->cend(); ++liter, ++riter) {
-          if (*liter != *riter) {
-            return false;
-          }
-        }
-        return true;
-      }
-      return false;
+      // 逐成员比较，与成员的存放顺序无关
+      return *lhs.value_.object_pointer == *rhs.value_.object_pointer;
     default:
       break;
   }
@@ -59,63 +106,181 @@ std::ostream &operator<<(std::ostream &os, const Json &rhs) {
   return os;
 }
 
-Json::Json() : type_(kNull) {}
+Json::Json() {
+  value_.tag = kNull;
+  value_.arena_owned = false;
+  value_.revision = 0;
+}
 
-Json::Json(const Json &json) : type_(json.type_) { copy(json); }
+Json::Json(const Json &json) : Json() { copy(json); }
 
-Json::Json(JsonType json_type) : type_(json_type) {
+Json::Json(Json &&json) noexcept : Json() { move(json); }
+
+Json::Json(JsonType json_type) : Json() {
+  value_.tag = json_type;
   switch (json_type) {
     case kBool:
-      bool_value_ = false;
+      value_.bool_value = false;
       break;
     case kInt:
-      int_value_ = 0;
+      value_.int_value = 0;
       break;
     case kDouble:
-      double_value_ = 0.0;
+      value_.double_value = 0.0;
       break;
     case kString:
-      string_pointer_ = new std::string();
+      // 空字符串是内联的短字符串，不分配内存
+      assign_string("", 0);
       break;
     case kArray:
-      array_pointer_ = new ArrayType();
+      value_.array_pointer = NewStorage<ArrayType>();
       break;
     case kObject:
-      object_pointer_ = new ObjectType();
+      value_.object_pointer = NewStorage<ObjectType>();
       break;
     default:
       break;
   }
 }
 
-Json::Json(bool value) : type_(kBool), bool_value_(value) {}
+Json::Json(bool value) : Json() {
+  value_.tag = kBool;
+  value_.bool_value = value;
+}
 
-Json::Json(int value) : type_(kInt), int_value_(value) {}
+Json::Json(int value) : Json() {
+  value_.tag = kInt;
+  value_.int_value = value;
+}
 
-Json::Json(long long value) : type_(kInt), int_value_(value) {}
+Json::Json(long long value) : Json() {
+  value_.tag = kInt;
+  value_.int_value = value;
+}
 
-Json::Json(double value) : type_(kDouble), double_value_(value) {}
+Json::Json(double value) : Json() {
+  value_.tag = kDouble;
+  value_.double_value = value;
+}
 
-Json::Json(const char *value)
-    : type_(kString), string_pointer_(new std::string(value)) {}
+Json::Json(const char *value) : Json() {
+  assign_string(value, std::strlen(value));
+}
 
-Json::Json(const std::string &value)
-    : type_(kString), string_pointer_(new std::string(value)) {}
+Json::Json(const std::string &value) : Json() {
+  assign_string(value.data(), value.size());
+}
+
+Json::Json(StringView value) : Json() {
+  assign_string(value.data(), value.size());
+}
+
+Json::Json(const std::initializer_list<Json> &li) : Json() {
+  value_.array_pointer = NewStorage<ArrayType>(li);
+  value_.tag = kArray;
+}
 
-Json::Json(const std::initializer_list<Json> &li)
-    : type_(kArray), array_pointer_(new ArrayType(li)) {}
+Json::Json(const ArrayType &value) : Json() {
+  value_.array_pointer = NewStorage<ArrayType>(value);
+  value_.tag = kArray;
+}
 
-Json::Json(const ObjectType &value)
-    : type_(kObject), object_pointer_(new ObjectType(value)) {}
+Json::Json(const ObjectType &value) : Json() {
+  value_.object_pointer = NewStorage<ObjectType>(value);
+  value_.tag = kObject;
+}
+
+Json::Json(std::string &&value) : Json() {
+  if (value.size() <= kShortStringCapacity) {
+    assign_string(value.data(), value.size());
+  } else {
+    value_.string_pointer = NewStorage<std::string>(std::move(value));
+    value_.tag = kString;
+  }
+}
+
+Json::Json(ArrayType &&value) : Json() {
+  value_.array_pointer = NewStorage<ArrayType>(std::move(value));
+  value_.tag = kArray;
+}
+
+Json::Json(ObjectType &&value) : Json() {
+  value_.object_pointer = NewStorage<ObjectType>(std::move(value));
+  value_.tag = kObject;
+}
+
+Json::Json(JsonType json_type, Arena &arena) : Json() {
+  switch (json_type) {
+    case kArray:
+      value_.array_pointer =
+          new (arena.Allocate(sizeof(ArrayType), alignof(ArrayType)))
+              ArrayType(ArenaAllocator<Json>(&arena));
+      value_.tag = kArray;
+      value_.arena_owned = true;
+      break;
+    case kObject:
+      value_.object_pointer =
+          new (arena.Allocate(sizeof(ObjectType), alignof(ObjectType)))
+              ObjectType(ArenaAllocator<ObjectType::value_type>(&arena));
+      value_.tag = kObject;
+      value_.arena_owned = true;
+      // 成员的key可能持有堆内存，且在容器扩容时会被移动，
+      // 因此在arena释放时析构整个object，而不是逐个登记key
+      arena.AddDestructor(value_.object_pointer);
+      break;
+    default:
+      // 标量和空字符串不需要额外的存储空间
+      *this = Json(json_type);
+      break;
+  }
+}
+
+Json::Json(const std::string &value, Arena &arena) : Json() {
+  if (value.size() <= kShortStringCapacity) {
+    assign_string(value.data(), value.size());
+    return;
+  }
+
+  value_.string_pointer = new (
+      arena.Allocate(sizeof(std::string), alignof(std::string)))
+      std::string(value);
+  value_.tag = kString;
+  value_.arena_owned = true;
+  // 超出std::string短字符串优化长度的字符串还持有堆内存，需要在arena释放时析构
+  static const std::size_t kInlineCapacity = std::string().capacity();
+  if (value.size() > kInlineCapacity) {
+    arena.AddDestructor(value_.string_pointer);
+  }
+}
 
 Json &Json::operator=(const Json &rhs) {
   // 处理自我赋值
   if (this == &rhs) return *this;
 
-  // 释放当前对象的空间
+  // rhs可能属于当前对象(如j = j["a"])，须在释放当前对象的空间之前拷贝
+  // 赋值后的对象仍是同一个对象，修改计数在原来的基础上递增
+  std::uint32_t revision = this->revision();
+  Json tmp(rhs);
   clear();
+  move(tmp);
+  if (tag() != kShortStringTag) {
+    value_.revision = revision + 1;
+  }
 
-  copy(rhs);
+  return *this;
+}
+
+Json &Json::operator=(Json &&rhs) noexcept {
+  if (this == &rhs) return *this;
+
+  // 同上，先取出rhs的值再释放当前对象的空间
+  std::uint32_t revision = this->revision();
+  Json tmp(std::move(rhs));
+  clear();
+  move(tmp);
+  if (tag() != kShortStringTag) {
+    value_.revision = revision + 1;
+  }
 
   return *this;
 }
@@ -125,146 +290,127 @@ Json::~Json() { clear(); }
 Json &Json::operator[](const int index) {
   if (index < 0) {
     throw std::logic_error(
-        "function Josn::operator[](const int) requires index > 0");
+        "function Json::operator[](const int) requires index > 0");
   }
 
   // null类型可转为array
-  if (type_ == kNull) {
-    type_ = kArray;
-    array_pointer_ = new ArrayType();
-  }
+  ArrayType &array = MutableArray("function Json::operator[](const int)");
 
-  if (type_ != kArray) {
-    throw std::logic_error(
-        "function Josn::operator[](const int) type error, requires array or "
-        "null");
-  }
-
-  if (index < array_pointer_->size()) {
-    return (*array_pointer_)[index];
+  if (index < array.size()) {
+    return array[index];
   }
 
   // 数组扩容（针对vector）
-  array_pointer_->reserve(index + 1);
-  while (array_pointer_->size() <= index) {
-    array_pointer_->push_back(Json());
-  }
-  return (*array_pointer_)[index];
+  array.resize(index + 1);
+  return array[index];
 }
 
-Json &Json::operator[](const char *key) { return (*this)[std::string(key)]; }
+Json &Json::operator[](const char *key) {
+  return FindOrInsert(MutableObject("function Json::operator[](const char *)"),
+                      key);
+}
 
 Json &Json::operator[](const std::string &key) {
   // null类型可转为object
-  if (type_ == kNull) {
-    type_ = kObject;
-    object_pointer_ = new ObjectType();
-  }
-
-  if (type_ != kObject) {
-    throw std::logic_error(
-        "function Json::operator[](const string &) type error, requires "
-        "object or null");
-  }
-
-  return (*object_pointer_)[key];
+  return FindOrInsert(
+      MutableObject("function Json::operator[](const string &)"), key);
 }
 
 std::string Json::dump(unsigned indent) const {
-  std::ostringstream oss;
-  dump(oss, indent);
-  return oss.str();
+  std::string output;
+  Writer(output, indent).Write(*this);
+  return output;
 }
 
 void Json::dump(std::ostream &os, unsigned indent) const {
-  switch (type_) {
-    case kNull:
-      os << "null";
-      break;
-    case kBool:
-      os << std::boolalpha << bool_value_ << std::noboolalpha;
-      break;
-    case kInt:
-      os << int_value_;
-      break;
-    case kDouble:
-      os << double_value_;
-      break;
-    case kString:
-      os << R"(")" + (*string_pointer_) + R"(")";  // 不转义字符串中的特殊字符
-      break;
-    case kArray:
-      os << "[";
-      for (auto it = array_pointer_->cbegin(); it != array_pointer_->cend();
-           ++it) {
-        if (it != array_pointer_->cbegin()) {
-          os << ", ";
-        }
-        it->dump(os, indent);
-      }
-      os << "]";
-      break;
-    case kObject:
-      os << "{";
-      for (auto it = object_pointer_->cbegin(); it != object_pointer_->cend();
-           ++it) {
-        if (it != object_pointer_->cbegin()) {
-          os << ", ";
-        }
-        os << R"(")" << it->first << R"(" : )";  // 不转义字符串中的特殊字符
-        it->second.dump(os, indent);
-      }
-      os << "}";
-      break;
-    default:
-      break;
-  }
+  os << dump(indent);
 }
 
 const bool Json::GetBool() const {
-  if (type_ != kBool) {
+  if (tag() != kBool) {
     throw std::logic_error("function Json::GetBool() type error, require bool");
   }
-  return bool_value_;
+  return value_.bool_value;
 }
 
 const long long Json::GetInteger() const {
-  if (type_ != kInt) {
+  if (tag() != kInt) {
     throw std::logic_error(
         "function Json::GetInteger() type error, require Integer");
   }
-  return int_value_;
+  return value_.int_value;
 }
 
 const double Json::GetDouble() const {
-  if (type_ != kDouble) {
+  if (tag() != kDouble) {
     throw std::logic_error(
         "function Json::GetDouble() type error, require double");
   }
-  return double_value_;
+  return value_.double_value;
 }
 
-const std::string &Json::GetString() const {
-  if (type_ != kString) {
+StringView Json::GetString() const {
+  if (tag() == kShortStringTag) {
+    return StringView(short_.data, short_.size);
+  }
+  if (tag() != kString) {
     throw std::logic_error(
         "function Json::GetString() type error, require string");
   }
-  return *string_pointer_;
+  return StringView(*value_.string_pointer);
+}
+
+std::string Json::TakeString() && {
+  if (tag() == kShortStringTag) {
+    std::string result(short_.data, short_.size);
+    short_.size = 0;
+    return result;
+  }
+  if (tag() != kString) {
+    throw std::logic_error(
+        "function Json::TakeString() type error, require string");
+  }
+  std::string result(std::move(*value_.string_pointer));
+  value_.string_pointer->clear();
+  return result;
+}
+
+Json::ArrayType Json::TakeArray() && {
+  if (tag() != kArray) {
+    throw std::logic_error(
+        "function Json::TakeArray() type error, requires array");
+  }
+  ArrayType result(std::move(*value_.array_pointer));
+  value_.array_pointer->clear();
+  ++value_.revision;
+  return result;
+}
+
+Json::ObjectType Json::TakeObject() && {
+  if (tag() != kObject) {
+    throw std::logic_error(
+        "function Json::TakeObject() type error, requires object");
+  }
+  ObjectType result(std::move(*value_.object_pointer));
+  value_.object_pointer->clear();
+  return result;
 }
 
 Json::ArrayType &Json::GetArray() {
   const ArrayType &array_ref = GetConstArray();
+  // 调用者可能通过返回的引用修改array
+  ++value_.revision;
   // 使用const_cast去重常量属性
-  // 因为array_pointer_指向的数组本身是非常量的，因此这种转换是合法的
+  // 因为array_pointer指向的数组本身是非常量的，因此这种转换是合法的
   return const_cast<ArrayType &>(array_ref);
 }
 
 const Json::ArrayType &Json::GetConstArray() const {
-  if (type_ != kArray) {
+  if (tag() != kArray) {
     throw std::logic_error(
         "function Json::GetConstArray() type error, requires array");
   }
-  return *array_pointer_;
+  return *value_.array_pointer;
 }
 
 Json::ObjectType &Json::GetObject() {
@@ -273,59 +419,115 @@ Json::ObjectType &Json::GetObject() {
 }
 
 const Json::ObjectType &Json::GetConstObject() const {
-  if (type_ != kObject) {
+  if (tag() != kObject) {
     throw std::logic_error(
         "function Json::GetConstObject() type error, requires object");
   }
-  return *object_pointer_;
+  return *value_.object_pointer;
+}
+
+Json::ArrayType &Json::MutableArray(const char *function_name) {
+  if (tag() == kNull) {
+    value_.array_pointer = NewStorage<ArrayType>();
+    value_.tag = kArray;
+  }
+
+  if (tag() != kArray) {
+    throw std::logic_error(std::string(function_name) +
+                           " type error, requires array or null");
+  }
+  return *value_.array_pointer;
+}
+
+Json::ObjectType &Json::MutableObject(const char *function_name) {
+  if (tag() == kNull) {
+    value_.object_pointer = NewStorage<ObjectType>();
+    value_.tag = kObject;
+  }
+
+  if (tag() != kObject) {
+    throw std::logic_error(std::string(function_name) +
+                           " type error, requires object or null");
+  }
+  return *value_.object_pointer;
 }
 
 void Json::clear() {
-  switch (type_) {
-    case kNull:
-    case kBool:
-    case kInt:
-    case kDouble:
-      break;
-    case kString:
-      delete string_pointer_;
-      break;
-    // delete数组或对象时，会自动对其中每一个元素调用析构函数
-    case kArray:
-      delete array_pointer_;
-      break;
-    case kObject:
-      delete object_pointer_;
-      break;
-    default:
-      break;
+  // arena上的存储空间随arena一起释放，短字符串没有额外的存储空间
+  if (tag() != kShortStringTag && !value_.arena_owned) {
+    switch (tag()) {
+      case kString:
+        DeleteStorage(value_.string_pointer);
+        break;
+      // delete数组或对象时，会自动对其中每一个元素调用析构函数
+      case kArray:
+        DeleteStorage(value_.array_pointer);
+        break;
+      case kObject:
+        DeleteStorage(value_.object_pointer);
+        break;
+      default:
+        break;
+    }
   }
+
+  value_.tag = kNull;
+  value_.arena_owned = false;
 }
 
 void Json::copy(const Json &json) {
-  type_ = json.type_;
-  switch (type_) {
+  // 拷贝得到的对象总是位于堆上
+  switch (json.tag()) {
     case kBool:
-      bool_value_ = json.bool_value_;
+      value_.bool_value = json.value_.bool_value;
       break;
     case kInt:
-      int_value_ = json.int_value_;
+      value_.int_value = json.value_.int_value;
       break;
     case kDouble:
-      double_value_ = json.double_value_;
+      value_.double_value = json.value_.double_value;
       break;
+    case kShortStringTag:
+      short_ = json.short_;
+      return;
     case kString:
-      string_pointer_ = new std::string(*json.string_pointer_);
+      value_.string_pointer =
+          NewStorage<std::string>(*json.value_.string_pointer);
       break;
     case kArray:
-      array_pointer_ = new ArrayType(*json.array_pointer_);
+      value_.array_pointer = NewStorage<ArrayType>(*json.value_.array_pointer);
       break;
     case kObject:
-      object_pointer_ = new ObjectType(*json.object_pointer_);
+      value_.object_pointer =
+          NewStorage<ObjectType>(*json.value_.object_pointer);
       break;
     default:
       break;
   }
+  value_.tag = json.tag();
+  value_.arena_owned = false;
+}
+
+void Json::move(Json &json) noexcept {
+  if (json.tag() == kShortStringTag) {
+    short_ = json.short_;
+  } else {
+    value_ = json.value_;
+  }
+  json.value_.tag = kNull;
+  json.value_.arena_owned = false;
+}
+
+void Json::assign_string(const char *data, std::size_t size) {
+  if (size <= kShortStringCapacity) {
+    short_.tag = kShortStringTag;
+    short_.size = static_cast<unsigned char>(size);
+    std::memcpy(short_.data, data, size);
+    return;
+  }
+  value_.string_pointer = NewStorage<std::string>(data, size);
+  value_.tag = kString;
+  value_.arena_owned = false;
 }
 
 }  // namespace jsoncpp
@@ -0,0 +1,238 @@
+#include "json_lines_reader.h"
+
+#include <algorithm>
+#include <cstring>
+#include <exception>
+#include <sstream>
+#include <utility>
+
+#include "parser.h"
+
+namespace jiayuancs {
+namespace jsoncpp {
+
+namespace {
+
+// 行内是否只有空白字符(不含换行符)
+bool IsBlankLine(const char *begin, const char *end) {
+  for (; begin != end; ++begin) {
+    if (*begin != ' ' && *begin != '\t' && *begin != '\r') {
+      return false;
+    }
+  }
+  return true;
+}
+
+}  // namespace
+
+JsonLinesReader::JsonLinesReader(const char *data, std::size_t length,
+                                 const JsonLinesOptions &options)
+    : next_(data), end_(data + length) {
+  Start(options);
+}
+
+JsonLinesReader::JsonLinesReader(std::istream &is,
+                                 const JsonLinesOptions &options)
+    : is_(&is) {
+  Start(options);
+}
+
+JsonLinesReader::~JsonLinesReader() {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    stop_ = true;
+  }
+  space_cv_.notify_all();
+  for (std::thread &worker : workers_) {
+    worker.join();
+  }
+}
+
+void JsonLinesReader::Start(const JsonLinesOptions &options) {
+  unsigned threads = options.threads;
+  if (threads == 0) {
+    threads = std::max(1u, std::thread::hardware_concurrency());
+  }
+  chunk_size_ = std::max<std::size_t>(options.chunk_size, 1);
+  max_pending_chunks_ = options.max_pending_chunks;
+  if (max_pending_chunks_ == 0) {
+    max_pending_chunks_ = 2 * threads;
+  }
+
+  try {
+    for (unsigned i = 0; i < threads; ++i) {
+      workers_.emplace_back(&JsonLinesReader::WorkerLoop, this);
+    }
+  } catch (...) {
+    // 构造函数抛出异常时不会调用析构函数，需要在此回收已启动的线程
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      stop_ = true;
+    }
+    space_cv_.notify_all();
+    for (std::thread &worker : workers_) {
+      worker.join();
+    }
+    throw;
+  }
+}
+
+bool JsonLinesReader::Next(JsonLinesRecord &record) {
+  std::unique_lock<std::mutex> lock(mutex_);
+  for (;;) {
+    if (!pending_.empty() && pending_.front()->done) {
+      Chunk &chunk = *pending_.front();
+      if (next_record_ < chunk.records.size()) {
+        record = std::move(chunk.records[next_record_++]);
+        return true;
+      }
+      pending_.pop_front();
+      next_record_ = 0;
+      space_cv_.notify_one();
+      continue;
+    }
+    if (pending_.empty() && input_exhausted_) {
+      return false;
+    }
+    ready_cv_.wait(lock);
+  }
+}
+
+void JsonLinesReader::WorkerLoop() {
+  for (;;) {
+    // 切分输入是串行的，input_mutex_保证分块按输入顺序进入pending_；
+    // 读取数据时不持有mutex_，不妨碍Next()取走已解析的文档
+    std::unique_lock<std::mutex> input_lock(input_mutex_);
+    Chunk *chunk = nullptr;
+    {
+      std::unique_lock<std::mutex> lock(mutex_);
+      space_cv_.wait(lock, [this] {
+        return stop_ || input_exhausted_ ||
+               pending_.size() < max_pending_chunks_;
+      });
+      if (stop_ || input_exhausted_) {
+        return;
+      }
+      // 先占位，保证Next()按顺序等待该分块
+      pending_.emplace_back(new Chunk());
+      chunk = pending_.back().get();
+    }
+
+    if (!(is_ != nullptr ? ReadChunk(*chunk) : SliceChunk(*chunk))) {
+      {
+        std::lock_guard<std::mutex> lock(mutex_);
+        chunk->done = true;
+        input_exhausted_ = true;
+      }
+      ready_cv_.notify_all();
+      space_cv_.notify_all();
+      return;
+    }
+    chunk->first_line_no = next_line_no_;
+    next_line_no_ += std::count(chunk->begin, chunk->end, '\n');
+    input_lock.unlock();
+
+    ParseChunk(*chunk);
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      chunk->done = true;
+    }
+    ready_cv_.notify_all();
+  }
+}
+
+bool JsonLinesReader::SliceChunk(Chunk &chunk) {
+  if (next_ == end_) {
+    return false;
+  }
+  const char *chunk_end = end_;
+  if (static_cast<std::size_t>(end_ - next_) > chunk_size_) {
+    // 延伸到分块末尾之后的第一个换行符
+    const void *newline = std::memchr(next_ + chunk_size_, '\n',
+                                      end_ - next_ - chunk_size_);
+    if (newline != nullptr) {
+      chunk_end = static_cast<const char *>(newline) + 1;
+    }
+  }
+  chunk.begin = next_;
+  chunk.end = chunk_end;
+  next_ = chunk_end;
+  return true;
+}
+
+bool JsonLinesReader::ReadChunk(Chunk &chunk) {
+  std::string &buffer = chunk.buffer;
+  buffer.swap(carry_);
+  carry_.clear();
+
+  // 读到包含换行符或流结束为止
+  std::size_t split = std::string::npos;
+  for (;;) {
+    std::size_t old_size = buffer.size();
+    buffer.resize(old_size + chunk_size_);
+    is_->read(&buffer[old_size], chunk_size_);
+    buffer.resize(old_size + is_->gcount());
+    if (!*is_) {
+      break;
+    }
+    // 只需在新读入的部分中查找，之前的部分不含换行符
+    for (std::size_t i = buffer.size(); i != old_size; --i) {
+      if (buffer[i - 1] == '\n') {
+        split = i;
+        break;
+      }
+    }
+    if (split != std::string::npos) {
+      break;
+    }
+  }
+
+  // 流结束时剩余数据全部归入最后一个分块
+  if (split != std::string::npos) {
+    carry_.assign(buffer, split, std::string::npos);
+    buffer.resize(split);
+  }
+  if (buffer.empty()) {
+    return false;
+  }
+  chunk.begin = buffer.data();
+  chunk.end = buffer.data() + buffer.size();
+  return true;
+}
+
+void JsonLinesReader::ParseChunk(Chunk &chunk) {
+  std::size_t line_no = chunk.first_line_no;
+  const char *cur = chunk.begin;
+  while (cur != chunk.end) {
+    const char *newline = static_cast<const char *>(
+        std::memchr(cur, '\n', chunk.end - cur));
+    const char *line_end = newline != nullptr ? newline : chunk.end;
+
+    if (!IsBlankLine(cur, line_end)) {
+      chunk.records.emplace_back();
+      JsonLinesRecord &record = chunk.records.back();
+      record.line_no = line_no;
+      try {
+        Parser parser(cur, line_end - cur);
+        parser.SetFirstLineNo(line_no);
+        record.value = parser.Parse();
+        if (!parser.AtEnd()) {
+          std::ostringstream error_info;
+          error_info << "syntax error in line " << line_no
+                     << ": unexpected characters after value";
+          record.value = Json();
+          record.error = error_info.str();
+        }
+      } catch (const std::exception &e) {
+        record.value = Json();
+        record.error = e.what();
+      }
+    }
+
+    ++line_no;
+    cur = newline != nullptr ? newline + 1 : chunk.end;
+  }
+}
+
+}  // namespace jsoncpp
+}  // namespace jiayuancs
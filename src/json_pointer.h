@@ -0,0 +1,49 @@
+// JSON Pointer(RFC 6901)的解码(库内部使用)
+
+#ifndef JSONCPP_SRC_JSON_POINTER_H_
+#define JSONCPP_SRC_JSON_POINTER_H_
+
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace jiayuancs {
+namespace jsoncpp {
+
+// 将pointer拆分为各级key并解码转义，"~1"表示'/'，"~0"表示'~'
+// pointer须为空串(表示整个文档)或以'/'开头，格式错误时返回false
+inline bool ParseJsonPointer(const std::string &pointer,
+                             std::vector<std::string> &tokens) {
+  if (!pointer.empty() && pointer[0] != '/') {
+    return false;
+  }
+  for (std::size_t pos = 0; pos < pointer.size();) {
+    // pointer[pos]为'/'
+    std::size_t next = pointer.find('/', pos + 1);
+    if (next == std::string::npos) {
+      next = pointer.size();
+    }
+    std::string token;
+    for (std::size_t i = pos + 1; i < next; ++i) {
+      if (pointer[i] != '~') {
+        token += pointer[i];
+      } else if (i + 1 < next && pointer[i + 1] == '0') {
+        token += '~';
+        ++i;
+      } else if (i + 1 < next && pointer[i + 1] == '1') {
+        token += '/';
+        ++i;
+      } else {
+        return false;
+      }
+    }
+    tokens.push_back(std::move(token));
+    pos = next;
+  }
+  return true;
+}
+
+}  // namespace jsoncpp
+}  // namespace jiayuancs
+
+#endif  // JSONCPP_SRC_JSON_POINTER_H_
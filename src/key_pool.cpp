@@ -0,0 +1,23 @@
+#include "key_pool.h"
+
+namespace jiayuancs {
+namespace jsoncpp {
+
+const std::string *KeyPool::Intern(const std::string &key) {
+  auto iter = keys_.find(key);
+  if (iter != keys_.end()) {
+    return &*iter;
+  }
+  if (keys_.size() >= max_keys_) {
+    return nullptr;
+  }
+  return &*keys_.insert(key).first;
+}
+
+const std::string *KeyPool::Find(const std::string &key) const {
+  auto iter = keys_.find(key);
+  return iter == keys_.end() ? nullptr : &*iter;
+}
+
+}  // namespace jsoncpp
+}  // namespace jiayuancs
@@ -0,0 +1,195 @@
+#include "lazy_document.h"
+
+#include <algorithm>
+#include <cstring>
+#include <sstream>
+#include <stdexcept>
+
+#include "number_parser.h"
+#include "parser.h"
+#include "scanner.h"
+
+namespace jiayuancs {
+namespace jsoncpp {
+
+Json::JsonType LazyValue::Type() const {
+  if (cur_ == end_) {
+    ThrowError(cur_, "expected more characters, but got eof");
+  }
+
+  switch (*cur_) {
+    case 'n':
+      return Json::kNull;
+    case 't':
+    case 'f':
+      return Json::kBool;
+    case '\"':
+      return Json::kString;
+    case '[':
+      return Json::kArray;
+    case '{':
+      return Json::kObject;
+    default:
+      break;
+  }
+
+  if (*cur_ == '-' || (*cur_ >= '0' && *cur_ <= '9')) {
+    // 带小数部分、指数部分或超出long long范围的数字为double类型
+    bool negative = *cur_ == '-';
+    number::Number number;
+    if (number::ParseNumber(cur_ + negative, end_, negative, number) ==
+        nullptr) {
+      ThrowError(cur_, "invalid number");
+    }
+    return number.is_integer ? Json::kInt : Json::kDouble;
+  }
+
+  ThrowError(cur_, "unexpected character");
+  return Json::kNull;
+}
+
+bool LazyValue::Find(const std::string &key, LazyValue &value) const {
+  if (Type() != Json::kObject) {
+    ThrowError(cur_, "expected object");
+  }
+
+  const char *cur = scanner::SkipSpace(cur_ + 1, end_);
+  if (cur != end_ && *cur == '}') {
+    return false;
+  }
+
+  bool found = false;
+  for (;;) {
+    if (cur == end_ || *cur != '\"') {
+      ThrowError(cur, "expected \'\"\' in object");
+    }
+    const char *key_begin = cur + 1;
+    cur = scanner::SkipString(key_begin, end_);
+    if (cur == nullptr) {
+      ThrowError(end_, "invalid string");
+    }
+    const char *key_end = cur - 1;
+
+    cur = scanner::SkipSpace(cur, end_);
+    if (cur == end_ || *cur != ':') {
+      ThrowError(cur, "expected \':\' in object");
+    }
+    cur = scanner::SkipSpace(cur + 1, end_);
+
+    // 不含转义字符的key直接比较原始字节，否则先解码再比较
+    bool matched = false;
+    std::size_t key_length = key_end - key_begin;
+    if (std::memchr(key_begin, '\\', key_length) == nullptr) {
+      matched = key_length == key.size() &&
+                std::memcmp(key_begin, key.data(), key_length) == 0;
+    } else {
+      matched = Parser(key_begin - 1, key_length + 2).Parse() == key;
+    }
+    // 与Parser一致，重复的key以最后一次出现的为准，因此需要扫描到object末尾
+    if (matched) {
+      value = LazyValue(begin_, cur, end_);
+      found = true;
+    }
+
+    cur = scanner::SkipValue(cur, end_);
+    if (cur == nullptr) {
+      ThrowError(end_, "expected more characters, but got eof");
+    }
+    cur = scanner::SkipSpace(cur, end_);
+    if (cur != end_ && *cur == '}') {
+      return found;
+    }
+    if (cur == end_ || *cur != ',') {
+      ThrowError(cur, "expected \',\' in object");
+    }
+    cur = scanner::SkipSpace(cur + 1, end_);
+  }
+}
+
+LazyValue LazyValue::operator[](const char *key) const {
+  return (*this)[std::string(key)];
+}
+
+LazyValue LazyValue::operator[](const std::string &key) const {
+  LazyValue value(*this);
+  if (!Find(key, value)) {
+    throw std::logic_error(
+        "function LazyValue::operator[](const string &) key not found: " +
+        key);
+  }
+  return value;
+}
+
+LazyValue LazyValue::operator[](const int index) const {
+  if (index < 0) {
+    throw std::logic_error(
+        "function LazyValue::operator[](const int) requires index > 0");
+  }
+  if (Type() != Json::kArray) {
+    ThrowError(cur_, "expected array");
+  }
+
+  const char *cur = scanner::SkipSpace(cur_ + 1, end_);
+  if (cur != end_ && *cur == ']') {
+    throw std::logic_error(
+        "function LazyValue::operator[](const int) index out of range");
+  }
+
+  for (int idx = 0;; ++idx) {
+    if (idx == index) {
+      return LazyValue(begin_, cur, end_);
+    }
+
+    cur = scanner::SkipValue(cur, end_);
+    if (cur == nullptr) {
+      ThrowError(end_, "expected more characters, but got eof");
+    }
+    cur = scanner::SkipSpace(cur, end_);
+    if (cur != end_ && *cur == ']') {
+      throw std::logic_error(
+          "function LazyValue::operator[](const int) index out of range");
+    }
+    if (cur == end_ || *cur != ',') {
+      ThrowError(cur, "invalid array");
+    }
+    cur = scanner::SkipSpace(cur + 1, end_);
+  }
+}
+
+bool LazyValue::GetBool() const { return ToJson().GetBool(); }
+
+long long LazyValue::GetInteger() const { return ToJson().GetInteger(); }
+
+double LazyValue::GetDouble() const { return ToJson().GetDouble(); }
+
+std::string LazyValue::GetString() const { return ToJson().GetString(); }
+
+Json LazyValue::ToJson() const { return Parser(cur_, end_ - cur_).Parse(); }
+
+void LazyValue::ThrowError(const char *pos, const char *info_str) const {
+  std::ostringstream error_info;
+  error_info << "syntax error in line " << 1 + std::count(begin_, pos, '\n')
+             << ": " << info_str;
+  throw std::logic_error(error_info.str());
+}
+
+LazyDocument::LazyDocument(const char *data, std::size_t length)
+    : begin_(data), end_(data + length) {}
+
+LazyDocument::LazyDocument(const char *str)
+    : LazyDocument(str, std::strlen(str)) {}
+
+LazyDocument::LazyDocument(const std::string &str)
+    : begin_(str.data()), end_(begin_ + str.size()) {}
+
+LazyDocument::LazyDocument(std::string &&str)
+    : buffer_(std::move(str)),
+      begin_(buffer_.data()),
+      end_(begin_ + buffer_.size()) {}
+
+LazyValue LazyDocument::Root() const {
+  return LazyValue(begin_, scanner::SkipSpace(begin_, end_), end_);
+}
+
+}  // namespace jsoncpp
+}  // namespace jiayuancs
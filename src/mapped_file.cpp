@@ -0,0 +1,94 @@
+#include "mapped_file.h"
+
+#include <cerrno>
+#include <cstring>
+#include <stdexcept>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#define JSONCPP_HAS_MMAP 1
+#else
+#include <fstream>
+#include <iterator>
+#endif
+
+namespace jiayuancs {
+namespace jsoncpp {
+
+namespace {
+
+// error为失败时的errno，须在调用close等可能修改errno的函数之前保存
+void ThrowFileError(const char *operation, const std::string &path,
+                    int error) {
+  throw std::runtime_error(std::string(operation) + " \"" + path +
+                           "\" failed: " + std::strerror(error));
+}
+
+}  // namespace
+
+#ifdef JSONCPP_HAS_MMAP
+
+MappedFile::MappedFile(const std::string &path) {
+  int fd = ::open(path.c_str(), O_RDONLY);
+  if (fd < 0) {
+    ThrowFileError("open", path, errno);
+  }
+  struct stat file_stat;
+  if (::fstat(fd, &file_stat) != 0) {
+    int error = errno;
+    ::close(fd);
+    ThrowFileError("stat", path, error);
+  }
+
+  size_ = static_cast<std::size_t>(file_stat.st_size);
+  // 长度为0的映射不合法，空文件不需要映射
+  if (size_ != 0) {
+    void *address = ::mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd, 0);
+    if (address == MAP_FAILED) {
+      int error = errno;
+      ::close(fd);
+      ThrowFileError("mmap", path, error);
+    }
+    data_ = static_cast<const char *>(address);
+    mapped_ = true;
+  }
+  // 映射建立后即可关闭文件描述符
+  ::close(fd);
+}
+
+MappedFile::~MappedFile() {
+  if (mapped_) {
+    ::munmap(const_cast<char *>(data_), size_);
+  }
+}
+
+void MappedFile::AdviseSequential() {
+  if (mapped_) {
+    ::madvise(const_cast<char *>(data_), size_, MADV_SEQUENTIAL);
+  }
+}
+
+#else
+
+MappedFile::MappedFile(const std::string &path) {
+  std::ifstream ifs(path, std::ios::binary);
+  if (!ifs) {
+    ThrowFileError("open", path, errno);
+  }
+  buffer_.assign(std::istreambuf_iterator<char>(ifs),
+                 std::istreambuf_iterator<char>());
+  data_ = buffer_.empty() ? nullptr : buffer_.data();
+  size_ = buffer_.size();
+}
+
+MappedFile::~MappedFile() {}
+
+void MappedFile::AdviseSequential() {}
+
+#endif  // JSONCPP_HAS_MMAP
+
+}  // namespace jsoncpp
+}  // namespace jiayuancs
@@ -0,0 +1,362 @@
+#include "msgpack.h"
+
+#include <climits>
+#include <cstdint>
+#include <sstream>
+#include <stdexcept>
+
+#include "big_endian.h"
+#include "dom_builder.h"
+
+namespace jiayuancs {
+namespace jsoncpp {
+namespace msgpack {
+
+namespace {
+
+// 固定格式之外的类型字节
+enum Format : unsigned char {
+  kNil = 0xC0,
+  kFalse = 0xC2,
+  kTrue = 0xC3,
+  kFloat32 = 0xCA,
+  kFloat64 = 0xCB,
+  kUint8 = 0xCC,
+  kUint16 = 0xCD,
+  kUint32 = 0xCE,
+  kUint64 = 0xCF,
+  kInt8 = 0xD0,
+  kInt16 = 0xD1,
+  kInt32 = 0xD2,
+  kInt64 = 0xD3,
+  kStr8 = 0xD9,
+  kStr16 = 0xDA,
+  kStr32 = 0xDB,
+  kArray16 = 0xDC,
+  kArray32 = 0xDD,
+  kMap16 = 0xDE,
+  kMap32 = 0xDF,
+};
+
+// array和map的最大嵌套深度，防止恶意输入耗尽栈空间
+const int kMaxDepth = 1000;
+
+void WriteFormat(Format format, std::uint64_t value, int size,
+                 std::string &output) {
+  output += static_cast<char>(format);
+  AppendBigEndian(value, size, output);
+}
+
+void WriteInteger(long long value, std::string &output) {
+  if (value >= 0) {
+    if (value <= 0x7F) {
+      output += static_cast<char>(value);  // positive fixint
+    } else if (value <= 0xFF) {
+      WriteFormat(kUint8, value, 1, output);
+    } else if (value <= 0xFFFF) {
+      WriteFormat(kUint16, value, 2, output);
+    } else if (value <= 0xFFFFFFFF) {
+      WriteFormat(kUint32, value, 4, output);
+    } else {
+      WriteFormat(kUint64, value, 8, output);
+    }
+    return;
+  }
+
+  // 补码按位写入
+  std::uint64_t bits = static_cast<std::uint64_t>(value);
+  if (value >= -32) {
+    output += static_cast<char>(bits);  // negative fixint
+  } else if (value >= INT8_MIN) {
+    WriteFormat(kInt8, bits, 1, output);
+  } else if (value >= INT16_MIN) {
+    WriteFormat(kInt16, bits, 2, output);
+  } else if (value >= INT32_MIN) {
+    WriteFormat(kInt32, bits, 4, output);
+  } else {
+    WriteFormat(kInt64, bits, 8, output);
+  }
+}
+
+void WriteString(const char *data, std::size_t size, std::string &output) {
+  if (size <= 31) {
+    output += static_cast<char>(0xA0 | size);  // fixstr
+  } else if (size <= 0xFF) {
+    WriteFormat(kStr8, size, 1, output);
+  } else if (size <= 0xFFFF) {
+    WriteFormat(kStr16, size, 2, output);
+  } else {
+    WriteFormat(kStr32, size, 4, output);
+  }
+  output.append(data, size);
+}
+
+// fix_format为长度不超过15时的固定格式(fixarray或fixmap)
+void WriteContainerHead(unsigned char fix_format, Format format16,
+                        Format format32, std::size_t size,
+                        std::string &output) {
+  if (size <= 15) {
+    output += static_cast<char>(fix_format | size);
+  } else if (size <= 0xFFFF) {
+    WriteFormat(format16, size, 2, output);
+  } else {
+    WriteFormat(format32, size, 4, output);
+  }
+}
+
+void EncodeValue(const Json &json, std::string &output) {
+  switch (json.Type()) {
+    case Json::kNull:
+      output += static_cast<char>(kNil);
+      break;
+    case Json::kBool:
+      output += static_cast<char>(json.GetBool() ? kTrue : kFalse);
+      break;
+    case Json::kInt:
+      WriteInteger(json.GetInteger(), output);
+      break;
+    case Json::kDouble:
+      WriteFormat(kFloat64, DoubleToBits(json.GetDouble()), 8, output);
+      break;
+    case Json::kString: {
+      StringView value = json.GetString();
+      WriteString(value.data(), value.size(), output);
+      break;
+    }
+    case Json::kArray: {
+      const Json::ArrayType &array = json.GetConstArray();
+      WriteContainerHead(0x90, kArray16, kArray32, array.size(), output);
+      for (const Json &element : array) {
+        EncodeValue(element, output);
+      }
+      break;
+    }
+    case Json::kObject: {
+      const Json::ObjectType &object = json.GetConstObject();
+      WriteContainerHead(0x80, kMap16, kMap32, object.size(), output);
+      for (const auto &member : object) {
+        WriteString(member.first.data(), member.first.size(), output);
+        EncodeValue(member.second, output);
+      }
+      break;
+    }
+    default:
+      break;
+  }
+}
+
+class Decoder final {
+ public:
+  Decoder(const char *data, std::size_t length, Handler &handler)
+      : begin_(data), cur_(data), end_(data + length), handler_(handler) {}
+
+  void Decode() {
+    DecodeObject();
+    if (cur_ != end_) {
+      ThrowError("unexpected bytes after the object");
+    }
+  }
+
+ private:
+  void DecodeObject() {
+    Need(1);
+    unsigned char format = static_cast<unsigned char>(*cur_++);
+    if (format <= 0x7F) {
+      handler_.OnInt(format);
+      return;
+    }
+    if (format >= 0xE0) {
+      handler_.OnInt(static_cast<signed char>(format));
+      return;
+    }
+    if ((format & 0xF0) == 0x80) {
+      DecodeMap(format & 0x0F);
+      return;
+    }
+    if ((format & 0xF0) == 0x90) {
+      DecodeArray(format & 0x0F);
+      return;
+    }
+    if ((format & 0xE0) == 0xA0) {
+      ReadString(format & 0x1F);
+      handler_.OnString(string_buffer_);
+      return;
+    }
+
+    switch (format) {
+      case kNil:
+        handler_.OnNull();
+        return;
+      case kFalse:
+        handler_.OnBool(false);
+        return;
+      case kTrue:
+        handler_.OnBool(true);
+        return;
+      case kFloat32:
+        handler_.OnDouble(BitsToFloat(Read(4)));
+        return;
+      case kFloat64:
+        handler_.OnDouble(BitsToDouble(Read(8)));
+        return;
+      case kUint8:
+        handler_.OnInt(Read(1));
+        return;
+      case kUint16:
+        handler_.OnInt(Read(2));
+        return;
+      case kUint32:
+        handler_.OnInt(Read(4));
+        return;
+      case kUint64: {
+        std::uint64_t value = Read(8);
+        if (value <= LLONG_MAX) {
+          handler_.OnInt(static_cast<long long>(value));
+        } else {
+          handler_.OnDouble(static_cast<double>(value));
+        }
+        return;
+      }
+      case kInt8:
+        handler_.OnInt(static_cast<std::int8_t>(Read(1)));
+        return;
+      case kInt16:
+        handler_.OnInt(static_cast<std::int16_t>(Read(2)));
+        return;
+      case kInt32:
+        handler_.OnInt(static_cast<std::int32_t>(Read(4)));
+        return;
+      case kInt64:
+        handler_.OnInt(static_cast<std::int64_t>(Read(8)));
+        return;
+      case kStr8:
+      case kStr16:
+      case kStr32:
+        ReadString(Read(1 << (format - kStr8)));
+        handler_.OnString(string_buffer_);
+        return;
+      case kArray16:
+        DecodeArray(Read(2));
+        return;
+      case kArray32:
+        DecodeArray(Read(4));
+        return;
+      case kMap16:
+        DecodeMap(Read(2));
+        return;
+      case kMap32:
+        DecodeMap(Read(4));
+        return;
+      default:
+        // bin、ext和保留的0xC1
+        ThrowError("unsupported format");
+    }
+  }
+
+  void DecodeArray(std::uint64_t size) {
+    CheckCount(size);
+    Enter();
+    handler_.OnStartArray();
+    for (; size != 0; --size) {
+      DecodeObject();
+    }
+    handler_.OnEndArray();
+    --depth_;
+  }
+
+  void DecodeMap(std::uint64_t size) {
+    CheckCount(size);
+    Enter();
+    handler_.OnStartObject();
+    for (; size != 0; --size) {
+      Need(1);
+      unsigned char format = static_cast<unsigned char>(*cur_++);
+      if ((format & 0xE0) == 0xA0) {
+        ReadString(format & 0x1F);
+      } else if (format >= kStr8 && format <= kStr32) {
+        ReadString(Read(1 << (format - kStr8)));
+      } else {
+        ThrowError("map keys must be strings");
+      }
+      handler_.OnKey(string_buffer_);
+      DecodeObject();
+    }
+    handler_.OnEndObject();
+    --depth_;
+  }
+
+  // 进入一层嵌套
+  void Enter() {
+    if (++depth_ > kMaxDepth) {
+      ThrowError("nesting too deep");
+    }
+  }
+
+  // 读取size字节的字符串内容，结果存入string_buffer_
+  void ReadString(std::uint64_t size) {
+    Need(size);
+    string_buffer_.assign(cur_, static_cast<std::size_t>(size));
+    cur_ += size;
+  }
+
+  std::uint64_t Read(int size) {
+    Need(size);
+    std::uint64_t value = ReadBigEndian(cur_, size);
+    cur_ += size;
+    return value;
+  }
+
+  // 每个元素至少占1个字节，元素个数不会超过剩余的字节数
+  void CheckCount(std::uint64_t count) { Need(count); }
+
+  void Need(std::uint64_t size) {
+    if (size > static_cast<std::uint64_t>(end_ - cur_)) {
+      ThrowError("unexpected end of input");
+    }
+  }
+
+  [[noreturn]] void ThrowError(const char *info_str) {
+    std::ostringstream error_info;
+    error_info << "invalid MessagePack at byte " << (cur_ - begin_) << ": "
+               << info_str;
+    throw std::logic_error(error_info.str());
+  }
+
+  const char *begin_;
+  const char *cur_;
+  const char *end_;
+  Handler &handler_;
+  std::string string_buffer_;  // 复用的字符串缓冲区
+  int depth_ = 0;              // 当前的嵌套深度
+};
+
+}  // namespace
+
+void Encode(const Json &json, std::string &output) {
+  EncodeValue(json, output);
+}
+
+std::string Encode(const Json &json) {
+  std::string output;
+  EncodeValue(json, output);
+  return output;
+}
+
+Json Decode(const char *data, std::size_t length) {
+  Json root;
+  DomBuilder builder(root, nullptr);
+  Decode(data, length, builder);
+  return root;
+}
+
+Json Decode(const std::string &data) {
+  return Decode(data.data(), data.size());
+}
+
+void Decode(const char *data, std::size_t length, Handler &handler) {
+  Decoder(data, length, handler).Decode();
+}
+
+}  // namespace msgpack
+}  // namespace jsoncpp
+}  // namespace jiayuancs
@@ -0,0 +1,588 @@
+#include "number_parser.h"
+
+#include <cstdint>
+#include <cstring>
+#include <limits>
+
+#include "power_of_five_table.h"
+
+namespace jiayuancs {
+namespace jsoncpp {
+namespace number {
+
+namespace {
+
+// 可以精确表示的10的幂次，用于快速路径
+const double kExactPowerOfTen[] = {
+    1e0,  1e1,  1e2,  1e3,  1e4,  1e5,  1e6,  1e7,  1e8,  1e9,  1e10, 1e11,
+    1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22};
+
+// uint64_t最多能精确保存的十进制位数
+const int kMaxMantissaDigits = 19;
+
+// IEEE 754双精度浮点数的参数
+const int kMantissaBits = 52;
+const int kMinimumExponent = -1023;
+const int kInfinitePower = 0x7FF;
+// 只有q位于该范围时，乘积才可能恰好位于两个浮点数的正中间
+const int kMinRoundToEven = -4;
+const int kMaxRoundToEven = 23;
+
+bool IsDigit(char ch) { return ch >= '0' && ch <= '9'; }
+
+// 8个字节是否都是数字字符(小端序)
+bool IsEightDigits(std::uint64_t chunk) {
+  return ((chunk & 0xF0F0F0F0F0F0F0F0) |
+          (((chunk + 0x0606060606060606) & 0xF0F0F0F0F0F0F0F0) >> 4)) ==
+         0x3333333333333333;
+}
+
+// 一次性把8个数字字符转换为整数(SWAR，小端序)
+std::uint32_t ParseEightDigits(std::uint64_t chunk) {
+  const std::uint64_t kMask = 0x000000FF000000FF;
+  const std::uint64_t kMul1 = 0x000F424000000064;  // 100 + (1000000 << 32)
+  const std::uint64_t kMul2 = 0x0000271000000001;  // 1 + (10000 << 32)
+  chunk -= 0x3030303030303030;
+  chunk = (chunk * 10) + (chunk >> 8);  // 相邻两位合并为一个字节
+  chunk = (((chunk & kMask) * kMul1) + (((chunk >> 16) & kMask) * kMul2)) >> 32;
+  return static_cast<std::uint32_t>(chunk);
+}
+
+bool IsLittleEndian() {
+  const std::uint16_t value = 1;
+  unsigned char byte;
+  std::memcpy(&byte, &value, 1);
+  return byte == 1;
+}
+
+const bool kLittleEndian = IsLittleEndian();
+
+// 读取连续的数字字符并累加到value(超过19位时会回绕，由调用者处理)
+const char *ParseDigits(const char *cur, const char *end,
+                        std::uint64_t &value) {
+  if (kLittleEndian) {
+    while (end - cur >= 8) {
+      std::uint64_t chunk;
+      std::memcpy(&chunk, cur, 8);
+      if (!IsEightDigits(chunk)) {
+        break;
+      }
+      value = value * 100000000 + ParseEightDigits(chunk);
+      cur += 8;
+    }
+  }
+  while (cur != end && IsDigit(*cur)) {
+    value = value * 10 + static_cast<std::uint64_t>(*cur - '0');
+    ++cur;
+  }
+  return cur;
+}
+
+int LeadingZeros(std::uint64_t value) {
+#if defined(__GNUC__)
+  return __builtin_clzll(value);
+#else
+  int count = 0;
+  while ((value & (std::uint64_t(1) << 63)) == 0) {
+    value <<= 1;
+    ++count;
+  }
+  return count;
+#endif
+}
+
+struct Uint128 {
+  std::uint64_t high;
+  std::uint64_t low;
+};
+
+Uint128 FullMultiply(std::uint64_t a, std::uint64_t b) {
+#if defined(__SIZEOF_INT128__)
+  unsigned __int128 product = static_cast<unsigned __int128>(a) * b;
+  return {static_cast<std::uint64_t>(product >> 64),
+          static_cast<std::uint64_t>(product)};
+#else
+  std::uint64_t a_low = a & 0xFFFFFFFF;
+  std::uint64_t a_high = a >> 32;
+  std::uint64_t b_low = b & 0xFFFFFFFF;
+  std::uint64_t b_high = b >> 32;
+  std::uint64_t low_low = a_low * b_low;
+  std::uint64_t high_low = a_high * b_low;
+  std::uint64_t low_high = a_low * b_high;
+  std::uint64_t high_high = a_high * b_high;
+  std::uint64_t middle =
+      (low_low >> 32) + (high_low & 0xFFFFFFFF) + (low_high & 0xFFFFFFFF);
+  return {high_high + (high_low >> 32) + (low_high >> 32) + (middle >> 32),
+          (middle << 32) | (low_low & 0xFFFFFFFF)};
+#endif
+}
+
+// 二进制浮点数：mantissa不含隐含的最高位，power2为带偏移的指数
+struct BinaryFloat {
+  std::uint64_t mantissa;
+  int power2;
+};
+
+double ToDouble(BinaryFloat value, bool negative) {
+  std::uint64_t bits =
+      value.mantissa | (static_cast<std::uint64_t>(value.power2) << 52);
+  if (negative) {
+    bits |= std::uint64_t(1) << 63;
+  }
+  double result;
+  std::memcpy(&result, &bits, sizeof(result));
+  return result;
+}
+
+// floor(q * log2(10)) + 63
+int Power(int q) { return (((152170 + 65536) * q) >> 16) + 63; }
+
+// Eisel-Lemire算法：计算w * 10^q最接近的双精度浮点数
+// w不超过19位时结果总是正确舍入的(Mushtak & Lemire, 2023)
+BinaryFloat ComputeFloat(long long q, std::uint64_t w) {
+  if (w == 0 || q < kMinPowerOfFive) {
+    return {0, 0};
+  }
+  if (q > kMaxPowerOfFive) {
+    return {0, kInfinitePower};
+  }
+
+  int lz = LeadingZeros(w);
+  w <<= lz;
+
+  // 需要53位有效位，加上一个舍入位和可能因upperbit损失的一位
+  const std::uint64_t *power = kPowerOfFive[q - kMinPowerOfFive];
+  Uint128 product = FullMultiply(w, power[0]);
+  const std::uint64_t kPrecisionMask =
+      0xFFFFFFFFFFFFFFFF >> (kMantissaBits + 3);
+  if ((product.high & kPrecisionMask) == kPrecisionMask) {
+    // 高64位的精度不够时，再乘上5^q的低64位
+    Uint128 second = FullMultiply(w, power[1]);
+    product.low += second.high;
+    if (second.high > product.low) {
+      ++product.high;
+    }
+  }
+
+  int upperbit = static_cast<int>(product.high >> 63);
+  int shift = upperbit + 64 - kMantissaBits - 3;
+  BinaryFloat answer;
+  answer.mantissa = product.high >> shift;
+  answer.power2 =
+      Power(static_cast<int>(q)) + upperbit - lz - kMinimumExponent;
+
+  if (answer.power2 <= 0) {  // 非规格化数
+    if (-answer.power2 + 1 >= 64) {
+      return {0, 0};
+    }
+    answer.mantissa >>= -answer.power2 + 1;
+    answer.mantissa += answer.mantissa & 1;
+    answer.mantissa >>= 1;
+    // 舍入后可能恰好成为最小的规格化数
+    answer.power2 =
+        answer.mantissa < (std::uint64_t(1) << kMantissaBits) ? 0 : 1;
+    answer.mantissa &= ~(std::uint64_t(1) << kMantissaBits);
+    return answer;
+  }
+
+  // 恰好位于两个浮点数正中间时向偶数舍入
+  if (product.low <= 1 && q >= kMinRoundToEven && q <= kMaxRoundToEven &&
+      (answer.mantissa & 3) == 1) {
+    if ((answer.mantissa << shift) == product.high) {
+      answer.mantissa &= ~std::uint64_t(1);
+    }
+  }
+
+  answer.mantissa += answer.mantissa & 1;
+  answer.mantissa >>= 1;
+  if (answer.mantissa >= (std::uint64_t(2) << kMantissaBits)) {
+    answer.mantissa = std::uint64_t(1) << kMantissaBits;
+    ++answer.power2;
+  }
+  answer.mantissa &= ~(std::uint64_t(1) << kMantissaBits);
+  if (answer.power2 >= kInfinitePower) {
+    return {0, kInfinitePower};
+  }
+  return answer;
+}
+
+// 慢速路径：用任意精度的十进制数做精确的二进制转换
+// 仅在有效数字超过19位、且快速算法无法确定结果时使用
+class Decimal final {
+ public:
+  // 从数字的文本构造，[begin, end)包含整数部分、可选的小数点和小数部分
+  Decimal(const char *begin, const char *end, long long exponent);
+
+  BinaryFloat ToBinary();
+
+ private:
+  static const int kMaxDigits = 800;
+  // 一次移位的最大位数，保证中间结果不超过64位
+  static const int kMaxShift = 60;
+
+  void Shift(int shift);
+  void LeftShift(int shift);
+  void RightShift(int shift);
+  void Trim();
+  bool ShouldRoundUp(int position) const;
+  std::uint64_t RoundedInteger() const;
+
+  unsigned char digits_[kMaxDigits];  // 各位数字(0-9)，不含前导零和末尾的零
+  int count_ = 0;                     // 有效数字的个数
+  long long point_ = 0;               // 小数点位于第point_位数字之后
+  bool truncated_ = false;            // 是否丢弃了非零的数字
+};
+
+Decimal::Decimal(const char *begin, const char *end, long long exponent) {
+  bool fraction = false;
+  for (const char *cur = begin; cur != end; ++cur) {
+    if (*cur == '.') {
+      fraction = true;
+      continue;
+    }
+    int digit = *cur - '0';
+    if (digit == 0 && count_ == 0) {  // 前导零
+      if (fraction) {
+        --point_;
+      }
+      continue;
+    }
+    if (!fraction) {
+      ++point_;
+    }
+    if (count_ < kMaxDigits) {
+      digits_[count_++] = static_cast<unsigned char>(digit);
+    } else if (digit != 0) {
+      truncated_ = true;
+    }
+  }
+  point_ += exponent;
+  Trim();
+}
+
+void Decimal::Trim() {
+  while (count_ > 0 && digits_[count_ - 1] == 0) {
+    --count_;
+  }
+  if (count_ == 0) {
+    point_ = 0;
+  }
+}
+
+void Decimal::Shift(int shift) {
+  if (count_ == 0) {
+    return;
+  }
+  for (; shift > kMaxShift; shift -= kMaxShift) {
+    LeftShift(kMaxShift);
+  }
+  if (shift > 0) {
+    LeftShift(shift);
+  }
+  for (; shift < -kMaxShift; shift += kMaxShift) {
+    RightShift(kMaxShift);
+  }
+  if (shift < 0) {
+    RightShift(-shift);
+  }
+}
+
+// 乘以2^shift
+void Decimal::LeftShift(int shift) {
+  // shift不超过60时，结果最多增加19位
+  const int kMaxGrowth = 19;
+  unsigned char buffer[kMaxDigits + kMaxGrowth];
+  int write = count_ + kMaxGrowth;
+  std::uint64_t n = 0;
+  for (int read = count_ - 1; read >= 0; --read) {
+    n += static_cast<std::uint64_t>(digits_[read]) << shift;
+    buffer[--write] = static_cast<unsigned char>(n % 10);
+    n /= 10;
+  }
+  while (n > 0) {
+    buffer[--write] = static_cast<unsigned char>(n % 10);
+    n /= 10;
+  }
+
+  int length = count_ + kMaxGrowth - write;
+  point_ += length - count_;
+  count_ = length < kMaxDigits ? length : kMaxDigits;
+  for (int i = count_; i < length; ++i) {
+    if (buffer[write + i] != 0) {
+      truncated_ = true;
+    }
+  }
+  std::memcpy(digits_, buffer + write, count_);
+  Trim();
+}
+
+// 除以2^shift
+void Decimal::RightShift(int shift) {
+  int read = 0;
+  int write = 0;
+  std::uint64_t n = 0;
+
+  // 读入足够多的高位
+  for (; (n >> shift) == 0; ++read) {
+    if (read >= count_) {
+      if (n == 0) {
+        count_ = 0;
+        point_ = 0;
+        return;
+      }
+      while ((n >> shift) == 0) {
+        n *= 10;
+        ++read;
+      }
+      break;
+    }
+    n = n * 10 + digits_[read];
+  }
+  point_ -= read - 1;
+
+  const std::uint64_t mask = (std::uint64_t(1) << shift) - 1;
+  for (; read < count_; ++read) {
+    std::uint64_t digit = n >> shift;
+    n &= mask;
+    digits_[write++] = static_cast<unsigned char>(digit);
+    n = n * 10 + digits_[read];
+  }
+  while (n > 0) {
+    std::uint64_t digit = n >> shift;
+    n &= mask;
+    if (write < kMaxDigits) {
+      digits_[write++] = static_cast<unsigned char>(digit);
+    } else if (digit > 0) {
+      truncated_ = true;
+    }
+    n *= 10;
+  }
+  count_ = write;
+  Trim();
+}
+
+bool Decimal::ShouldRoundUp(int position) const {
+  if (position < 0 || position >= count_) {
+    return false;
+  }
+  // 恰好是一半时向偶数舍入，但丢弃过非零数字时实际值略大于一半
+  if (digits_[position] == 5 && position + 1 == count_) {
+    if (truncated_) {
+      return true;
+    }
+    return position > 0 && digits_[position - 1] % 2 == 1;
+  }
+  return digits_[position] >= 5;
+}
+
+std::uint64_t Decimal::RoundedInteger() const {
+  if (point_ > 20) {
+    return 0xFFFFFFFFFFFFFFFF;
+  }
+  int point = static_cast<int>(point_);
+  std::uint64_t n = 0;
+  int i = 0;
+  for (; i < point && i < count_; ++i) {
+    n = n * 10 + digits_[i];
+  }
+  for (; i < point; ++i) {
+    n *= 10;
+  }
+  if (ShouldRoundUp(point)) {
+    ++n;
+  }
+  return n;
+}
+
+BinaryFloat Decimal::ToBinary() {
+  if (count_ == 0 || point_ < -330) {
+    return {0, 0};
+  }
+  if (point_ > 310) {
+    return {0, kInfinitePower};
+  }
+
+  // 每次移位的位数，使十进制数的量级逐步接近[0.5, 1)
+  static const int kShiftTable[] = {1, 3, 6, 9, 13, 16, 19, 23, 26};
+  const int kTableSize = sizeof(kShiftTable) / sizeof(kShiftTable[0]);
+
+  int exponent = 0;
+  while (point_ > 0) {
+    int shift = point_ >= kTableSize ? 27 : kShiftTable[point_];
+    Shift(-shift);
+    exponent += shift;
+  }
+  while (point_ < 0 || (point_ == 0 && digits_[0] < 5)) {
+    int shift = -point_ >= kTableSize ? 27 : kShiftTable[-point_];
+    Shift(shift);
+    exponent -= shift;
+  }
+
+  // 现在位于[0.5, 1)，浮点数的尾数位于[1, 2)
+  --exponent;
+  if (exponent < kMinimumExponent + 1) {
+    int shift = kMinimumExponent + 1 - exponent;
+    Shift(-shift);
+    exponent += shift;
+  }
+  if (exponent - kMinimumExponent >= kInfinitePower) {
+    return {0, kInfinitePower};
+  }
+
+  // 取出53位(含隐含的最高位)
+  Shift(kMantissaBits + 1);
+  std::uint64_t mantissa = RoundedInteger();
+  if (mantissa == (std::uint64_t(2) << kMantissaBits)) {  // 舍入产生进位
+    mantissa >>= 1;
+    ++exponent;
+    if (exponent - kMinimumExponent >= kInfinitePower) {
+      return {0, kInfinitePower};
+    }
+  }
+  // 非规格化数
+  if ((mantissa & (std::uint64_t(1) << kMantissaBits)) == 0) {
+    exponent = kMinimumExponent;
+  }
+  return {mantissa & ((std::uint64_t(1) << kMantissaBits) - 1),
+          exponent - kMinimumExponent};
+}
+
+}  // namespace
+
+const char *ParseNumber(const char *cur, const char *end, bool negative,
+                        Number &number) {
+  const char *begin = cur;
+  if (cur == end || !IsDigit(*cur)) {
+    return nullptr;
+  }
+
+  // 整数部分，不允许有多余的前导零
+  std::uint64_t mantissa = 0;
+  if (*cur == '0') {
+    if (++cur != end && IsDigit(*cur)) {
+      return nullptr;
+    }
+  } else {
+    cur = ParseDigits(cur, end, mantissa);
+  }
+  long long digit_count = cur - begin;
+
+  // 小数部分
+  long long fraction_digits = 0;
+  bool is_integer = true;
+  if (cur != end && *cur == '.') {
+    const char *fraction = ++cur;
+    cur = ParseDigits(cur, end, mantissa);
+    if (cur == fraction) {
+      return nullptr;
+    }
+    fraction_digits = cur - fraction;
+    digit_count += fraction_digits;
+    is_integer = false;
+  }
+  const char *digits_end = cur;
+
+  // 指数部分
+  long long exponent_number = 0;
+  if (cur != end && (*cur == 'e' || *cur == 'E')) {
+    ++cur;
+    bool negative_exponent = false;
+    if (cur != end && (*cur == '+' || *cur == '-')) {
+      negative_exponent = *cur == '-';
+      ++cur;
+    }
+    if (cur == end || !IsDigit(*cur)) {
+      return nullptr;
+    }
+    for (; cur != end && IsDigit(*cur); ++cur) {
+      // 超出范围的指数只需保持足够大即可
+      if (exponent_number < 0x10000000) {
+        exponent_number = exponent_number * 10 + (*cur - '0');
+      }
+    }
+    if (negative_exponent) {
+      exponent_number = -exponent_number;
+    }
+    is_integer = false;
+  }
+
+  // 整数，超出long long的范围时转为浮点数
+  if (is_integer && digit_count <= kMaxMantissaDigits) {
+    if (!negative &&
+        mantissa <= static_cast<std::uint64_t>(
+                        std::numeric_limits<long long>::max())) {
+      number.is_integer = true;
+      number.integer = static_cast<long long>(mantissa);
+      return cur;
+    }
+    if (negative && mantissa <= (std::uint64_t(1) << 63)) {
+      number.is_integer = true;
+      number.integer = mantissa == (std::uint64_t(1) << 63)
+                           ? std::numeric_limits<long long>::min()
+                           : -static_cast<long long>(mantissa);
+      return cur;
+    }
+  }
+  number.is_integer = false;
+
+  // 数值为mantissa * 10^exponent
+  long long exponent = exponent_number - fraction_digits;
+
+  // 有效数字(不含前导零)超过19位时mantissa已回绕，改为只取前19位有效数字，
+  // 此时数值介于mantissa * 10^exponent与(mantissa + 1) * 10^exponent之间
+  bool truncated = false;
+  if (digit_count > kMaxMantissaDigits) {
+    const char *start = begin;
+    while (start != digits_end && (*start == '0' || *start == '.')) {
+      ++start;
+    }
+    long long significant = 0;
+    for (const char *p = start; p != digits_end; ++p) {
+      significant += *p != '.';
+    }
+    if (significant > kMaxMantissaDigits) {
+      truncated = true;
+      mantissa = 0;
+      for (int used = 0; used < kMaxMantissaDigits; ++start) {
+        if (*start != '.') {
+          mantissa = mantissa * 10 + static_cast<std::uint64_t>(*start - '0');
+          ++used;
+        }
+      }
+      exponent += significant - kMaxMantissaDigits;
+    }
+  }
+
+  if (!truncated) {
+    // 快速路径：尾数和10的幂次都能精确表示，一次乘除法即可正确舍入
+    if (exponent >= -22 && exponent <= 22 &&
+        mantissa <= (std::uint64_t(1) << 53)) {
+      double value = static_cast<double>(mantissa);
+      if (exponent < 0) {
+        value /= kExactPowerOfTen[-exponent];
+      } else {
+        value *= kExactPowerOfTen[exponent];
+      }
+      number.double_value = negative ? -value : value;
+      return cur;
+    }
+    number.double_value = ToDouble(ComputeFloat(exponent, mantissa), negative);
+    return cur;
+  }
+
+  BinaryFloat lower = ComputeFloat(exponent, mantissa);
+  BinaryFloat upper = ComputeFloat(exponent, mantissa + 1);
+  if (lower.mantissa == upper.mantissa && lower.power2 == upper.power2) {
+    number.double_value = ToDouble(lower, negative);
+    return cur;
+  }
+
+  // 无法确定时使用全部数字精确计算
+  Decimal decimal(begin, digits_end, exponent_number);
+  number.double_value = ToDouble(decimal.ToBinary(), negative);
+  return cur;
+}
+
+}  // namespace number
+}  // namespace jsoncpp
+}  // namespace jiayuancs
@@ -0,0 +1,27 @@
+// JSON数字的解析(库内部使用)
+
+#ifndef JSONCPP_SRC_NUMBER_PARSER_H_
+#define JSONCPP_SRC_NUMBER_PARSER_H_
+
+namespace jiayuancs {
+namespace jsoncpp {
+namespace number {
+
+struct Number {
+  bool is_integer;       // 是否为整数(没有小数部分和指数部分，且不超出long long)
+  long long integer;     // is_integer为true时有效
+  double double_value;   // is_integer为false时有效，正确舍入，超出范围时为±inf
+};
+
+// 按JSON语法解析一个数字：-?(0|[1-9][0-9]*)(\.[0-9]+)?([eE][+-]?[0-9]+)?
+// cur指向负号之后的第一个字符，负号由调用者处理并通过negative传入
+// 成功时返回数字之后的位置，格式错误(包括"0123"这样多余的前导零)时
+// 返回nullptr
+const char *ParseNumber(const char *cur, const char *end, bool negative,
+                        Number &number);
+
+}  // namespace number
+}  // namespace jsoncpp
+}  // namespace jiayuancs
+
+#endif  // JSONCPP_SRC_NUMBER_PARSER_H_
@@ -0,0 +1,373 @@
+#include "number_writer.h"
+
+#include <cstdint>
+#include <cstring>
+
+namespace jiayuancs {
+namespace jsoncpp {
+namespace number {
+
+namespace {
+
+// 00到99的两位数字，整数一次输出两位
+const char kDigitPairs[] =
+    "00010203040506070809"
+    "10111213141516171819"
+    "20212223242526272829"
+    "30313233343536373839"
+    "40414243444546474849"
+    "50515253545556575859"
+    "60616263646566676869"
+    "70717273747576777879"
+    "80818283848586878889"
+    "90919293949596979899";
+
+// 将value的各位数字写到[begin, end)中，end - begin等于value的位数
+void WriteDigits(std::uint64_t value, char *end) {
+  while (value >= 100) {
+    unsigned pair = static_cast<unsigned>(value % 100) * 2;
+    value /= 100;
+    *--end = kDigitPairs[pair + 1];
+    *--end = kDigitPairs[pair];
+  }
+  if (value >= 10) {
+    unsigned pair = static_cast<unsigned>(value) * 2;
+    *--end = kDigitPairs[pair + 1];
+    *--end = kDigitPairs[pair];
+  } else {
+    *--end = static_cast<char>('0' + value);
+  }
+}
+
+int CountDigits(std::uint64_t value) {
+  int count = 1;
+  for (;;) {
+    if (value < 10) return count;
+    if (value < 100) return count + 1;
+    if (value < 1000) return count + 2;
+    if (value < 10000) return count + 3;
+    value /= 10000;
+    count += 4;
+  }
+}
+
+const std::uint64_t kPowerOfTen[] = {
+    1ULL, 10ULL, 100ULL, 1000ULL, 10000ULL, 100000ULL, 1000000ULL, 10000000ULL,
+    100000000ULL, 1000000000ULL, 10000000000ULL, 100000000000ULL,
+    1000000000000ULL, 10000000000000ULL, 100000000000000ULL,
+    1000000000000000ULL, 10000000000000000ULL, 100000000000000000ULL,
+    1000000000000000000ULL, 10000000000000000000ULL,
+};
+
+// 10^k(k = -348, -340, ..., 340)的64位近似值f * 2^e，f的最高位为1
+const std::uint64_t kCachedPowerF[] = {
+    0xfa8fd5a0081c0288ULL, 0xbaaee17fa23ebf76ULL, 0x8b16fb203055ac76ULL,
+    0xcf42894a5dce35eaULL, 0x9a6bb0aa55653b2dULL, 0xe61acf033d1a45dfULL,
+    0xab70fe17c79ac6caULL, 0xff77b1fcbebcdc4fULL, 0xbe5691ef416bd60cULL,
+    0x8dd01fad907ffc3cULL, 0xd3515c2831559a83ULL, 0x9d71ac8fada6c9b5ULL,
+    0xea9c227723ee8bcbULL, 0xaecc49914078536dULL, 0x823c12795db6ce57ULL,
+    0xc21094364dfb5637ULL, 0x9096ea6f3848984fULL, 0xd77485cb25823ac7ULL,
+    0xa086cfcd97bf97f4ULL, 0xef340a98172aace5ULL, 0xb23867fb2a35b28eULL,
+    0x84c8d4dfd2c63f3bULL, 0xc5dd44271ad3cdbaULL, 0x936b9fcebb25c996ULL,
+    0xdbac6c247d62a584ULL, 0xa3ab66580d5fdaf6ULL, 0xf3e2f893dec3f126ULL,
+    0xb5b5ada8aaff80b8ULL, 0x87625f056c7c4a8bULL, 0xc9bcff6034c13053ULL,
+    0x964e858c91ba2655ULL, 0xdff9772470297ebdULL, 0xa6dfbd9fb8e5b88fULL,
+    0xf8a95fcf88747d94ULL, 0xb94470938fa89bcfULL, 0x8a08f0f8bf0f156bULL,
+    0xcdb02555653131b6ULL, 0x993fe2c6d07b7facULL, 0xe45c10c42a2b3b06ULL,
+    0xaa242499697392d3ULL, 0xfd87b5f28300ca0eULL, 0xbce5086492111aebULL,
+    0x8cbccc096f5088ccULL, 0xd1b71758e219652cULL, 0x9c40000000000000ULL,
+    0xe8d4a51000000000ULL, 0xad78ebc5ac620000ULL, 0x813f3978f8940984ULL,
+    0xc097ce7bc90715b3ULL, 0x8f7e32ce7bea5c70ULL, 0xd5d238a4abe98068ULL,
+    0x9f4f2726179a2245ULL, 0xed63a231d4c4fb27ULL, 0xb0de65388cc8ada8ULL,
+    0x83c7088e1aab65dbULL, 0xc45d1df942711d9aULL, 0x924d692ca61be758ULL,
+    0xda01ee641a708deaULL, 0xa26da3999aef774aULL, 0xf209787bb47d6b85ULL,
+    0xb454e4a179dd1877ULL, 0x865b86925b9bc5c2ULL, 0xc83553c5c8965d3dULL,
+    0x952ab45cfa97a0b3ULL, 0xde469fbd99a05fe3ULL, 0xa59bc234db398c25ULL,
+    0xf6c69a72a3989f5cULL, 0xb7dcbf5354e9beceULL, 0x88fcf317f22241e2ULL,
+    0xcc20ce9bd35c78a5ULL, 0x98165af37b2153dfULL, 0xe2a0b5dc971f303aULL,
+    0xa8d9d1535ce3b396ULL, 0xfb9b7cd9a4a7443cULL, 0xbb764c4ca7a44410ULL,
+    0x8bab8eefb6409c1aULL, 0xd01fef10a657842cULL, 0x9b10a4e5e9913129ULL,
+    0xe7109bfba19c0c9dULL, 0xac2820d9623bf429ULL, 0x80444b5e7aa7cf85ULL,
+    0xbf21e44003acdd2dULL, 0x8e679c2f5e44ff8fULL, 0xd433179d9c8cb841ULL,
+    0x9e19db92b4e31ba9ULL, 0xeb96bf6ebadf77d9ULL, 0xaf87023b9bf0ee6bULL,
+};
+const short kCachedPowerE[] = {
+    -1220, -1193, -1166, -1140, -1113, -1087, -1060, -1034, -1007, -980, -954,
+    -927, -901, -874, -847, -821, -794, -768, -741, -715, -688, -661, -635,
+    -608, -582, -555, -529, -502, -475, -449, -422, -396, -369, -343, -316,
+    -289, -263, -236, -210, -183, -157, -130, -103, -77, -50, -24, 3, 30, 56,
+    83, 109, 136, 162, 189, 216, 242, 269, 295, 322, 348, 375, 402, 428, 455,
+    481, 508, 534, 561, 588, 614, 641, 667, 694, 720, 747, 774, 800, 827, 853,
+    880, 907, 933, 960, 986, 1013, 1039, 1066,
+};
+const int kMinCachedPower = -348;
+const int kCachedPowerStep = 8;
+
+// 浮点数f * 2^e，f为64位无符号整数，不含符号
+struct DiyFp {
+  DiyFp(std::uint64_t f, int e) : f(f), e(e) {}
+
+  explicit DiyFp(double value) {
+    std::uint64_t bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+    int biased_exponent = static_cast<int>((bits & kExponentMask) >> 52);
+    std::uint64_t significand = bits & kSignificandMask;
+    if (biased_exponent != 0) {
+      f = significand + kHiddenBit;
+      e = biased_exponent - kExponentBias;
+    } else {  // 非规格化数
+      f = significand;
+      e = 1 - kExponentBias;
+    }
+  }
+
+  DiyFp operator-(const DiyFp &rhs) const { return DiyFp(f - rhs.f, e); }
+
+  // 乘积的高64位(四舍五入)
+  DiyFp operator*(const DiyFp &rhs) const {
+#if defined(__SIZEOF_INT128__)
+    unsigned __int128 product = static_cast<unsigned __int128>(f) * rhs.f;
+    std::uint64_t high = static_cast<std::uint64_t>(product >> 64);
+    std::uint64_t low = static_cast<std::uint64_t>(product);
+    if (low & (std::uint64_t(1) << 63)) {
+      ++high;
+    }
+    return DiyFp(high, e + rhs.e + 64);
+#else
+    const std::uint64_t kMask32 = 0xFFFFFFFF;
+    std::uint64_t a = f >> 32;
+    std::uint64_t b = f & kMask32;
+    std::uint64_t c = rhs.f >> 32;
+    std::uint64_t d = rhs.f & kMask32;
+    std::uint64_t ac = a * c;
+    std::uint64_t bc = b * c;
+    std::uint64_t ad = a * d;
+    std::uint64_t bd = b * d;
+    std::uint64_t tmp = (bd >> 32) + (ad & kMask32) + (bc & kMask32);
+    tmp += std::uint64_t(1) << 31;  // 四舍五入
+    return DiyFp(ac + (ad >> 32) + (bc >> 32) + (tmp >> 32), e + rhs.e + 64);
+#endif
+  }
+
+  DiyFp Normalize() const {
+#if defined(__GNUC__)
+    int shift = __builtin_clzll(f);
+    return DiyFp(f << shift, e - shift);
+#else
+    DiyFp result = *this;
+    while ((result.f & (std::uint64_t(1) << 63)) == 0) {
+      result.f <<= 1;
+      --result.e;
+    }
+    return result;
+#endif
+  }
+
+  // 计算value与相邻浮点数的中点m-和m+，两者使用相同的指数
+  void NormalizedBoundaries(DiyFp *minus, DiyFp *plus) const {
+    DiyFp upper = DiyFp((f << 1) + 1, e - 1).Normalize();
+    // 尾数为2的幂时，与较小的相邻浮点数的距离减半
+    DiyFp lower = f == kHiddenBit ? DiyFp((f << 2) - 1, e - 2)
+                                  : DiyFp((f << 1) - 1, e - 1);
+    lower.f <<= lower.e - upper.e;
+    lower.e = upper.e;
+    *plus = upper;
+    *minus = lower;
+  }
+
+  static const std::uint64_t kExponentMask = 0x7FF0000000000000;
+  static const std::uint64_t kSignificandMask = 0x000FFFFFFFFFFFFF;
+  static const std::uint64_t kHiddenBit = 0x0010000000000000;
+  static const int kExponentBias = 0x3FF + 52;
+
+  std::uint64_t f;
+  int e;
+};
+
+// 选择缓存的10的幂次c = 10^-k，使c * 2^e的指数位于[-60, -32]
+DiyFp GetCachedPower(int e, int *k) {
+  // log10(2) = 0.30102999566398114
+  double dk = (-61 - e) * 0.30102999566398114 - kMinCachedPower - 1;
+  int estimate = static_cast<int>(dk);
+  if (dk - estimate > 0.0) {
+    ++estimate;
+  }
+  unsigned index = static_cast<unsigned>((estimate >> 3) + 1);
+  *k = -(kMinCachedPower + static_cast<int>(index) * kCachedPowerStep);
+  return DiyFp(kCachedPowerF[index], kCachedPowerE[index]);
+}
+
+// 在允许的范围内，把最后一位数字调整到最接近精确值的位置
+void GrisuRound(char *buffer, int length, std::uint64_t delta,
+                std::uint64_t rest, std::uint64_t ten_kappa,
+                std::uint64_t distance) {
+  while (rest < distance && delta - rest >= ten_kappa &&
+         (rest + ten_kappa < distance ||
+          distance - rest > rest + ten_kappa - distance)) {
+    --buffer[length - 1];
+    rest += ten_kappa;
+  }
+}
+
+// 生成W的各位数字，直到结果落在[Mp - delta, Mp]之内
+void DigitGen(const DiyFp &w, const DiyFp &mp, std::uint64_t delta,
+              char *buffer, int *length, int *k) {
+  const DiyFp one(std::uint64_t(1) << -mp.e, mp.e);
+  const DiyFp distance = mp - w;
+  std::uint32_t integer = static_cast<std::uint32_t>(mp.f >> -one.e);
+  std::uint64_t fraction = mp.f & (one.f - 1);
+  int kappa = CountDigits(integer);
+  *length = 0;
+
+  // 整数部分
+  while (kappa > 0) {
+    std::uint32_t divisor = static_cast<std::uint32_t>(kPowerOfTen[kappa - 1]);
+    std::uint32_t digit = integer / divisor;
+    integer %= divisor;
+    if (digit != 0 || *length != 0) {
+      buffer[(*length)++] = static_cast<char>('0' + digit);
+    }
+    --kappa;
+    std::uint64_t rest =
+        (static_cast<std::uint64_t>(integer) << -one.e) + fraction;
+    if (rest <= delta) {
+      *k += kappa;
+      GrisuRound(buffer, *length, delta, rest, kPowerOfTen[kappa] << -one.e,
+                 distance.f);
+      return;
+    }
+  }
+
+  // 小数部分
+  for (;;) {
+    fraction *= 10;
+    delta *= 10;
+    char digit = static_cast<char>(fraction >> -one.e);
+    if (digit != 0 || *length != 0) {
+      buffer[(*length)++] = static_cast<char>('0' + digit);
+    }
+    fraction &= one.f - 1;
+    --kappa;
+    if (fraction < delta) {
+      *k += kappa;
+      int index = -kappa;
+      GrisuRound(buffer, *length, delta, fraction, one.f,
+                 distance.f * (index < 20 ? kPowerOfTen[index] : 0));
+      return;
+    }
+  }
+}
+
+// 生成value(> 0)能够精确还原的数字串，value = buffer * 10^k
+// 收缩区间后个别值不是最短的，但总位于舍入区间内
+void Grisu2(double value, char *buffer, int *length, int *k) {
+  const DiyFp v(value);
+  DiyFp minus(0, 0);
+  DiyFp plus(0, 0);
+  v.NormalizedBoundaries(&minus, &plus);
+
+  const DiyFp cached = GetCachedPower(plus.e, k);
+  const DiyFp w = v.Normalize() * cached;
+  DiyFp w_plus = plus * cached;
+  DiyFp w_minus = minus * cached;
+  // 乘法有误差，收缩一个单位以保证结果位于区间内
+  ++w_minus.f;
+  --w_plus.f;
+  DigitGen(w, w_plus, w_plus.f - w_minus.f, buffer, length, k);
+}
+
+char *WriteExponent(int exponent, char *buffer) {
+  if (exponent < 0) {
+    *buffer++ = '-';
+    exponent = -exponent;
+  }
+  int count = CountDigits(static_cast<std::uint64_t>(exponent));
+  WriteDigits(static_cast<std::uint64_t>(exponent), buffer + count);
+  return buffer + count;
+}
+
+// 把数字串buffer[0, length) * 10^k排版为最终形式
+char *Prettify(char *buffer, int length, int k) {
+  const int kk = length + k;  // 10^(kk - 1) <= value < 10^kk
+  if (k >= 0 && kk <= 21) {
+    // 1234e7 -> 12340000000.0
+    for (int i = length; i < kk; ++i) {
+      buffer[i] = '0';
+    }
+    buffer[kk] = '.';
+    buffer[kk + 1] = '0';
+    return buffer + kk + 2;
+  }
+  if (kk > 0 && kk <= 21) {
+    // 1234e-2 -> 12.34
+    std::memmove(buffer + kk + 1, buffer + kk, length - kk);
+    buffer[kk] = '.';
+    return buffer + length + 1;
+  }
+  if (kk > -6 && kk <= 0) {
+    // 1234e-6 -> 0.001234
+    const int offset = 2 - kk;
+    std::memmove(buffer + offset, buffer, length);
+    buffer[0] = '0';
+    buffer[1] = '.';
+    for (int i = 2; i < offset; ++i) {
+      buffer[i] = '0';
+    }
+    return buffer + length + offset;
+  }
+  if (length == 1) {
+    // 1e30
+    buffer[1] = 'e';
+    return WriteExponent(kk - 1, buffer + 2);
+  }
+  // 1234e30 -> 1.234e33
+  std::memmove(buffer + 2, buffer + 1, length - 1);
+  buffer[1] = '.';
+  buffer[length + 1] = 'e';
+  return WriteExponent(kk - 1, buffer + length + 2);
+}
+
+}  // namespace
+
+char *WriteInteger(long long value, char *buffer) {
+  std::uint64_t magnitude = static_cast<std::uint64_t>(value);
+  if (value < 0) {
+    *buffer++ = '-';
+    magnitude = 0 - magnitude;
+  }
+  return WriteUnsigned(magnitude, buffer);
+}
+
+char *WriteUnsigned(unsigned long long value, char *buffer) {
+  int count = CountDigits(value);
+  WriteDigits(value, buffer + count);
+  return buffer + count;
+}
+
+char *WriteDouble(double value, char *buffer) {
+  // NaN和无穷大
+  if (value != value || value - value != 0) {
+    std::memcpy(buffer, "null", 4);
+    return buffer + 4;
+  }
+
+  std::uint64_t bits;
+  std::memcpy(&bits, &value, sizeof(bits));
+  if (bits >> 63) {
+    *buffer++ = '-';
+    value = -value;
+  }
+  if (value == 0) {
+    std::memcpy(buffer, "0.0", 3);
+    return buffer + 3;
+  }
+
+  int length = 0;
+  int k = 0;
+  Grisu2(value, buffer, &length, &k);
+  return Prettify(buffer, length, k);
+}
+
+}  // namespace number
+}  // namespace jsoncpp
+}  // namespace jiayuancs
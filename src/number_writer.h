@@ -0,0 +1,32 @@
+// 数字的序列化(库内部使用)
+
+#ifndef JSONCPP_SRC_NUMBER_WRITER_H_
+#define JSONCPP_SRC_NUMBER_WRITER_H_
+
+namespace jiayuancs {
+namespace jsoncpp {
+namespace number {
+
+// 输出缓冲区的最小长度
+const int kMaxNumberLength = 32;
+
+// 以下函数将数字写入buffer(不添加'\0')，返回写入的最后一个字符之后的位置
+// 输出与locale无关
+
+// 十进制整数
+char *WriteInteger(long long value, char *buffer);
+// 十进制无符号整数
+char *WriteUnsigned(unsigned long long value, char *buffer);
+
+// 能够精确还原value的十进制表示(Grisu2算法)，通常也是最短的表示，
+// 少数值会多出一位数字，但重新解析后仍得到相同的double
+// 整数值也带有小数部分(如1.0)，以便重新解析时仍得到double类型
+// 绝对值位于[1e-6, 1e21)时使用小数形式，否则使用科学计数法(如1e30、1.5e-8)
+// JSON无法表示NaN和无穷大，这些值写为null
+char *WriteDouble(double value, char *buffer);
+
+}  // namespace number
+}  // namespace jsoncpp
+}  // namespace jiayuancs
+
+#endif  // JSONCPP_SRC_NUMBER_WRITER_H_
@@ -0,0 +1,86 @@
+#include "object_key.h"
+
+#include <limits>
+#include <stdexcept>
+
+#include "stats.h"
+
+namespace jiayuancs {
+namespace jsoncpp {
+
+static_assert(sizeof(ObjectKey) <= 16, "ObjectKey should fit in 16 bytes");
+
+ObjectKey::ObjectKey(const ObjectKey &other) {
+  if (other.tag() == kHeap) {
+    Assign(other.pointer_.data, other.pointer_.size);
+  } else {
+    std::memcpy(static_cast<void *>(this), &other, sizeof(ObjectKey));
+  }
+}
+
+ObjectKey::ObjectKey(ObjectKey &&other) noexcept {
+  std::memcpy(static_cast<void *>(this), &other, sizeof(ObjectKey));
+  other.inline_.tag = kInline;
+  other.inline_.size = 0;
+}
+
+ObjectKey &ObjectKey::operator=(const ObjectKey &other) {
+  if (this != &other) {
+    ObjectKey copy(other);
+    *this = std::move(copy);
+  }
+  return *this;
+}
+
+ObjectKey &ObjectKey::operator=(ObjectKey &&other) noexcept {
+  if (this != &other) {
+    Release();
+    std::memcpy(static_cast<void *>(this), &other, sizeof(ObjectKey));
+    other.inline_.tag = kInline;
+    other.inline_.size = 0;
+  }
+  return *this;
+}
+
+ObjectKey ObjectKey::FromInterned(const std::string &interned) {
+  if (interned.size() > std::numeric_limits<std::uint32_t>::max()) {
+    throw std::logic_error("function ObjectKey::FromInterned() key too long");
+  }
+  ObjectKey key;
+  key.pointer_.tag = kInterned;
+  key.pointer_.size = static_cast<std::uint32_t>(interned.size());
+  key.pointer_.data = interned.data();
+  return key;
+}
+
+void ObjectKey::Assign(const char *data, std::size_t size) {
+  if (size <= kInlineCapacity) {
+    inline_.tag = kInline;
+    inline_.size = static_cast<unsigned char>(size);
+    std::memcpy(inline_.data, data, size);
+    return;
+  }
+  if (size > std::numeric_limits<std::uint32_t>::max()) {
+    throw std::logic_error("function ObjectKey::ObjectKey() key too long");
+  }
+  char *buffer = new char[size];
+  std::memcpy(buffer, data, size);
+#ifdef JSONCPP_STATS
+  NotifyAllocate(size);
+#endif  // JSONCPP_STATS
+  pointer_.tag = kHeap;
+  pointer_.size = static_cast<std::uint32_t>(size);
+  pointer_.data = buffer;
+}
+
+void ObjectKey::Release() {
+  if (tag() == kHeap) {
+#ifdef JSONCPP_STATS
+    NotifyDeallocate(pointer_.size);
+#endif  // JSONCPP_STATS
+    delete[] pointer_.data;
+  }
+}
+
+}  // namespace jsoncpp
+}  // namespace jiayuancs
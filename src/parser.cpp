@@ -1,30 +1,322 @@
 #include "parser.h"
 
+#include <algorithm>
+#include <atomic>
+#include <cmath>
 #include <cstring>
+#include <exception>
+#include <iterator>
+#include <sstream>
+#include <stdexcept>
+#include <system_error>
+#include <thread>
+#include <utility>
+
+#include "dom_builder.h"
+#include "mapped_file.h"
+#include "number_parser.h"
+#include "scanner.h"
+#include "stats_collector.h"
+#include "structural_index.h"
+#include "utf8.h"
 
 namespace jiayuancs {
 namespace jsoncpp {
 
-Parser::~Parser() {
-  if (need_delete_) {
-    delete in_str_;
+namespace {
+
+// 并行解析时，由一个线程解析的一组相邻元素
+struct ElementRange {
+  const char *begin;  // 第一个元素的起始位置
+  const char *end;    // 最后一个元素之后的位置(不含之后的逗号)
+  std::size_t count;  // 元素个数
+};
+
+// 输入小于该值时并行解析的收益抵不过线程开销
+const std::size_t kMinParallelSize = 1 << 20;
+// 每组元素的最小字节数
+const std::size_t kMinRangeSize = 64 << 10;
+
+// cur指向顶层容器的起始括号之后，按括号和字符串边界找出深度为1的元素，
+// 将相邻元素按大约target_size字节分组存入ranges。
+// 成功时返回结束括号的位置；不校验元素内容，结构明显不合法时返回nullptr，
+// 由串行解析报告错误
+const char *SplitElements(const char *cur, const char *end, bool is_object,
+                          std::size_t target_size,
+                          std::vector<ElementRange> &ranges) {
+  const char close = is_object ? '}' : ']';
+  cur = scanner::SkipSpace(cur, end);
+  if (cur != end && *cur == close) {
+    return cur;
   }
+
+  ElementRange range = {cur, cur, 0};
+  for (;;) {
+    if (is_object) {
+      if (cur == end || *cur != '\"') {
+        return nullptr;
+      }
+      cur = scanner::SkipString(cur + 1, end);
+      if (cur == nullptr) {
+        return nullptr;
+      }
+      cur = scanner::SkipSpace(cur, end);
+      if (cur == end || *cur != ':') {
+        return nullptr;
+      }
+      cur = scanner::SkipSpace(cur + 1, end);
+    }
+    const char *value_end = scanner::SkipValue(cur, end);
+    if (value_end == nullptr || value_end == cur) {
+      return nullptr;
+    }
+    ++range.count;
+    range.end = value_end;
+
+    cur = scanner::SkipSpace(value_end, end);
+    if (cur == end) {
+      return nullptr;
+    }
+    if (*cur == close) {
+      ranges.push_back(range);
+      return cur;
+    }
+    if (*cur != ',') {
+      return nullptr;
+    }
+    cur = scanner::SkipSpace(cur + 1, end);
+    if (static_cast<std::size_t>(range.end - range.begin) >= target_size) {
+      ranges.push_back(range);
+      range = {cur, cur, 0};
+    }
+  }
+}
+
+}  // namespace
+
+Parser::Parser(const char *str) : Parser(str, std::strlen(str)) {}
+
+Parser::Parser(std::string &&str)
+    : buffer_(std::move(str)),
+      begin_(buffer_.data()),
+      cur_(begin_),
+      end_(begin_ + buffer_.size()) {}
+
+Parser::Parser(std::istream &is)
+    : buffer_(std::istreambuf_iterator<char>(is),
+              std::istreambuf_iterator<char>()),
+      begin_(buffer_.data()),
+      cur_(begin_),
+      end_(begin_ + buffer_.size()) {}
+
+Json Parser::ParseFile(const std::string &path) {
+  MappedFile file(path);
+  file.AdviseSequential();
+  return Parser(file.Data(), file.Size()).Parse();
+}
+
+Json Parser::ParseFile(const std::string &path, Arena &arena) {
+  MappedFile file(path);
+  file.AdviseSequential();
+  return Parser(file.Data(), file.Size()).Parse(arena);
+}
+
+void Parser::UseStructuralIndex() {
+  if (static_cast<std::size_t>(end_ - begin_) > UINT32_MAX) {
+    return;
+  }
+  BuildStructuralIndex(begin_, end_ - begin_, indexes_);
+  indexes_.push_back(static_cast<std::uint32_t>(end_ - begin_));
+  next_structural_ = indexes_.data();
+  use_index_ = true;
+  SyncIndex();
+}
+
+void Parser::SyncIndex() {
+  if (!use_index_) {
+    return;
+  }
+  std::uint32_t offset = static_cast<std::uint32_t>(cur_ - begin_);
+  // 不越过末尾的哨兵
+  const std::uint32_t *sentinel = &indexes_.back();
+  next_structural_ = std::lower_bound(next_structural_, sentinel, offset);
 }
 
 Json Parser::Parse() {
+  Json root;
+  DomBuilder builder(root, nullptr);
+  ParseRoot(builder, nullptr);
+  return root;
+}
+
+Json Parser::Parse(Arena &arena) {
+  Json root;
+  DomBuilder builder(root, &arena);
+  ParseRoot(builder, nullptr);
+  return root;
+}
+
+void Parser::Parse(Handler &handler) { ParseRoot(handler, nullptr); }
+
+Json Parser::Parse(const Projection &projection) {
+  Json root;
+  DomBuilder builder(root, nullptr);
+  ParseRoot(builder, &projection.root_);
+  return root;
+}
+
+void Parser::Parse(const Projection &projection, Handler &handler) {
+  ParseRoot(handler, &projection.root_);
+}
+
+Json Parser::ParseParallel(unsigned threads) {
+  if (threads == 0) {
+    threads = std::max(1u, std::thread::hardware_concurrency());
+  }
+  const char *start = scanner::SkipSpace(cur_, end_);
+  std::size_t size = static_cast<std::size_t>(end_ - start);
+  if (threads == 1 || size < kMinParallelSize ||
+      (*start != '[' && *start != '{')) {
+    return Parse();
+  }
+#ifdef JSONCPP_STATS
+  // 统计信息按解析器累加，并行解析的各线程无法共享
+  if (stats_ != nullptr) {
+    return Parse();
+  }
+#endif  // JSONCPP_STATS
+#ifdef JSONCPP_TRACE
+  // token须按读取顺序交给tracer
+  if (tracer_ != nullptr) {
+    return Parse();
+  }
+#endif  // JSONCPP_TRACE
+
+  // 每个线程平均分到若干组，便于均衡负载
+  const bool is_object = *start == '{';
+  std::vector<ElementRange> ranges;
+  const char *close =
+      SplitElements(start + 1, end_, is_object,
+                    std::max(size / (threads * 4), kMinRangeSize), ranges);
+  if (close == nullptr || ranges.size() < 2) {
+    return Parse();
+  }
+
+  std::vector<Json> parts(ranges.size());
+  std::atomic<std::size_t> next_range(0);
+  std::atomic<bool> failed(false);
+  auto worker = [&]() {
+    for (std::size_t i = next_range++; i < ranges.size() && !failed;
+         i = next_range++) {
+      try {
+        Parser parser(ranges[i].begin, ranges[i].end - ranges[i].begin);
+        DomBuilder builder(parts[i], nullptr);
+        parser.ParseElementRange(builder, is_object, ranges[i].count);
+      } catch (const std::exception &) {
+        failed = true;
+      }
+    }
+  };
+
+  std::vector<std::thread> workers;
+  for (unsigned i = 1; i < threads && i < ranges.size(); ++i) {
+    try {
+      workers.emplace_back(worker);
+    } catch (const std::system_error &) {
+      // 无法创建更多线程时用已有的线程继续
+      break;
+    }
+  }
+  worker();
+  for (std::thread &thread : workers) {
+    thread.join();
+  }
+
+  if (failed) {
+    // 重新串行解析，得到与Parse()相同的错误信息
+    return Parse();
+  }
+
+  // 按输入顺序拼接各组的结果
+  Json root = std::move(parts[0]);
+  if (is_object) {
+    Json::ObjectType &object = root.GetObject();
+    for (std::size_t i = 1; i < parts.size(); ++i) {
+      // 重复的key以最后一次出现的值为准，与串行解析相同
+      for (auto &member : parts[i].GetObject()) {
+        object[member.first] = std::move(member.second);
+      }
+    }
+  } else {
+    Json::ArrayType &array = root.GetArray();
+    std::size_t total = 0;
+    for (const ElementRange &range : ranges) {
+      total += range.count;
+    }
+    array.reserve(total);
+    for (std::size_t i = 1; i < parts.size(); ++i) {
+      for (Json &element : parts[i].GetArray()) {
+        array.push_back(std::move(element));
+      }
+    }
+  }
+  cur_ = close + 1;
+  SyncIndex();
+  return root;
+}
+
+template <typename HandlerType>
+void Parser::ParseRoot(HandlerType &handler, const Projection::Node *node) {
+  // 跳过未选中的值时按括号和字符串边界扫描，对非法输入的判断可能与索引
+  // 不一致，因此投影解析时不使用索引
+  if (node != nullptr) {
+    use_index_ = false;
+  }
+#ifdef JSONCPP_STATS
+  if (stats_ != nullptr) {
+    const char *start = cur_;
+    StatsCollector<HandlerType> collector(handler, *stats_);
+    ParseSelected(collector, node);
+    stats_->bytes_consumed += static_cast<std::size_t>(cur_ - start);
+    return;
+  }
+#endif  // JSONCPP_STATS
+  ParseSelected(handler, node);
+}
+
+template <typename HandlerType>
+void Parser::ParseSelected(HandlerType &handler, const Projection::Node *node) {
+  if (node == nullptr) {
+    ParseValue(handler);
+  } else if (Selects(node)) {
+    ParseProjected(handler, *node);
+  } else {
+    SkipUnselected();
+  }
+}
+
+template <typename HandlerType>
+void Parser::ParseValue(HandlerType &handler) {
   int token = GetNextToken();
   switch (token) {
     case 'n':
-      in_str_->putback(token);
-      return ParseNull();
+      --cur_;
+      ParseNull();
+      handler.OnNull();
+      return;
     case 't':
-      in_str_->putback(token);
-      return ParseBool(true);
+      --cur_;
+      ParseBool(true);
+      handler.OnBool(true);
+      return;
     case 'f':
-      in_str_->putback(token);
-      return ParseBool(false);
+      --cur_;
+      ParseBool(false);
+      handler.OnBool(false);
+      return;
     case '-':
-      return ParseNumber(false);
+      ParseNumber(false, handler);
+      return;
     case '0':
     case '1':
     case '2':
@@ -35,14 +327,19 @@ Json Parser::Parse() {
     case '7':
     case '8':
     case '9':
-      in_str_->putback(token);
-      return ParseNumber(true);
+      --cur_;
+      ParseNumber(true, handler);
+      return;
     case '\"':
-      return Json(ParseString());
+      ParseString();
+      handler.OnString(string_buffer_);
+      return;
     case '[':
-      return ParseArray();
+      ParseArray(handler);
+      return;
     case '{':
-      return ParseObject();
+      ParseObject(handler);
+      return;
     case EOF:
       ThrowError("expected more characters, but got eof");
     default:
@@ -50,229 +347,413 @@ Json Parser::Parse() {
   }
 
   ThrowError("unexpected character ", token);
-  return Json();
 }
 
-void Parser::SkipSpace() {
-  char tmp = ' ';
-  while (in_str_->get(tmp)) {
-    if (tmp == ' ' || tmp == '\t' || tmp == '\n' || tmp == '\r') {
-      // 记录行号，便于排错
-      if (tmp == '\n') {
-        ++line_no_;
-      }
-    } else {
-      in_str_->putback(tmp);
-      break;
-    }
-  }
+std::size_t Parser::LineNo() const {
+  return first_line_no_ + std::count(begin_, cur_, '\n');
 }
 
 void Parser::ThrowError(const char *info_str) {
   std::ostringstream error_info;
-  error_info << "syntax error in line " << line_no_ << ": " << info_str;
+  error_info << "syntax error in line " << LineNo() << ": " << info_str;
+#ifdef JSONCPP_TRACE
+  if (tracer_ != nullptr) {
+    tracer_->OnError(static_cast<std::size_t>(cur_ - begin_),
+                     error_info.str());
+  }
+#endif  // JSONCPP_TRACE
   throw std::logic_error(error_info.str());
 }
 
 void Parser::ThrowError(const char *info_str, const char value) {
-  std::ostringstream error_info;
-  error_info << "syntax error in line " << line_no_ << ": " << info_str << "\""
-             << value << "\"";
-  throw std::logic_error(error_info.str());
+  std::string info = std::string(info_str) + '"' + value + '"';
+  ThrowError(info.c_str());
 }
 
 void Parser::ThrowError(const char *info_str, const char *value) {
-  std::ostringstream error_info;
-  error_info << "syntax error in line " << line_no_ << ": " << info_str
-             << value;
-  throw std::logic_error(error_info.str());
+  std::string info = std::string(info_str) + value;
+  ThrowError(info.c_str());
 }
 
-Json Parser::ParseNull() {
-  char buf[5] = {0};
-  in_str_->read(buf, 4);
-  buf[4] = '\0';
-  if (strcmp(buf, "null") == 0) {
-    return Json();
+void Parser::ParseNull() {
+  if (end_ - cur_ >= 4 && std::memcmp(cur_, "null", 4) == 0) {
+    cur_ += 4;
+    return;
   }
 
-  ThrowError("expected null, but was ", buf);
-  return Json();
+  std::string buf(cur_, std::min<std::ptrdiff_t>(end_ - cur_, 4));
+  ThrowError("expected null, but was ", buf.c_str());
 }
 
-Json Parser::ParseBool(bool value) {
-  char buf[6] = {0};
-  if (value) {
-    in_str_->read(buf, 4);
-    buf[4] = '\0';
-    if (strcmp(buf, "true") == 0) {
-      return Json(true);
-    }
-  } else {
-    in_str_->read(buf, 5);
-    buf[5] = '\0';
-    if (strcmp(buf, "false") == 0) {
-      return Json(false);
-    }
+void Parser::ParseBool(bool value) {
+  const char *target = value ? "true" : "false";
+  std::ptrdiff_t length = value ? 4 : 5;
+  if (end_ - cur_ >= length && std::memcmp(cur_, target, length) == 0) {
+    cur_ += length;
+    return;
   }
 
-  ThrowError("expected bool value (true or false), but was ", buf);
-  return Json();
+  std::string buf(cur_, std::min(end_ - cur_, length));
+  ThrowError("expected bool value (true or false), but was ", buf.c_str());
 }
 
-Json Parser::ParseNumber(bool positive) {
-  int token = EOF;
-  long long numerator = 0;    // 分子数值
-  long long denominator = 1;  // 分母数值
-  long long sign = positive ? 1 : -1;
-  bool dot_flag = false;     // 是否已读取到小数点
-  bool number_char = false;  // 是否读取到数字字符
+template <typename HandlerType>
+void Parser::ParseNumber(bool positive, HandlerType &handler) {
+  number::Number number;
+  const char *number_end = number::ParseNumber(cur_, end_, !positive, number);
+  if (number_end == nullptr) {
+    ThrowError("invalid number");
+  }
+  cur_ = number_end;
 
-  while ((token = in_str_->get()) &&
-         (token >= '0' && token <= '9' || token == '.')) {
-    if (token == '.') {
-      if (dot_flag == true) {  // 多次出现小数点，数字不合法
-        ThrowError("invalid number");
+  if (number.is_integer) {
+    handler.OnInt(number.integer);
+    return;
+  }
+  if (std::isinf(number.double_value)) {
+    ThrowError("number out of range");
+  }
+  handler.OnDouble(number.double_value);
+}
+
+unsigned Parser::ParseHex4() {
+  if (end_ - cur_ < 4) {
+    ThrowError("invalid unicode escape");
+  }
+  unsigned value = 0;
+  for (int i = 0; i < 4; ++i) {
+    char ch = *cur_++;
+    value <<= 4;
+    if (ch >= '0' && ch <= '9') {
+      value |= ch - '0';
+    } else if (ch >= 'a' && ch <= 'f') {
+      value |= ch - 'a' + 10;
+    } else if (ch >= 'A' && ch <= 'F') {
+      value |= ch - 'A' + 10;
+    } else {
+      ThrowError("invalid unicode escape");
+    }
+  }
+  return value;
+}
+
+void Parser::ParseString() {
+  std::string &str_value = string_buffer_;
+  const char *close = use_index_ ? begin_ + *next_structural_ : end_;
+  if (close != end_) {
+    // 启用索引时下一个结构位置即为结束引号，不含转义字符时整段复制，
+    // 否则仍逐字节解码到同一位置。未结束的字符串之后只有哨兵，逐字节解析
+    // 以报告错误
+    ++next_structural_;
+    if (std::find(cur_, close, '\\') == close) {
+      str_value.assign(cur_, close);
+      cur_ = close + 1;
+      return;
+    }
+  }
+  str_value.clear();
+  for (;;) {
+    // 整段复制不含引号和转义字符的连续片段
+    const char *run = cur_;
+    while (cur_ != end_ && *cur_ != '\"' && *cur_ != '\\') {
+      ++cur_;
+    }
+    str_value.append(run, cur_);
+
+    if (cur_ == end_) {
+      break;
+    }
+    if (*cur_++ == '\"') {
+      return;
+    }
+
+    // 转义字符
+    if (cur_ == end_) {
+      break;
+    }
+    char token = *cur_++;
+#ifdef JSONCPP_STATS
+    if (stats_ != nullptr) {
+      ++stats_->escape_count;
+    }
+#endif  // JSONCPP_STATS
+    switch (token) {
+      case '\"':
+        str_value += '\"';
+        break;
+      case '\\':
+        str_value += '\\';
+        break;
+      case '/':
+        str_value += '/';
+        break;
+      case 'b':
+        str_value += '\b';
+        break;
+      case 'f':
+        str_value += '\f';
+        break;
+      case 'n':
+        str_value += '\n';
+        break;
+      case 'r':
+        str_value += '\r';
+        break;
+      case 't':
+        str_value += '\t';
+        break;
+      case 'u': {
+        unsigned code_point = ParseHex4();
+        if (code_point >= 0xD800 && code_point <= 0xDBFF) {
+          // UTF-16代理对，后面必须紧跟低位代理
+          if (end_ - cur_ < 2 || cur_[0] != '\\' || cur_[1] != 'u') {
+            ThrowError("invalid unicode surrogate pair");
+          }
+          cur_ += 2;
+          unsigned low = ParseHex4();
+          if (low < 0xDC00 || low > 0xDFFF) {
+            ThrowError("invalid unicode surrogate pair");
+          }
+          code_point =
+              0x10000 + ((code_point - 0xD800) << 10) + (low - 0xDC00);
+        } else if (code_point >= 0xDC00 && code_point <= 0xDFFF) {
+          ThrowError("invalid unicode surrogate pair");
+        }
+        AppendUtf8(code_point, str_value);
+        break;
       }
-      dot_flag = true;
-      continue;
+      default:
+        str_value += token;
+        break;
     }
+  }
 
-    numerator *= 10;
-    numerator += token - '0';
-    if (dot_flag) {
-      denominator *= 10;
+  ThrowError("invalid string");
+}
+
+template <typename HandlerType>
+void Parser::EmitKey(HandlerType &handler) {
+  if (key_pool_ != nullptr) {
+    const std::string *key = key_pool_->Intern(string_buffer_);
+    // 驻留表已满时退回到未驻留的key
+    if (key != nullptr) {
+      handler.OnInternedKey(*key);
+      return;
     }
-    number_char = true;
   }
+  handler.OnKey(string_buffer_);
+}
 
-  if (token != EOF) {
-    in_str_->putback(token);
+template <typename HandlerType>
+void Parser::ParseArray(HandlerType &handler) {
+  handler.OnStartArray();
+
+  int token = GetNextToken();
+  if (token == ']') {
+    handler.OnEndArray();
+    return;
   }
 
-  if (!number_char) {  // 未读取到数字字符
-    ThrowError("invalid number");
+  if (token != EOF) {
+    UngetToken();
   }
 
-  numerator *= sign;
-  if (dot_flag) {  // 浮点数
-    // C语言风格的强制类型转换
-    // return Json((double)numerator / (double)denominator);
-    return Json(static_cast<double>(numerator) / denominator);
+  for (;;) {
+    ParseValue(handler);
+
+    token = GetNextToken();
+
+    if (token == ']') {
+      break;
+    }
+
+    if (token != ',') {
+      ThrowError("invalid array");
+    }
   }
-  return Json(numerator);  // 整数
+
+  handler.OnEndArray();
 }
 
-std::string Parser::ParseString() {
-  int token = EOF;
-  bool valid = false;
-  std::string str_value = "";
-  while ((token = in_str_->get()) != EOF) {
-    if (token == '\"') {
-      valid = true;
+template <typename HandlerType>
+void Parser::ParseObject(HandlerType &handler) {
+  handler.OnStartObject();
+
+  int token = GetNextToken();
+  if (token == '}') {
+    handler.OnEndObject();
+    return;
+  }
+
+  if (token != EOF) {
+    UngetToken();
+  }
+
+  for (;;) {
+    ParseMember(handler);
+
+    token = GetNextToken();
+    if (token == '}') {
       break;
     }
+    if (token != ',') {
+      ThrowError("expected \',\' in object");
+    }
+  }
 
-    if (token != '\\') {
-      str_value += token;
-    } else {  // 转义字符
-      token = in_str_->get();
-      switch (token) {
-        case '\"':
-          str_value += "\"";
-          break;
-        case '\\':
-          str_value += "\\";
-          break;
-        case '/':
-          str_value += "/";
-          break;
-        case 'b':
-          str_value += "\b";
-          break;
-        case 'f':
-          str_value += "\f";
-          break;
-        case 'n':
-          str_value += "\n";
-          break;
-        case 'r':
-          str_value += "\r";
-          break;
-        case 't':
-          str_value += "\t";
-          break;
-        case 'u':
-          // TODO: 处理JSON数据中的\u转义字符
-          ThrowError("this escape character is not currently supported");
-          break;
-        default:
-          str_value += token;
-          break;
-      }
+  handler.OnEndObject();
+}
+
+template <typename HandlerType>
+void Parser::ParseMember(HandlerType &handler) {
+  if (GetNextToken() != '\"') {
+    ThrowError("expected \'\"\' in object");
+  }
+
+  // 解析key
+  ParseString();
+
+  if (GetNextToken() != ':') {
+    ThrowError("expected \':\' in object");
+  }
+  EmitKey(handler);
+
+  // 解析value
+  ParseValue(handler);
+}
+
+template <typename HandlerType>
+void Parser::ParseElementRange(HandlerType &handler, bool is_object,
+                               std::size_t count) {
+  if (is_object) {
+    handler.OnStartObject();
+  } else {
+    handler.OnStartArray();
+  }
+  for (std::size_t i = 0; i < count; ++i) {
+    if (i != 0 && GetNextToken() != ',') {
+      ThrowError("expected \',\'");
     }
+    if (is_object) {
+      ParseMember(handler);
+    } else {
+      ParseValue(handler);
+    }
+  }
+  if (GetNextToken() != EOF) {
+    ThrowError("expected \',\'");
+  }
+  if (is_object) {
+    handler.OnEndObject();
+  } else {
+    handler.OnEndArray();
+  }
+}
+
+bool Parser::Selects(const Projection::Node *node) {
+  if (node == nullptr) {
+    return false;
   }
+  if (node->all) {
+    return true;
+  }
+  // 路径尚未结束，只有容器才可能含有选中的值
+  SkipSpace();
+  return cur_ != end_ && (*cur_ == '[' || *cur_ == '{');
+}
 
-  if (valid) {
-    return str_value;
+void Parser::SkipUnselected() {
+  SkipSpace();
+  const char *value_end = scanner::SkipValue(cur_, end_);
+  if (value_end == nullptr) {
+    cur_ = end_;
+    ThrowError("expected more characters, but got eof");
+  }
+  if (value_end == cur_) {
+    ThrowError("unexpected character ", *cur_);
   }
+  cur_ = value_end;
+  SyncIndex();
+}
 
-  ThrowError("invalid string");
-  return "";
+template <typename HandlerType>
+void Parser::ParseProjected(HandlerType &handler,
+                            const Projection::Node &node) {
+  if (node.all) {
+    ParseValue(handler);
+  } else if (GetNextToken() == '[') {
+    ParseProjectedArray(handler, node);
+  } else {
+    ParseProjectedObject(handler, node);
+  }
 }
 
-Json Parser::ParseArray() {
-  int token = GetNextToken();
+template <typename HandlerType>
+void Parser::ParseProjectedArray(HandlerType &handler,
+                                 const Projection::Node &node) {
+  handler.OnStartArray();
 
-  Json json_array = Json(Json::kArray);
+  int token = GetNextToken();
   if (token == ']') {
-    return json_array;
+    handler.OnEndArray();
+    return;
   }
 
-  in_str_->putback(token);
+  if (token != EOF) {
+    UngetToken();
+  }
 
-  for (int idx = 0;; ++idx) {
-    json_array[idx] = Parse();
+  for (std::size_t index = 0;; ++index) {
+    const Projection::Node *child = node.Element(index);
+    if (Selects(child)) {
+      ParseProjected(handler, *child);
+    } else {
+      SkipUnselected();
+    }
 
     token = GetNextToken();
-
     if (token == ']') {
       break;
     }
-
     if (token != ',') {
       ThrowError("invalid array");
     }
   }
 
-  return json_array;
+  handler.OnEndArray();
 }
 
-Json Parser::ParseObject() {
-  int token = GetNextToken();
+template <typename HandlerType>
+void Parser::ParseProjectedObject(HandlerType &handler,
+                                  const Projection::Node &node) {
+  handler.OnStartObject();
 
-  Json json_object = Json(Json::kObject);
+  int token = GetNextToken();
   if (token == '}') {
-    return json_object;
+    handler.OnEndObject();
+    return;
   }
 
-  in_str_->putback(token);
+  if (token != EOF) {
+    UngetToken();
+  }
 
-  std::string key;
   for (;;) {
-    if ((token = GetNextToken()) != '\"') {
+    if (GetNextToken() != '\"') {
       ThrowError("expected \'\"\' in object");
     }
-
-    // 解析key
-    key = ParseString();
-
-    if ((token = GetNextToken()) != ':') {
+    ParseString();
+    if (GetNextToken() != ':') {
       ThrowError("expected \':\' in object");
     }
 
-    // 解析value
-    json_object[key] = Parse();
+    const Projection::Node *child = node.Child(string_buffer_);
+    if (Selects(child)) {
+      EmitKey(handler);
+      ParseProjected(handler, *child);
+    } else {
+      SkipUnselected();
+    }
 
     token = GetNextToken();
     if (token == '}') {
@@ -283,7 +764,7 @@ Json Parser::ParseObject() {
     }
   }
 
-  return json_object;
+  handler.OnEndObject();
 }
 
 }  // namespace jsoncpp
@@ -0,0 +1,85 @@
+#include "projection.h"
+
+#include <stdexcept>
+
+#include "json_pointer.h"
+
+namespace jiayuancs {
+namespace jsoncpp {
+
+Projection::Projection(std::initializer_list<std::string> paths) {
+  for (const std::string &path : paths) {
+    Add(path);
+  }
+  Normalize(root_);
+}
+
+Projection::Projection(const std::vector<std::string> &paths) {
+  for (const std::string &path : paths) {
+    Add(path);
+  }
+  Normalize(root_);
+}
+
+const Projection::Node *Projection::Node::Child(const std::string &key) const {
+  auto iter = children.find(key);
+  return iter != children.end() ? iter->second.get() : wildcard.get();
+}
+
+const Projection::Node *Projection::Node::Element(std::size_t index) const {
+  // 通常只有'*'，避免为每个元素生成下标字符串
+  if (children.empty()) {
+    return wildcard.get();
+  }
+  return Child(std::to_string(index));
+}
+
+void Projection::Add(const std::string &path) {
+  std::vector<std::string> tokens;
+  if (!ParseJsonPointer(path, tokens)) {
+    throw std::logic_error("Projection: invalid JSON Pointer: " + path);
+  }
+
+  Node *node = &root_;
+  for (const std::string &token : tokens) {
+    std::unique_ptr<Node> &child =
+        token == "*" ? node->wildcard : node->children[token];
+    if (child == nullptr) {
+      child.reset(new Node());
+    }
+    node = child.get();
+  }
+  node->all = true;
+}
+
+void Projection::Merge(Node &dst, const Node &src) {
+  dst.all = dst.all || src.all;
+  for (const auto &child : src.children) {
+    std::unique_ptr<Node> &target = dst.children[child.first];
+    if (target == nullptr) {
+      target.reset(new Node());
+    }
+    Merge(*target, *child.second);
+  }
+  if (src.wildcard != nullptr) {
+    if (dst.wildcard == nullptr) {
+      dst.wildcard.reset(new Node());
+    }
+    Merge(*dst.wildcard, *src.wildcard);
+  }
+}
+
+void Projection::Normalize(Node &node) {
+  if (node.wildcard != nullptr) {
+    for (auto &child : node.children) {
+      Merge(*child.second, *node.wildcard);
+    }
+    Normalize(*node.wildcard);
+  }
+  for (auto &child : node.children) {
+    Normalize(*child.second);
+  }
+}
+
+}  // namespace jsoncpp
+}  // namespace jiayuancs
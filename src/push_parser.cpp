@@ -0,0 +1,399 @@
+#include "push_parser.h"
+
+#include <cmath>
+#include <sstream>
+
+#include "dom_builder.h"
+#include "number_parser.h"
+#include "utf8.h"
+
+namespace jiayuancs {
+namespace jsoncpp {
+
+namespace {
+
+bool IsSpace(char ch) {
+  return ch == ' ' || ch == '\t' || ch == '\n' || ch == '\r';
+}
+
+// 可能出现在数字中的字符，数字是否合法在结束后统一检查
+bool IsNumberChar(char ch) {
+  return (ch >= '0' && ch <= '9') || ch == '-' || ch == '+' || ch == '.' ||
+         ch == 'e' || ch == 'E';
+}
+
+}  // namespace
+
+PushParser::PushParser() : handler_(nullptr) { Reset(); }
+
+PushParser::PushParser(Handler &handler) : handler_(&handler) { Reset(); }
+
+PushParser::~PushParser() {}
+
+void PushParser::Reset() {
+  if (handler_ == nullptr || builder_ != nullptr) {
+    root_ = Json();
+    builder_.reset(new DomBuilder(root_, nullptr));
+    handler_ = builder_.get();
+  }
+  state_ = kValue;
+  stack_.clear();
+  token_.clear();
+  high_surrogate_ = 0;
+  line_no_ = 1;
+  consumed_ = 0;
+  error_.clear();
+}
+
+PushParser::Status PushParser::Feed(const char *data, std::size_t length) {
+  const char *cur = data;
+  const char *end = data + length;
+  while (cur != end && state_ != kDone && state_ != kFailed) {
+    // 结构字符之间的空白字符
+    if (state_ <= kObjectNext) {
+      while (cur != end && IsSpace(*cur)) {
+        if (*cur++ == '\n') {
+          ++line_no_;
+        }
+      }
+      if (cur == end) {
+        break;
+      }
+    }
+
+    switch (state_) {
+      case kValue:
+        StartValue(cur);
+        break;
+      case kArrayFirst:
+        if (*cur == ']') {
+          ++cur;
+          EndContainer();
+        } else {
+          StartValue(cur);
+        }
+        break;
+      case kArrayNext:
+        if (*cur == ',') {
+          ++cur;
+          state_ = kValue;
+        } else if (*cur == ']') {
+          ++cur;
+          EndContainer();
+        } else {
+          Fail("invalid array");
+        }
+        break;
+      case kObjectFirst:
+      case kObjectKey:
+        if (*cur == '\"') {
+          ++cur;
+          token_.clear();
+          string_is_key_ = true;
+          state_ = kString;
+        } else if (*cur == '}' && state_ == kObjectFirst) {
+          ++cur;
+          EndContainer();
+        } else {
+          Fail("expected \'\"\' in object");
+        }
+        break;
+      case kObjectColon:
+        if (*cur == ':') {
+          ++cur;
+          state_ = kValue;
+        } else {
+          Fail("expected \':\' in object");
+        }
+        break;
+      case kObjectNext:
+        if (*cur == ',') {
+          ++cur;
+          state_ = kObjectKey;
+        } else if (*cur == '}') {
+          ++cur;
+          EndContainer();
+        } else {
+          Fail("expected \',\' in object");
+        }
+        break;
+      case kString: {
+        // 整段复制不含引号和转义字符的连续片段
+        const char *run = cur;
+        while (cur != end && *cur != '\"' && *cur != '\\') {
+          if (*cur++ == '\n') {
+            ++line_no_;
+          }
+        }
+        token_.append(run, cur);
+        if (cur == end) {
+          break;
+        }
+        if (*cur++ == '\"') {
+          FinishString();
+        } else {
+          state_ = kStringEscape;
+        }
+        break;
+      }
+      case kStringEscape: {
+        char token = *cur++;
+        state_ = kString;
+        switch (token) {
+          case 'b':
+            token_ += '\b';
+            break;
+          case 'f':
+            token_ += '\f';
+            break;
+          case 'n':
+            token_ += '\n';
+            break;
+          case 'r':
+            token_ += '\r';
+            break;
+          case 't':
+            token_ += '\t';
+            break;
+          case 'u':
+            hex_value_ = 0;
+            hex_digits_ = 0;
+            state_ = kStringHex;
+            break;
+          default:
+            // 与Parser相同，其余字符(包括'\"'、'\\'和'/')按原样保留
+            token_ += token;
+            break;
+        }
+        break;
+      }
+      case kStringHex: {
+        char ch = *cur++;
+        hex_value_ <<= 4;
+        if (ch >= '0' && ch <= '9') {
+          hex_value_ |= ch - '0';
+        } else if (ch >= 'a' && ch <= 'f') {
+          hex_value_ |= ch - 'a' + 10;
+        } else if (ch >= 'A' && ch <= 'F') {
+          hex_value_ |= ch - 'A' + 10;
+        } else {
+          Fail("invalid unicode escape");
+          break;
+        }
+        if (++hex_digits_ == 4) {
+          FinishHex();
+        }
+        break;
+      }
+      case kSurrogateBackslash:
+        if (*cur++ != '\\') {
+          Fail("invalid unicode surrogate pair");
+        } else {
+          state_ = kSurrogateU;
+        }
+        break;
+      case kSurrogateU:
+        if (*cur++ != 'u') {
+          Fail("invalid unicode surrogate pair");
+        } else {
+          hex_value_ = 0;
+          hex_digits_ = 0;
+          state_ = kStringHex;
+        }
+        break;
+      case kNumber: {
+        const char *run = cur;
+        while (cur != end && IsNumberChar(*cur)) {
+          ++cur;
+        }
+        token_.append(run, cur);
+        if (cur != end) {
+          FinishNumber();
+        }
+        break;
+      }
+      case kLiteral:
+        while (cur != end && literal_[literal_pos_] != '\0') {
+          if (*cur != literal_[literal_pos_]) {
+            Fail(literal_[0] == 'n' ? "expected null, but was "
+                                    : "expected bool value (true or false), "
+                                      "but was ",
+                 *cur);
+            break;
+          }
+          ++cur;
+          ++literal_pos_;
+        }
+        if (state_ == kLiteral && literal_[literal_pos_] == '\0') {
+          if (literal_[0] == 'n') {
+            handler_->OnNull();
+          } else {
+            handler_->OnBool(literal_[0] == 't');
+          }
+          EndValue();
+        }
+        break;
+      default:
+        break;
+    }
+  }
+
+  consumed_ = cur - data;
+  return CurrentStatus();
+}
+
+PushParser::Status PushParser::Finish() {
+  // 顶层数字只有在输入结束时才能确定已经结束
+  if (state_ == kNumber && stack_.empty()) {
+    FinishNumber();
+  }
+  if (state_ != kDone && state_ != kFailed) {
+    Fail("expected more characters, but got eof");
+  }
+  return CurrentStatus();
+}
+
+void PushParser::StartValue(const char *&cur) {
+  char ch = *cur;
+  switch (ch) {
+    case '\"':
+      ++cur;
+      token_.clear();
+      string_is_key_ = false;
+      state_ = kString;
+      return;
+    case '[':
+      ++cur;
+      handler_->OnStartArray();
+      stack_.push_back('[');
+      state_ = kArrayFirst;
+      return;
+    case '{':
+      ++cur;
+      handler_->OnStartObject();
+      stack_.push_back('{');
+      state_ = kObjectFirst;
+      return;
+    case 't':
+      literal_ = "true";
+      break;
+    case 'f':
+      literal_ = "false";
+      break;
+    case 'n':
+      literal_ = "null";
+      break;
+    default:
+      if (ch == '-' || (ch >= '0' && ch <= '9')) {
+        token_.clear();
+        state_ = kNumber;
+        return;
+      }
+      Fail("unexpected character ", ch);
+      return;
+  }
+  literal_pos_ = 0;
+  state_ = kLiteral;
+}
+
+void PushParser::EndValue() {
+  if (stack_.empty()) {
+    state_ = kDone;
+  } else {
+    state_ = stack_.back() == '[' ? kArrayNext : kObjectNext;
+  }
+}
+
+void PushParser::EndContainer() {
+  if (stack_.back() == '[') {
+    handler_->OnEndArray();
+  } else {
+    handler_->OnEndObject();
+  }
+  stack_.pop_back();
+  EndValue();
+}
+
+void PushParser::FinishString() {
+  if (string_is_key_) {
+    handler_->OnKey(token_);
+    state_ = kObjectColon;
+    return;
+  }
+  handler_->OnString(token_);
+  EndValue();
+}
+
+void PushParser::FinishNumber() {
+  const char *begin = token_.data();
+  const char *end = begin + token_.size();
+  bool negative = begin != end && *begin == '-';
+  number::Number number;
+  const char *number_end =
+      number::ParseNumber(begin + negative, end, negative, number);
+  if (number_end != end) {
+    Fail("invalid number");
+    return;
+  }
+  if (number.is_integer) {
+    handler_->OnInt(number.integer);
+  } else if (std::isinf(number.double_value)) {
+    Fail("number out of range");
+    return;
+  } else {
+    handler_->OnDouble(number.double_value);
+  }
+  EndValue();
+}
+
+void PushParser::FinishHex() {
+  unsigned code_point = hex_value_;
+  if (high_surrogate_ != 0) {
+    if (code_point < 0xDC00 || code_point > 0xDFFF) {
+      Fail("invalid unicode surrogate pair");
+      return;
+    }
+    code_point = 0x10000 + ((high_surrogate_ - 0xD800) << 10) +
+                 (code_point - 0xDC00);
+    high_surrogate_ = 0;
+  } else if (code_point >= 0xD800 && code_point <= 0xDBFF) {
+    // UTF-16代理对，后面必须紧跟低位代理
+    high_surrogate_ = code_point;
+    state_ = kSurrogateBackslash;
+    return;
+  } else if (code_point >= 0xDC00 && code_point <= 0xDFFF) {
+    Fail("invalid unicode surrogate pair");
+    return;
+  }
+  AppendUtf8(code_point, token_);
+  state_ = kString;
+}
+
+void PushParser::Fail(const char *info_str) {
+  std::ostringstream error_info;
+  error_info << "syntax error in line " << line_no_ << ": " << info_str;
+  error_ = error_info.str();
+  state_ = kFailed;
+}
+
+void PushParser::Fail(const char *info_str, char value) {
+  std::ostringstream error_info;
+  error_info << "syntax error in line " << line_no_ << ": " << info_str
+             << "\"" << value << "\"";
+  error_ = error_info.str();
+  state_ = kFailed;
+}
+
+PushParser::Status PushParser::CurrentStatus() const {
+  switch (state_) {
+    case kDone:
+      return kComplete;
+    case kFailed:
+      return kError;
+    default:
+      return kNeedMoreData;
+  }
+}
+
+}  // namespace jsoncpp
+}  // namespace jiayuancs
@@ -0,0 +1,640 @@
+#include "regex.h"
+
+#include <algorithm>
+#include <stdexcept>
+
+namespace jiayuancs {
+namespace jsoncpp {
+
+namespace {
+
+// 表示字符串的开头之前或末尾之后，不是任何码点
+const unsigned kNoCharacter = 0xFFFFFFFF;
+const unsigned kMaxCodePoint = 0x10FFFF;
+
+// 编译后指令数的上限，限制{n,m}展开后的大小
+const std::size_t kMaxInstructions = 10000;
+// {n,m}中n和m的上限
+const int kMaxRepeat = 1000;
+// 分组嵌套深度的上限
+const int kMaxDepth = 100;
+
+using Ranges = std::vector<std::pair<unsigned, unsigned>>;
+
+bool IsDigit(char ch) { return ch >= '0' && ch <= '9'; }
+
+bool IsAsciiLetter(char ch) {
+  return (ch >= 'a' && ch <= 'z') || (ch >= 'A' && ch <= 'Z');
+}
+
+bool IsWordChar(unsigned code_point) {
+  return (code_point >= 'a' && code_point <= 'z') ||
+         (code_point >= 'A' && code_point <= 'Z') ||
+         (code_point >= '0' && code_point <= '9') || code_point == '_';
+}
+
+// 读取一个UTF-8编码的码点，不合法的字节按该字节的值处理
+unsigned DecodeUtf8(const char *&cur, const char *end) {
+  unsigned char lead = static_cast<unsigned char>(*cur++);
+  int length;
+  unsigned code_point;
+  if (lead < 0x80) {
+    return lead;
+  } else if ((lead & 0xE0) == 0xC0) {
+    length = 1;
+    code_point = lead & 0x1F;
+  } else if ((lead & 0xF0) == 0xE0) {
+    length = 2;
+    code_point = lead & 0x0F;
+  } else if ((lead & 0xF8) == 0xF0) {
+    length = 3;
+    code_point = lead & 0x07;
+  } else {
+    return lead;
+  }
+  if (end - cur < length) {
+    return lead;
+  }
+  for (int i = 0; i < length; ++i) {
+    unsigned char next = static_cast<unsigned char>(cur[i]);
+    if ((next & 0xC0) != 0x80) {
+      return lead;
+    }
+    code_point = (code_point << 6) | (next & 0x3F);
+  }
+  cur += length;
+  return code_point;
+}
+
+// 排序并合并重叠或相邻的区间
+void Normalize(Ranges &ranges) {
+  std::sort(ranges.begin(), ranges.end());
+  std::size_t size = 0;
+  for (const auto &range : ranges) {
+    if (size != 0 && range.first <= ranges[size - 1].second + 1) {
+      ranges[size - 1].second = std::max(ranges[size - 1].second, range.second);
+    } else {
+      ranges[size++] = range;
+    }
+  }
+  ranges.resize(size);
+}
+
+Ranges Complement(Ranges ranges) {
+  Normalize(ranges);
+  Ranges result;
+  unsigned next = 0;
+  for (const auto &range : ranges) {
+    if (range.first > next) {
+      result.emplace_back(next, range.first - 1);
+    }
+    next = range.second + 1;
+  }
+  if (next <= kMaxCodePoint) {
+    result.emplace_back(next, kMaxCodePoint);
+  }
+  return result;
+}
+
+bool Contains(const Ranges &ranges, unsigned code_point) {
+  auto it = std::upper_bound(
+      ranges.begin(), ranges.end(), code_point,
+      [](unsigned value, const std::pair<unsigned, unsigned> &range) {
+        return value < range.first;
+      });
+  return it != ranges.begin() && code_point <= (it - 1)->second;
+}
+
+Ranges DigitRanges() { return Ranges{{'0', '9'}}; }
+
+Ranges WordRanges() {
+  return Ranges{{'0', '9'}, {'A', 'Z'}, {'_', '_'}, {'a', 'z'}};
+}
+
+// ECMAScript中\s包括的空白和换行字符
+Ranges SpaceRanges() {
+  return Ranges{{'\t', '\r'},     {' ', ' '},       {0xA0, 0xA0},
+                {0x1680, 0x1680}, {0x2000, 0x200A}, {0x2028, 0x2029},
+                {0x202F, 0x202F}, {0x205F, 0x205F}, {0x3000, 0x3000},
+                {0xFEFF, 0xFEFF}};
+}
+
+}  // namespace
+
+// 把pattern编译为指令序列，各部分先编译为独立的片段再拼接，
+// 片段中的跳转目标是相对于片段开头的下标
+class Regex::Compiler final {
+ public:
+  Compiler(const std::string &pattern, Regex &regex)
+      : cur_(pattern.data()),
+        end_(pattern.data() + pattern.size()),
+        regex_(regex) {}
+
+  void Compile() {
+    Code code = ParseAlternation(0);
+    if (cur_ != end_) {  // 只可能停在多余的')'处
+      Fail("unmatched ')'");
+    }
+    Push(code, Instruction{kMatch, 0, 0});
+    regex_.program_ = std::move(code);
+  }
+
+ private:
+  using Code = std::vector<Instruction>;
+
+  [[noreturn]] static void Fail(const std::string &reason) {
+    throw std::logic_error("invalid pattern: " + reason);
+  }
+
+  static void Push(Code &code, Instruction instruction) {
+    if (code.size() >= kMaxInstructions) {
+      Fail("pattern too large");
+    }
+    code.push_back(instruction);
+  }
+
+  // 把片段from追加到code末尾，并调整其中的跳转目标
+  static void Append(Code &code, const Code &from) {
+    if (code.size() + from.size() > kMaxInstructions) {
+      Fail("pattern too large");
+    }
+    int offset = static_cast<int>(code.size());
+    for (Instruction instruction : from) {
+      if (instruction.opcode == kSplit || instruction.opcode == kJump) {
+        instruction.x += offset;
+        instruction.y += offset;
+      }
+      code.push_back(instruction);
+    }
+  }
+
+  int AddClass(Ranges ranges) {
+    Normalize(ranges);
+    regex_.classes_.push_back(std::move(ranges));
+    return static_cast<int>(regex_.classes_.size() - 1);
+  }
+
+  Code ParseAlternation(int depth) {
+    Code code = ParseSequence(depth);
+    while (cur_ != end_ && *cur_ == '|') {
+      ++cur_;
+      Code right = ParseSequence(depth);
+      Code result;
+      Push(result, Instruction{kSplit, 1, 0});
+      Append(result, code);
+      std::size_t jump = result.size();
+      Push(result, Instruction{kJump, 0, 0});
+      result[0].y = static_cast<int>(result.size());
+      Append(result, right);
+      result[jump].x = static_cast<int>(result.size());
+      code.swap(result);
+    }
+    return code;
+  }
+
+  Code ParseSequence(int depth) {
+    Code code;
+    while (cur_ != end_ && *cur_ != '|' && *cur_ != ')') {
+      Code atom;
+      bool repeatable = ParseAtom(atom, depth);
+      int min;
+      int max;
+      if (ParseQuantifier(min, max)) {
+        if (!repeatable) {
+          Fail("nothing to repeat");
+        }
+        atom = Repeat(atom, min, max);
+      }
+      Append(code, atom);
+    }
+    return code;
+  }
+
+  // 解析一个字符、字符类、分组或断言，可以被量词修饰时返回true
+  bool ParseAtom(Code &code, int depth) {
+    switch (*cur_) {
+      case '(':
+        ++cur_;
+        if (cur_ != end_ && *cur_ == '?') {
+          if (end_ - cur_ < 2 || cur_[1] != ':') {
+            Fail("lookaround and named groups are not supported");
+          }
+          cur_ += 2;
+        }
+        if (depth >= kMaxDepth) {
+          Fail("groups nested too deeply");
+        }
+        code = ParseAlternation(depth + 1);
+        if (cur_ == end_) {
+          Fail("missing ')'");
+        }
+        ++cur_;
+        return true;
+      case '*':
+      case '+':
+      case '?':
+        Fail("nothing to repeat");
+      case '{': {
+        int min;
+        int max;
+        if (ParseQuantifier(min, max)) {
+          Fail("nothing to repeat");
+        }
+        break;  // 不构成量词的'{'是普通字符
+      }
+      case '^':
+        ++cur_;
+        Push(code, Instruction{kBegin, 0, 0});
+        return false;
+      case '$':
+        ++cur_;
+        Push(code, Instruction{kEnd, 0, 0});
+        return false;
+      case '.':
+        ++cur_;
+        Push(code,
+             Instruction{kClass,
+                         AddClass(Complement(Ranges{
+                             {'\n', '\n'}, {'\r', '\r'}, {0x2028, 0x2029}})),
+                         0});
+        return true;
+      case '[':
+        ++cur_;
+        Push(code, Instruction{kClass, ParseClass(), 0});
+        return true;
+      case '\\': {
+        ++cur_;
+        if (cur_ != end_ && (*cur_ == 'b' || *cur_ == 'B')) {
+          Opcode opcode = *cur_ == 'b' ? kWordBoundary : kNotWordBoundary;
+          ++cur_;
+          Push(code, Instruction{opcode, 0, 0});
+          return false;
+        }
+        Ranges ranges;
+        unsigned code_point = ParseEscape(false, ranges);
+        if (code_point != kNoCharacter) {
+          ranges.emplace_back(code_point, code_point);
+        }
+        Push(code, Instruction{kClass, AddClass(std::move(ranges)), 0});
+        return true;
+      }
+      default:
+        break;
+    }
+    unsigned code_point = DecodeUtf8(cur_, end_);
+    Push(code, Instruction{kClass,
+                           AddClass(Ranges{{code_point, code_point}}), 0});
+    return true;
+  }
+
+  // 解析量词，max为-1表示不限，不是量词时不移动cur_并返回false
+  bool ParseQuantifier(int &min, int &max) {
+    if (cur_ == end_) {
+      return false;
+    }
+    switch (*cur_) {
+      case '*':
+        min = 0;
+        max = -1;
+        ++cur_;
+        break;
+      case '+':
+        min = 1;
+        max = -1;
+        ++cur_;
+        break;
+      case '?':
+        min = 0;
+        max = 1;
+        ++cur_;
+        break;
+      case '{':
+        if (!ParseBraces(min, max)) {
+          return false;
+        }
+        break;
+      default:
+        return false;
+    }
+    // 只判断是否匹配，非贪婪量词与贪婪量词的结果相同
+    if (cur_ != end_ && *cur_ == '?') {
+      ++cur_;
+    }
+    return true;
+  }
+
+  // 解析{n}、{n,}或{n,m}
+  bool ParseBraces(int &min, int &max) {
+    const char *cur = cur_ + 1;
+    if (!ParseCount(cur, min)) {
+      return false;
+    }
+    max = min;
+    if (cur != end_ && *cur == ',') {
+      ++cur;
+      if (cur != end_ && *cur == '}') {
+        max = -1;
+      } else if (!ParseCount(cur, max)) {
+        return false;
+      }
+    }
+    if (cur == end_ || *cur != '}') {
+      return false;
+    }
+    if (max >= 0 && max < min) {
+      Fail("numbers out of order in {} quantifier");
+    }
+    cur_ = cur + 1;
+    return true;
+  }
+
+  bool ParseCount(const char *&cur, int &value) {
+    if (cur == end_ || !IsDigit(*cur)) {
+      return false;
+    }
+    value = 0;
+    while (cur != end_ && IsDigit(*cur)) {
+      value = value * 10 + (*cur - '0');
+      if (value > kMaxRepeat) {
+        Fail("repeat count too large");
+      }
+      ++cur;
+    }
+    return true;
+  }
+
+  // body重复min到max次，max为-1表示不限
+  static Code Repeat(const Code &body, int min, int max) {
+    Code code;
+    for (int i = 0; i < min; ++i) {
+      Append(code, body);
+    }
+    if (max < 0) {
+      int split = static_cast<int>(code.size());
+      Push(code, Instruction{kSplit, split + 1, 0});
+      Append(code, body);
+      Push(code, Instruction{kJump, split, 0});
+      code[split].y = static_cast<int>(code.size());
+      return code;
+    }
+    std::vector<std::size_t> splits;
+    for (int i = min; i < max; ++i) {
+      splits.push_back(code.size());
+      Push(code, Instruction{kSplit, static_cast<int>(code.size()) + 1, 0});
+      Append(code, body);
+    }
+    for (std::size_t split : splits) {
+      code[split].y = static_cast<int>(code.size());
+    }
+    return code;
+  }
+
+  // cur_指向'['之后的字符，返回字符类的下标
+  int ParseClass() {
+    bool negated = cur_ != end_ && *cur_ == '^';
+    if (negated) {
+      ++cur_;
+    }
+    Ranges ranges;
+    for (;;) {
+      if (cur_ == end_) {
+        Fail("missing ']'");
+      }
+      if (*cur_ == ']') {
+        ++cur_;
+        break;
+      }
+      unsigned first = ParseClassAtom(ranges);
+      if (end_ - cur_ >= 2 && *cur_ == '-' && cur_[1] != ']') {
+        ++cur_;
+        unsigned last = ParseClassAtom(ranges);
+        if (first == kNoCharacter || last == kNoCharacter) {
+          Fail("invalid range in character class");
+        }
+        if (last < first) {
+          Fail("range out of order in character class");
+        }
+        ranges.emplace_back(first, last);
+      } else if (first != kNoCharacter) {
+        ranges.emplace_back(first, first);
+      }
+    }
+    return AddClass(negated ? Complement(std::move(ranges))
+                            : std::move(ranges));
+  }
+
+  unsigned ParseClassAtom(Ranges &ranges) {
+    if (*cur_ == '\\') {
+      ++cur_;
+      return ParseEscape(true, ranges);
+    }
+    return DecodeUtf8(cur_, end_);
+  }
+
+  // cur_指向'\'之后的字符。转义为单个字符时返回该字符，
+  // 为\d等字符类时追加到ranges并返回kNoCharacter
+  unsigned ParseEscape(bool in_class, Ranges &ranges) {
+    if (cur_ == end_) {
+      Fail("\\ at end of pattern");
+    }
+    char ch = *cur_++;
+    switch (ch) {
+      case 'd':
+      case 'D':
+      case 'w':
+      case 'W':
+      case 's':
+      case 'S': {
+        char lower = static_cast<char>(ch | 0x20);
+        Ranges set = lower == 'd'   ? DigitRanges()
+                     : lower == 'w' ? WordRanges()
+                                    : SpaceRanges();
+        if (ch != lower) {
+          set = Complement(std::move(set));
+        }
+        ranges.insert(ranges.end(), set.begin(), set.end());
+        return kNoCharacter;
+      }
+      case 'b':  // 字符类之外的\b是断言，已由调用者处理
+        return in_class ? 0x08 : kNoCharacter;
+      case 'f':
+        return '\f';
+      case 'n':
+        return '\n';
+      case 'r':
+        return '\r';
+      case 't':
+        return '\t';
+      case 'v':
+        return '\v';
+      case '0':
+        if (cur_ != end_ && IsDigit(*cur_)) {
+          Fail("octal escapes are not supported");
+        }
+        return 0;
+      case 'c':
+        if (cur_ == end_ || !IsAsciiLetter(*cur_)) {
+          Fail("invalid control escape");
+        }
+        return static_cast<unsigned>(*cur_++) % 32;
+      case 'x':
+        return ParseHex(2);
+      case 'u': {
+        unsigned code_point = ParseHex(4);
+        // \uD83D\uDE00这样的代理对合并为一个码点
+        if (code_point >= 0xD800 && code_point < 0xDC00 &&
+            end_ - cur_ >= 6 && cur_[0] == '\\' && cur_[1] == 'u') {
+          const char *saved = cur_;
+          cur_ += 2;
+          unsigned low = ParseHex(4);
+          if (low >= 0xDC00 && low < 0xE000) {
+            return 0x10000 + ((code_point - 0xD800) << 10) + (low - 0xDC00);
+          }
+          cur_ = saved;
+        }
+        return code_point;
+      }
+      default:
+        break;
+    }
+    if (IsDigit(ch)) {
+      Fail("backreferences are not supported");
+    }
+    if (IsAsciiLetter(ch)) {
+      Fail(std::string("unsupported escape \\") + ch);
+    }
+    // 其他字符转义为其本身
+    --cur_;
+    return DecodeUtf8(cur_, end_);
+  }
+
+  unsigned ParseHex(int digits) {
+    unsigned value = 0;
+    for (int i = 0; i < digits; ++i) {
+      if (cur_ == end_) {
+        Fail("invalid hexadecimal escape");
+      }
+      char ch = *cur_++;
+      value <<= 4;
+      if (IsDigit(ch)) {
+        value |= static_cast<unsigned>(ch - '0');
+      } else if (ch >= 'a' && ch <= 'f') {
+        value |= static_cast<unsigned>(ch - 'a' + 10);
+      } else if (ch >= 'A' && ch <= 'F') {
+        value |= static_cast<unsigned>(ch - 'A' + 10);
+      } else {
+        Fail("invalid hexadecimal escape");
+      }
+    }
+    return value;
+  }
+
+  const char *cur_;
+  const char *end_;
+  Regex &regex_;
+};
+
+// 同时跟踪所有可能的状态，每读取一个码点，所有状态一起前进一步
+class Regex::Matcher final {
+ public:
+  explicit Matcher(const Regex &regex)
+      : regex_(regex), marks_(regex.program_.size(), 0) {}
+
+  bool Search(const char *cur, const char *end) {
+    // 以^开头的pattern只能从开头开始匹配
+    const bool anchored = regex_.program_[0].opcode == kBegin;
+    unsigned previous = kNoCharacter;
+    unsigned current = cur != end ? DecodeUtf8(cur, end) : kNoCharacter;
+    for (;;) {
+      // 未锚定的搜索：每个位置都可以开始一次新的匹配
+      if ((!anchored || previous == kNoCharacter) &&
+          AddThread(0, previous, current, threads_)) {
+        return true;
+      }
+      if (current == kNoCharacter || (anchored && threads_.empty())) {
+        return false;
+      }
+      unsigned following = cur != end ? DecodeUtf8(cur, end) : kNoCharacter;
+      ++position_;
+      next_.clear();
+      for (int pc : threads_) {
+        const Ranges &ranges = regex_.classes_[regex_.program_[pc].x];
+        if (Contains(ranges, current) &&
+            AddThread(pc + 1, current, following, next_)) {
+          return true;
+        }
+      }
+      threads_.swap(next_);
+      previous = current;
+      current = following;
+    }
+  }
+
+ private:
+  // 从pc出发经过所有不读取码点的指令，把到达的kClass指令加入threads
+  // previous和next为当前位置前后的码点，到达kMatch时返回true
+  bool AddThread(int pc, unsigned previous, unsigned next,
+                 std::vector<int> &threads) {
+    stack_.push_back(pc);
+    while (!stack_.empty()) {
+      pc = stack_.back();
+      stack_.pop_back();
+      if (marks_[pc] == position_) {
+        continue;
+      }
+      marks_[pc] = position_;
+      const Instruction &instruction = regex_.program_[pc];
+      bool pass = false;
+      switch (instruction.opcode) {
+        case kClass:
+          threads.push_back(pc);
+          break;
+        case kSplit:
+          stack_.push_back(instruction.y);
+          stack_.push_back(instruction.x);
+          break;
+        case kJump:
+          stack_.push_back(instruction.x);
+          break;
+        case kBegin:
+          pass = previous == kNoCharacter;
+          break;
+        case kEnd:
+          pass = next == kNoCharacter;
+          break;
+        case kWordBoundary:
+          pass = IsWordChar(previous) != IsWordChar(next);
+          break;
+        case kNotWordBoundary:
+          pass = IsWordChar(previous) == IsWordChar(next);
+          break;
+        case kMatch:
+          stack_.clear();
+          return true;
+      }
+      if (pass) {
+        stack_.push_back(pc + 1);
+      }
+    }
+    return false;
+  }
+
+  const Regex &regex_;
+  std::size_t position_ = 1;  // 当前位置的序号
+  // 每条指令最近一次被加入时的position_，同一位置的状态只保留一个
+  std::vector<std::size_t> marks_;
+  std::vector<int> threads_;
+  std::vector<int> next_;
+  std::vector<int> stack_;
+};
+
+Regex::Regex() : program_{Instruction{kMatch, 0, 0}} {}
+
+Regex::Regex(const std::string &pattern) { Compiler(pattern, *this).Compile(); }
+
+bool Regex::Search(const char *data, std::size_t size) const {
+  return Matcher(*this).Search(data, data + size);
+}
+
+}  // namespace jsoncpp
+}  // namespace jiayuancs
@@ -0,0 +1,60 @@
+// 不回溯的正则表达式，用于JSON Schema的pattern(库内部使用)
+
+#ifndef JSONCPP_SRC_REGEX_H_
+#define JSONCPP_SRC_REGEX_H_
+
+#include <cstddef>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace jiayuancs {
+namespace jsoncpp {
+
+// 支持ECMAScript语法的以下子集：字符、.、字符类[...]、\d \w \s及其大写
+// 形式、\b \B、^ $、分组(...)和(?:...)、|，以及量词* + ? {n} {n,} {n,m}
+// (非贪婪形式与贪婪形式等价)。反向引用、前后查找等需要回溯的语法，
+// 以及格式错误的pattern在构造时抛出std::logic_error
+// 匹配按Unicode码点进行，同时跟踪NFA的所有状态(Thompson NFA)，既不回溯
+// 也不递归，耗时与pattern长度和字符串长度的乘积成正比
+class Regex final {
+ public:
+  // 空pattern，匹配任何字符串
+  Regex();
+  explicit Regex(const std::string &pattern);
+
+  // data中是否存在与pattern匹配的子串
+  bool Search(const char *data, std::size_t size) const;
+
+ private:
+  class Compiler;
+  class Matcher;
+
+  enum Opcode {
+    kClass,            // 匹配classes_[x]中的一个码点
+    kSplit,            // 同时转到x和y
+    kJump,             // 转到x
+    kBegin,            // ^
+    kEnd,              // $
+    kWordBoundary,     // \b
+    kNotWordBoundary,  // \B
+    kMatch,
+  };
+
+  struct Instruction {
+    Opcode opcode;
+    int x;
+    int y;
+  };
+
+  // 按起点排序且互不相邻的码点闭区间
+  using Ranges = std::vector<std::pair<unsigned, unsigned>>;
+
+  std::vector<Instruction> program_;
+  std::vector<Ranges> classes_;
+};
+
+}  // namespace jsoncpp
+}  // namespace jiayuancs
+
+#endif  // JSONCPP_SRC_REGEX_H_
@@ -0,0 +1,94 @@
+// 只识别字符串边界和嵌套深度的快速扫描函数(库内部使用)
+
+#ifndef JSONCPP_SRC_SCANNER_H_
+#define JSONCPP_SRC_SCANNER_H_
+
+#include <cstring>
+
+namespace jiayuancs {
+namespace jsoncpp {
+namespace scanner {
+
+inline bool IsSpace(char ch) {
+  return ch == ' ' || ch == '\t' || ch == '\n' || ch == '\r';
+}
+
+inline const char *SkipSpace(const char *cur, const char *end) {
+  while (cur != end && IsSpace(*cur)) {
+    ++cur;
+  }
+  return cur;
+}
+
+// cur指向起始引号之后的第一个字符，返回结束引号之后的位置
+// 字符串未结束时返回nullptr
+inline const char *SkipString(const char *cur, const char *end) {
+  for (;;) {
+    const char *quote = static_cast<const char *>(
+        std::memchr(cur, '\"', static_cast<std::size_t>(end - cur)));
+    if (quote == nullptr) {
+      return nullptr;
+    }
+    // 引号前连续反斜杠的个数为奇数时，该引号被转义
+    const char *backslash = quote;
+    while (backslash != cur && *(backslash - 1) == '\\') {
+      --backslash;
+    }
+    if ((quote - backslash) % 2 == 0) {
+      return quote + 1;
+    }
+    cur = quote + 1;
+  }
+}
+
+// cur指向一个值的第一个字符，返回该值之后的位置，不校验被跳过的内容
+// 仅匹配括号和字符串边界；输入提前结束时返回nullptr
+inline const char *SkipValue(const char *cur, const char *end) {
+  if (cur == end) {
+    return nullptr;
+  }
+
+  if (*cur == '\"') {
+    return SkipString(cur + 1, end);
+  }
+
+  if (*cur != '[' && *cur != '{') {
+    // 标量：一直读到分隔符为止
+    while (cur != end && !IsSpace(*cur) && *cur != ',' && *cur != ']' &&
+           *cur != '}' && *cur != ':') {
+      ++cur;
+    }
+    return cur;
+  }
+
+  int depth = 0;
+  while (cur != end) {
+    switch (*cur++) {
+      case '[':
+      case '{':
+        ++depth;
+        break;
+      case ']':
+      case '}':
+        if (--depth == 0) {
+          return cur;
+        }
+        break;
+      case '\"':
+        cur = SkipString(cur, end);
+        if (cur == nullptr) {
+          return nullptr;
+        }
+        break;
+      default:
+        break;
+    }
+  }
+  return nullptr;
+}
+
+}  // namespace scanner
+}  // namespace jsoncpp
+}  // namespace jiayuancs
+
+#endif  // JSONCPP_SRC_SCANNER_H_
@@ -0,0 +1,882 @@
+#include "schema.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <stdexcept>
+#include <utility>
+
+#include "dom_builder.h"
+#include "regex.h"
+
+namespace jiayuancs {
+namespace jsoncpp {
+
+namespace {
+
+// 值的类型位，整数值(包括小数部分为0的double)同时属于integer和number
+const unsigned kNullBit = 1 << 0;
+const unsigned kBooleanBit = 1 << 1;
+const unsigned kIntegerBit = 1 << 2;
+const unsigned kNumberBit = 1 << 3;
+const unsigned kStringBit = 1 << 4;
+const unsigned kArrayBit = 1 << 5;
+const unsigned kObjectBit = 1 << 6;
+const unsigned kAnyType = (1 << 7) - 1;
+
+const std::size_t kUnlimited = std::numeric_limits<std::size_t>::max();
+
+struct Property {
+  std::string name;
+  int schema;    // -1表示不受约束
+  int required;  // 在required成员中的序号，-1表示不是必需的
+};
+
+// schema中的一个(子)schema，子schema以在Program::nodes中的下标引用
+struct Node {
+  unsigned types = kAnyType;  // 为0时任何值都不符合(false schema)
+
+  // 数值边界保留原始的整数或double，null表示没有限制
+  Json minimum;
+  Json maximum;
+  bool exclusive_minimum = false;
+  bool exclusive_maximum = false;
+
+  std::size_t min_length = 0;  // 按Unicode码点计算
+  std::size_t max_length = kUnlimited;
+  bool has_pattern = false;
+  Regex pattern;
+
+  std::size_t min_items = 0;
+  std::size_t max_items = kUnlimited;
+  int items = -1;
+
+  std::size_t min_properties = 0;
+  std::size_t max_properties = kUnlimited;
+  std::vector<Property> properties;  // 按name排序
+  std::size_t required_count = 0;
+  bool deny_additional = false;
+  int additional = -1;
+
+  bool has_enum = false;
+  std::vector<Json> enum_values;
+};
+
+unsigned TypeBits(const Json &json) {
+  switch (json.Type()) {
+    case Json::kNull:
+      return kNullBit;
+    case Json::kBool:
+      return kBooleanBit;
+    case Json::kInt:
+      return kIntegerBit | kNumberBit;
+    case Json::kDouble: {
+      double value = json.GetDouble();
+      return std::isfinite(value) && std::floor(value) == value
+                 ? kIntegerBit | kNumberBit
+                 : kNumberBit;
+    }
+    case Json::kString:
+      return kStringBit;
+    case Json::kArray:
+      return kArrayBit;
+    case Json::kObject:
+      return kObjectBit;
+    default:
+      return 0;
+  }
+}
+
+bool IsNumber(const Json &json) { return json.IsInteger() || json.IsDouble(); }
+
+double NumberValue(const Json &json) {
+  return json.IsInteger() ? static_cast<double>(json.GetInteger())
+                          : json.GetDouble();
+}
+
+// 按数值比较两个数字，返回负数、0或正数
+// 整数之间精确比较，整数与double之间也不经过转换为double的舍入，
+// 因此9007199254740993大于9007199254740992.0
+int CompareNumbers(const Json &lhs, const Json &rhs) {
+  if (lhs.IsInteger() && rhs.IsInteger()) {
+    long long a = lhs.GetInteger();
+    long long b = rhs.GetInteger();
+    return a < b ? -1 : (a > b ? 1 : 0);
+  }
+  if (lhs.IsDouble() && rhs.IsDouble()) {
+    double a = lhs.GetDouble();
+    double b = rhs.GetDouble();
+    return a < b ? -1 : (a > b ? 1 : 0);
+  }
+  if (lhs.IsDouble()) {
+    return -CompareNumbers(rhs, lhs);
+  }
+
+  // 整数与double：先与long long的范围[-2^63, 2^63)比较，
+  // 范围内的double取整后精确比较整数部分，再比较小数部分
+  long long a = lhs.GetInteger();
+  double b = rhs.GetDouble();
+  const double kTwoTo63 = 9223372036854775808.0;
+  if (b >= kTwoTo63) {
+    return -1;
+  }
+  if (b < -kTwoTo63) {
+    return 1;
+  }
+  double integral = std::trunc(b);
+  long long whole = static_cast<long long>(integral);
+  if (a != whole) {
+    return a < whole ? -1 : 1;
+  }
+  return b > integral ? -1 : (b < integral ? 1 : 0);
+}
+
+// enum和const的比较：数字按数值比较(1与1.0相等)，array和object递归比较，
+// 其余按Json的operator==比较
+bool SchemaEqual(const Json &lhs, const Json &rhs) {
+  if (IsNumber(lhs) && IsNumber(rhs)) {
+    return CompareNumbers(lhs, rhs) == 0;
+  }
+  if (lhs.IsArray() && rhs.IsArray()) {
+    const Json::ArrayType &left = lhs.GetConstArray();
+    const Json::ArrayType &right = rhs.GetConstArray();
+    if (left.size() != right.size()) {
+      return false;
+    }
+    for (std::size_t i = 0; i < left.size(); ++i) {
+      if (!SchemaEqual(left[i], right[i])) {
+        return false;
+      }
+    }
+    return true;
+  }
+  if (lhs.IsObject() && rhs.IsObject()) {
+    const Json::ObjectType &left = lhs.GetConstObject();
+    const Json::ObjectType &right = rhs.GetConstObject();
+    if (left.size() != right.size()) {
+      return false;
+    }
+    for (const auto &member : left) {
+      auto iter = right.find(member.first);
+      if (iter == right.end() || !SchemaEqual(member.second, iter->second)) {
+        return false;
+      }
+    }
+    return true;
+  }
+  return lhs == rhs;
+}
+
+// 以下检查函数在值不符合node时返回原因，否则返回nullptr
+
+const char *CheckType(const Node &node, unsigned bits) {
+  if ((node.types & bits) != 0) {
+    return nullptr;
+  }
+  return node.types == 0 ? "value not allowed" : "type mismatch";
+}
+
+const char *CheckEnum(const Node &node, const Json &value) {
+  if (!node.has_enum) {
+    return nullptr;
+  }
+  for (const Json &candidate : node.enum_values) {
+    if (SchemaEqual(candidate, value)) {
+      return nullptr;
+    }
+  }
+  return "value not in enum";
+}
+
+const char *CheckNumber(const Node &node, const Json &value) {
+  if (!node.minimum.IsNull()) {
+    int order = CompareNumbers(value, node.minimum);
+    if (order < 0 || (node.exclusive_minimum && order == 0)) {
+      return "number below minimum";
+    }
+  }
+  if (!node.maximum.IsNull()) {
+    int order = CompareNumbers(value, node.maximum);
+    if (order > 0 || (node.exclusive_maximum && order == 0)) {
+      return "number above maximum";
+    }
+  }
+  return nullptr;
+}
+
+const char *CheckString(const Node &node, const char *data, std::size_t size) {
+  if (node.min_length != 0 || node.max_length != kUnlimited) {
+    // UTF-8中除后续字节(10xxxxxx)外，每个字节开始一个码点
+    std::size_t length = 0;
+    for (std::size_t i = 0; i < size; ++i) {
+      length += (static_cast<unsigned char>(data[i]) & 0xC0) != 0x80;
+    }
+    if (length < node.min_length) {
+      return "string shorter than minLength";
+    }
+    if (length > node.max_length) {
+      return "string longer than maxLength";
+    }
+  }
+  if (node.has_pattern && !node.pattern.Search(data, size)) {
+    return "string does not match pattern";
+  }
+  return nullptr;
+}
+
+const char *CheckScalar(const Node &node, const Json &value) {
+  const char *reason = CheckType(node, TypeBits(value));
+  if (reason == nullptr) {
+    reason = CheckEnum(node, value);
+  }
+  if (reason == nullptr && IsNumber(value)) {
+    reason = CheckNumber(node, value);
+  }
+  return reason;
+}
+
+const Property *FindProperty(const Node &node, const std::string &key) {
+  auto it = std::lower_bound(
+      node.properties.begin(), node.properties.end(), key,
+      [](const Property &property, const std::string &name) {
+        return property.name < name;
+      });
+  return it != node.properties.end() && it->name == key ? &*it : nullptr;
+}
+
+// 按JSON Pointer的规则转义key并追加到path末尾
+void AppendKey(std::string &path, const std::string &key) {
+  path.push_back('/');
+  for (char ch : key) {
+    if (ch == '~') {
+      path.append("~0");
+    } else if (ch == '/') {
+      path.append("~1");
+    } else {
+      path.push_back(ch);
+    }
+  }
+}
+
+[[noreturn]] void ThrowViolation(const std::string &path,
+                                 const std::string &reason) {
+  throw std::logic_error("schema violation at \"" + path + "\": " + reason);
+}
+
+}  // namespace
+
+struct Schema::Program {
+  std::vector<Node> nodes;  // nodes[0]为根schema
+};
+
+namespace {
+
+// 将schema编译为Program中的节点
+class Compiler final {
+ public:
+  explicit Compiler(std::vector<Node> &nodes) : nodes_(nodes) {}
+
+  // 返回编译得到的节点下标，path为schema中当前位置的JSON Pointer
+  int Compile(const Json &schema, const std::string &path) {
+    int index = static_cast<int>(nodes_.size());
+    nodes_.emplace_back();
+    if (schema.IsBool()) {
+      if (!schema.GetBool()) {
+        nodes_[index].types = 0;
+      }
+      return index;
+    }
+    if (!schema.IsObject()) {
+      Fail(path, "schema must be an object or a boolean");
+    }
+
+    const Json::ObjectType &object = schema.GetConstObject();
+    std::vector<Property> properties;
+    std::vector<std::string> required;
+    for (const auto &member : object) {
+      const std::string &keyword = member.first;
+      const Json &value = member.second;
+      std::string keyword_path = path;
+      AppendKey(keyword_path, keyword);
+      Node &node = nodes_[index];
+      if (keyword == "type") {
+        node.types = Types(value, keyword_path);
+      } else if (keyword == "enum") {
+        if (!value.IsArray()) {
+          Fail(keyword_path, "enum must be an array");
+        }
+        const Json::ArrayType &array = value.GetConstArray();
+        SetEnum(node, std::vector<Json>(array.begin(), array.end()));
+      } else if (keyword == "const") {
+        SetEnum(node, std::vector<Json>{value});
+      } else if (keyword == "minimum") {
+        SetLowerBound(node, Number(value, keyword_path), false);
+      } else if (keyword == "exclusiveMinimum") {
+        SetLowerBound(node, Number(value, keyword_path), true);
+      } else if (keyword == "maximum") {
+        SetUpperBound(node, Number(value, keyword_path), false);
+      } else if (keyword == "exclusiveMaximum") {
+        SetUpperBound(node, Number(value, keyword_path), true);
+      } else if (keyword == "minLength") {
+        node.min_length = Count(value, keyword_path);
+      } else if (keyword == "maxLength") {
+        node.max_length = Count(value, keyword_path);
+      } else if (keyword == "pattern") {
+        if (!value.IsString()) {
+          Fail(keyword_path, "pattern must be a string");
+        }
+        try {
+          node.pattern = Regex(value.GetString().ToString());
+        } catch (const std::logic_error &error) {
+          Fail(keyword_path, error.what());
+        }
+        node.has_pattern = true;
+      } else if (keyword == "minItems") {
+        node.min_items = Count(value, keyword_path);
+      } else if (keyword == "maxItems") {
+        node.max_items = Count(value, keyword_path);
+      } else if (keyword == "items") {
+        int items = Compile(value, keyword_path);
+        nodes_[index].items = items;
+      } else if (keyword == "minProperties") {
+        node.min_properties = Count(value, keyword_path);
+      } else if (keyword == "maxProperties") {
+        node.max_properties = Count(value, keyword_path);
+      } else if (keyword == "properties") {
+        if (!value.IsObject()) {
+          Fail(keyword_path, "properties must be an object");
+        }
+        for (const auto &property : value.GetConstObject()) {
+          std::string property_path = keyword_path;
+          AppendKey(property_path, property.first);
+          int child = Compile(property.second, property_path);
+          properties.push_back(Property{property.first, child, -1});
+        }
+      } else if (keyword == "required") {
+        required = Required(value, keyword_path);
+      } else if (keyword == "additionalProperties") {
+        if (value.IsBool()) {
+          node.deny_additional = !value.GetBool();
+        } else {
+          int additional = Compile(value, keyword_path);
+          nodes_[index].additional = additional;
+        }
+      } else if (!IsAnnotation(keyword)) {
+        Fail(path, "unsupported keyword \"" + keyword + "\"");
+      }
+    }
+
+    // 合并properties和required，得到按name排序的成员表
+    Node &node = nodes_[index];
+    for (const std::string &name : required) {
+      auto it = std::find_if(
+          properties.begin(), properties.end(),
+          [&](const Property &property) { return property.name == name; });
+      if (it == properties.end()) {
+        properties.push_back(Property{name, -1, -1});
+        it = properties.end() - 1;
+      }
+      if (it->required < 0) {
+        it->required = static_cast<int>(node.required_count++);
+      }
+    }
+    std::sort(properties.begin(), properties.end(),
+              [](const Property &lhs, const Property &rhs) {
+                return lhs.name < rhs.name;
+              });
+    node.properties = std::move(properties);
+    return index;
+  }
+
+ private:
+  [[noreturn]] static void Fail(const std::string &path,
+                                const std::string &reason) {
+    throw std::logic_error("invalid schema at \"" + path + "\": " + reason);
+  }
+
+  static bool IsAnnotation(const std::string &keyword) {
+    static const char *const kAnnotations[] = {
+        "$schema", "$id",      "$comment",   "title",     "description",
+        "default", "examples", "deprecated", "readOnly",  "writeOnly"};
+    for (const char *annotation : kAnnotations) {
+      if (keyword == annotation) {
+        return true;
+      }
+    }
+    return false;
+  }
+
+  static unsigned TypeBit(const Json &name, const std::string &path) {
+    static const struct {
+      const char *name;
+      unsigned bit;
+    } kTypes[] = {{"null", kNullBit},      {"boolean", kBooleanBit},
+                  {"integer", kIntegerBit}, {"number", kNumberBit},
+                  {"string", kStringBit},   {"array", kArrayBit},
+                  {"object", kObjectBit}};
+    if (name.IsString()) {
+      for (const auto &type : kTypes) {
+        if (name.GetString() == type.name) {
+          return type.bit;
+        }
+      }
+    }
+    Fail(path, "unknown type");
+  }
+
+  static unsigned Types(const Json &value, const std::string &path) {
+    if (!value.IsArray()) {
+      return TypeBit(value, path);
+    }
+    unsigned types = 0;
+    for (const Json &name : value.GetConstArray()) {
+      types |= TypeBit(name, path);
+    }
+    return types;
+  }
+
+  static const Json &Number(const Json &value, const std::string &path) {
+    if (!IsNumber(value)) {
+      Fail(path, "must be a number");
+    }
+    return value;
+  }
+
+  static std::size_t Count(const Json &value, const std::string &path) {
+    if (!(TypeBits(value) & kIntegerBit) || NumberValue(value) < 0) {
+      Fail(path, "must be a non-negative integer");
+    }
+    if (value.IsInteger()) {
+      return static_cast<std::size_t>(value.GetInteger());
+    }
+    // 超出std::size_t范围的值(如1e300)按不限处理
+    double count = value.GetDouble();
+    if (count >= static_cast<double>(kUnlimited)) {
+      return kUnlimited;
+    }
+    return static_cast<std::size_t>(count);
+  }
+
+  // 同时出现enum和const时，值须同时满足两者
+  static void SetEnum(Node &node, std::vector<Json> values) {
+    if (node.has_enum) {
+      values.erase(std::remove_if(values.begin(), values.end(),
+                                  [&](const Json &candidate) {
+                                    return CheckEnum(node, candidate) !=
+                                           nullptr;
+                                  }),
+                   values.end());
+    }
+    node.has_enum = true;
+    node.enum_values = std::move(values);
+  }
+
+  static void SetLowerBound(Node &node, const Json &bound, bool exclusive) {
+    int order =
+        node.minimum.IsNull() ? 1 : CompareNumbers(bound, node.minimum);
+    if (order > 0 || (order == 0 && exclusive)) {
+      node.minimum = bound;
+      node.exclusive_minimum = exclusive;
+    }
+  }
+
+  static void SetUpperBound(Node &node, const Json &bound, bool exclusive) {
+    int order =
+        node.maximum.IsNull() ? -1 : CompareNumbers(bound, node.maximum);
+    if (order < 0 || (order == 0 && exclusive)) {
+      node.maximum = bound;
+      node.exclusive_maximum = exclusive;
+    }
+  }
+
+  static std::vector<std::string> Required(const Json &value,
+                                           const std::string &path) {
+    if (!value.IsArray()) {
+      Fail(path, "required must be an array");
+    }
+    std::vector<std::string> names;
+    for (const Json &name : value.GetConstArray()) {
+      if (!name.IsString()) {
+        Fail(path, "required must contain strings");
+      }
+      names.push_back(name.GetString().ToString());
+    }
+    return names;
+  }
+
+  std::vector<Node> &nodes_;
+};
+
+// 校验已解析的Json对象
+void ValidateTree(const std::vector<Node> &nodes, int index, const Json &json,
+                  std::string &path) {
+  if (index < 0) {
+    return;
+  }
+  const Node &node = nodes[index];
+  const char *reason = CheckScalar(node, json);
+  if (reason != nullptr) {
+    ThrowViolation(path, reason);
+  }
+
+  std::size_t path_size = path.size();
+  switch (json.Type()) {
+    case Json::kString: {
+      StringView value = json.GetString();
+      reason = CheckString(node, value.data(), value.size());
+      if (reason != nullptr) {
+        ThrowViolation(path, reason);
+      }
+      break;
+    }
+    case Json::kArray: {
+      const Json::ArrayType &array = json.GetConstArray();
+      for (std::size_t i = 0; i < array.size(); ++i) {
+        path.push_back('/');
+        path.append(std::to_string(i));
+        if (i + 1 > node.max_items) {
+          ThrowViolation(path, "too many items");
+        }
+        ValidateTree(nodes, node.items, array[i], path);
+        path.resize(path_size);
+      }
+      if (array.size() < node.min_items) {
+        ThrowViolation(path, "too few items");
+      }
+      break;
+    }
+    case Json::kObject: {
+      const Json::ObjectType &object = json.GetConstObject();
+      std::size_t count = 0;
+      for (const auto &member : object) {
+        AppendKey(path, member.first);
+        if (++count > node.max_properties) {
+          ThrowViolation(path, "too many properties");
+        }
+        const Property *property = FindProperty(node, member.first);
+        int child = node.additional;
+        if (property != nullptr) {
+          child = property->schema;
+        } else if (node.deny_additional) {
+          ThrowViolation(path, "additional property not allowed");
+        }
+        ValidateTree(nodes, child, member.second, path);
+        path.resize(path_size);
+      }
+      if (count < node.min_properties) {
+        ThrowViolation(path, "too few properties");
+      }
+      for (const Property &property : node.properties) {
+        if (property.required >= 0 &&
+            object.find(property.name) == object.end()) {
+          ThrowViolation(path,
+                         "missing required property \"" + property.name + "\"");
+        }
+      }
+      break;
+    }
+    default:
+      break;
+  }
+}
+
+}  // namespace
+
+Schema::Schema(const Json &schema) {
+  std::shared_ptr<Program> program = std::make_shared<Program>();
+  Compiler(program->nodes).Compile(schema, "");
+  program_ = std::move(program);
+}
+
+bool Schema::Validate(const Json &json, std::string *error) const {
+  std::string path;
+  try {
+    ValidateTree(program_->nodes, 0, json, path);
+  } catch (const std::logic_error &e) {
+    if (error != nullptr) {
+      *error = e.what();
+    }
+    return false;
+  }
+  return true;
+}
+
+Json Schema::Parse(Parser &parser) const {
+  Json root;
+  DomBuilder builder(root, nullptr);
+  SchemaValidator validator(*this, &builder);
+  parser.Parse(validator);
+  return root;
+}
+
+SchemaValidator::SchemaValidator(const Schema &schema, Handler *next)
+    : program_(schema.program_), next_(next) {}
+
+SchemaValidator::~SchemaValidator() {}
+
+int SchemaValidator::Enter() {
+  if (stack_.empty()) {
+    return 0;
+  }
+  Frame &frame = stack_.back();
+  ++frame.count;
+  if (frame.node < 0) {
+    return -1;
+  }
+  const Node &node = program_->nodes[frame.node];
+  if (frame.is_object) {
+    if (frame.count > node.max_properties) {
+      Fail("too many properties");
+    }
+    return frame.member;
+  }
+  // 元素过多时立即停止，不必读完整个array
+  if (frame.count > node.max_items) {
+    Fail("too many items");
+  }
+  return node.items;
+}
+
+void SchemaValidator::Scalar(const Json &value) {
+  int index = Enter();
+  if (index >= 0) {
+    const char *reason = CheckScalar(program_->nodes[index], value);
+    if (reason != nullptr) {
+      Fail(reason);
+    }
+  }
+}
+
+void SchemaValidator::OnNull() {
+  if (capture_depth_ != 0) {
+    capture_builder_->OnNull();
+  } else {
+    Scalar(Json());
+  }
+  if (next_ != nullptr) {
+    next_->OnNull();
+  }
+}
+
+void SchemaValidator::OnBool(bool value) {
+  if (capture_depth_ != 0) {
+    capture_builder_->OnBool(value);
+  } else {
+    Scalar(Json(value));
+  }
+  if (next_ != nullptr) {
+    next_->OnBool(value);
+  }
+}
+
+void SchemaValidator::OnInt(long long value) {
+  if (capture_depth_ != 0) {
+    capture_builder_->OnInt(value);
+  } else {
+    Scalar(Json(value));
+  }
+  if (next_ != nullptr) {
+    next_->OnInt(value);
+  }
+}
+
+void SchemaValidator::OnDouble(double value) {
+  if (capture_depth_ != 0) {
+    capture_builder_->OnDouble(value);
+  } else {
+    Scalar(Json(value));
+  }
+  if (next_ != nullptr) {
+    next_->OnDouble(value);
+  }
+}
+
+void SchemaValidator::OnString(const std::string &value) {
+  if (capture_depth_ != 0) {
+    capture_builder_->OnString(value);
+  } else {
+    int index = Enter();
+    if (index >= 0) {
+      // 只有使用enum时才需要构造Json对象
+      const Node &node = program_->nodes[index];
+      const char *reason = CheckType(node, kStringBit);
+      if (reason == nullptr && node.has_enum) {
+        reason = CheckEnum(node, Json(value));
+      }
+      if (reason == nullptr) {
+        reason = CheckString(node, value.data(), value.size());
+      }
+      if (reason != nullptr) {
+        Fail(reason);
+      }
+    }
+  }
+  if (next_ != nullptr) {
+    next_->OnString(value);
+  }
+}
+
+void SchemaValidator::OnStartArray() {
+  StartContainer(false);
+  if (next_ != nullptr) {
+    next_->OnStartArray();
+  }
+}
+
+void SchemaValidator::OnEndArray() {
+  EndContainer(false);
+  if (next_ != nullptr) {
+    next_->OnEndArray();
+  }
+}
+
+void SchemaValidator::OnStartObject() {
+  StartContainer(true);
+  if (next_ != nullptr) {
+    next_->OnStartObject();
+  }
+}
+
+void SchemaValidator::OnKey(const std::string &key) {
+  CheckKey(key);
+  if (next_ != nullptr) {
+    next_->OnKey(key);
+  }
+}
+
+void SchemaValidator::OnInternedKey(const std::string &key) {
+  CheckKey(key);
+  if (next_ != nullptr) {
+    next_->OnInternedKey(key);
+  }
+}
+
+void SchemaValidator::CheckKey(const std::string &key) {
+  if (capture_depth_ != 0) {
+    capture_builder_->OnKey(key);
+  } else {
+    Frame &frame = stack_.back();
+    frame.key = key;
+    frame.member = -1;
+    if (frame.node >= 0) {
+      const Node &node = program_->nodes[frame.node];
+      const Property *property = FindProperty(node, key);
+      if (property != nullptr) {
+        frame.member = property->schema;
+        if (property->required >= 0) {
+          seen_[frame.seen + property->required] = 1;
+        }
+      } else if (node.deny_additional) {
+        Fail("additional property not allowed");
+      } else {
+        frame.member = node.additional;
+      }
+    }
+  }
+}
+
+void SchemaValidator::OnEndObject() {
+  EndContainer(true);
+  if (next_ != nullptr) {
+    next_->OnEndObject();
+  }
+}
+
+void SchemaValidator::StartContainer(bool is_object) {
+  if (capture_depth_ != 0) {
+    ++capture_depth_;
+    if (is_object) {
+      capture_builder_->OnStartObject();
+    } else {
+      capture_builder_->OnStartArray();
+    }
+    return;
+  }
+
+  int index = Enter();
+  std::size_t seen = seen_.size();
+  if (index >= 0) {
+    const Node &node = program_->nodes[index];
+    const char *reason = CheckType(node, is_object ? kObjectBit : kArrayBit);
+    if (reason != nullptr) {
+      Fail(reason);
+    }
+    if (node.has_enum) {
+      // 构建整个值，结束时按树的方式校验
+      capture_ = Json();
+      capture_builder_.reset(new DomBuilder(capture_, nullptr));
+      capture_depth_ = 1;
+      capture_node_ = index;
+      if (is_object) {
+        capture_builder_->OnStartObject();
+      } else {
+        capture_builder_->OnStartArray();
+      }
+      return;
+    }
+    if (is_object) {
+      seen_.resize(seen + node.required_count, 0);
+    }
+  }
+  stack_.push_back(Frame{index, is_object, 0, seen, -1, std::string()});
+}
+
+void SchemaValidator::EndContainer(bool is_object) {
+  if (capture_depth_ != 0) {
+    if (is_object) {
+      capture_builder_->OnEndObject();
+    } else {
+      capture_builder_->OnEndArray();
+    }
+    if (--capture_depth_ == 0) {
+      capture_builder_.reset();
+      std::string path = Path();
+      ValidateTree(program_->nodes, capture_node_, capture_, path);
+      capture_ = Json();
+    }
+    return;
+  }
+
+  // 出栈后的位置即为该容器的位置
+  Frame frame = std::move(stack_.back());
+  stack_.pop_back();
+  if (frame.node >= 0) {
+    const Node &node = program_->nodes[frame.node];
+    if (!is_object && frame.count < node.min_items) {
+      Fail("too few items");
+    }
+    if (is_object && frame.count < node.min_properties) {
+      Fail("too few properties");
+    }
+    // object的关键字不约束array，array的帧没有在seen_中占位
+    if (is_object) {
+      for (const Property &property : node.properties) {
+        if (property.required >= 0 &&
+            !seen_[frame.seen + property.required]) {
+          Fail("missing required property \"" + property.name + "\"");
+        }
+      }
+    }
+  }
+  seen_.resize(frame.seen);
+}
+
+std::string SchemaValidator::Path() const {
+  std::string path;
+  for (const Frame &frame : stack_) {
+    if (frame.is_object) {
+      AppendKey(path, frame.key);
+    } else {
+      path.push_back('/');
+      path.append(std::to_string(frame.count - 1));
+    }
+  }
+  return path;
+}
+
+void SchemaValidator::Fail(const std::string &reason) const {
+  ThrowViolation(Path(), reason);
+}
+
+}  // namespace jsoncpp
+}  // namespace jiayuancs
@@ -0,0 +1,25 @@
+#include "stats.h"
+
+#ifdef JSONCPP_STATS
+
+namespace jiayuancs {
+namespace jsoncpp {
+
+namespace {
+
+thread_local AllocationHook *g_hook = nullptr;
+
+}  // namespace
+
+AllocationHook *SetAllocationHook(AllocationHook *hook) {
+  AllocationHook *previous = g_hook;
+  g_hook = hook;
+  return previous;
+}
+
+AllocationHook *GetAllocationHook() { return g_hook; }
+
+}  // namespace jsoncpp
+}  // namespace jiayuancs
+
+#endif  // JSONCPP_STATS
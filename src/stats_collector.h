@@ -0,0 +1,110 @@
+// 解析时收集统计信息的Handler包装(库内部使用)
+
+#ifndef JSONCPP_SRC_STATS_COLLECTOR_H_
+#define JSONCPP_SRC_STATS_COLLECTOR_H_
+
+#include "jsoncpp_config.h"
+
+#ifdef JSONCPP_STATS
+
+#include <string>
+
+#include "json.h"
+#include "stats.h"
+
+namespace jiayuancs {
+namespace jsoncpp {
+
+// 统计经过的事件后转发给handler，存在期间作为当前线程的分配钩子，
+// 统计构建Json对象时的内存分配，并转发给之前设置的钩子
+template <typename HandlerType>
+class StatsCollector final : public AllocationHook {
+ public:
+  StatsCollector(HandlerType &handler, ParseStats &stats)
+      : handler_(handler), stats_(stats), scope_(this) {
+    ++stats_.parses;
+  }
+
+  void OnNull() {
+    Count(Json::kNull);
+    handler_.OnNull();
+  }
+  void OnBool(bool value) {
+    Count(Json::kBool);
+    handler_.OnBool(value);
+  }
+  void OnInt(long long value) {
+    Count(Json::kInt);
+    handler_.OnInt(value);
+  }
+  void OnDouble(double value) {
+    Count(Json::kDouble);
+    handler_.OnDouble(value);
+  }
+  void OnString(const std::string &value) {
+    Count(Json::kString);
+    stats_.string_bytes += value.size();
+    handler_.OnString(value);
+  }
+
+  void OnStartArray() {
+    Count(Json::kArray);
+    Enter();
+    handler_.OnStartArray();
+  }
+  void OnEndArray() {
+    --depth_;
+    handler_.OnEndArray();
+  }
+
+  void OnStartObject() {
+    Count(Json::kObject);
+    Enter();
+    handler_.OnStartObject();
+  }
+  void OnKey(const std::string &key) {
+    stats_.string_bytes += key.size();
+    handler_.OnKey(key);
+  }
+  void OnInternedKey(const std::string &key) {
+    stats_.string_bytes += key.size();
+    handler_.OnInternedKey(key);
+  }
+  void OnEndObject() {
+    --depth_;
+    handler_.OnEndObject();
+  }
+
+  void OnAllocate(std::size_t bytes) override {
+    ++stats_.allocation_count;
+    stats_.allocation_bytes += bytes;
+    if (scope_.Previous() != nullptr) {
+      scope_.Previous()->OnAllocate(bytes);
+    }
+  }
+  void OnDeallocate(std::size_t bytes) override {
+    if (scope_.Previous() != nullptr) {
+      scope_.Previous()->OnDeallocate(bytes);
+    }
+  }
+
+ private:
+  void Count(Json::JsonType type) { ++stats_.node_counts[type]; }
+  void Enter() {
+    if (++depth_ > stats_.max_depth) {
+      stats_.max_depth = depth_;
+    }
+  }
+
+  HandlerType &handler_;
+  ParseStats &stats_;
+  ScopedAllocationHook scope_;
+  std::size_t depth_ = 0;
+};
+
+}  // namespace jsoncpp
+}  // namespace jiayuancs
+
+#endif  // JSONCPP_STATS
+
+#endif  // JSONCPP_SRC_STATS_COLLECTOR_H_
@@ -0,0 +1,328 @@
+#include "structural_index.h"
+
+#include <cstring>
+
+#if defined(__x86_64__) || defined(__i386__) || defined(_M_X64)
+#define JSONCPP_X86 1
+#include <emmintrin.h>
+#if defined(__GNUC__) || defined(__clang__)
+// 仅GCC和Clang支持针对单个函数启用AVX2，并在运行时检测CPU特性
+#define JSONCPP_AVX2 1
+#include <immintrin.h>
+#endif
+#endif
+
+namespace jiayuancs {
+namespace jsoncpp {
+
+namespace {
+
+const std::size_t kBlockSize = 64;
+
+// 一个64字节分块中各类字符的位掩码，第i位对应分块中的第i个字节
+struct BlockMasks {
+  std::uint64_t quote;
+  std::uint64_t backslash;
+  std::uint64_t space;
+  std::uint64_t op;
+};
+
+// 跨分块传递的扫描状态
+struct ScanState {
+  std::uint64_t prev_escaped = 0;    // 下一分块的首字节是否被转义
+  std::uint64_t prev_in_string = 0;  // 上一分块结束时是否位于字符串内部
+  std::uint64_t prev_scalar = 0;     // 上一分块的末字节是否为标量字符
+};
+
+void ClassifyScalar(const char *block, BlockMasks &masks) {
+  masks = BlockMasks{0, 0, 0, 0};
+  for (std::size_t i = 0; i < kBlockSize; ++i) {
+    std::uint64_t bit = std::uint64_t(1) << i;
+    switch (block[i]) {
+      case '\"':
+        masks.quote |= bit;
+        break;
+      case '\\':
+        masks.backslash |= bit;
+        break;
+      case ' ':
+      case '\t':
+      case '\n':
+      case '\r':
+        masks.space |= bit;
+        break;
+      case '{':
+      case '}':
+      case '[':
+      case ']':
+      case ':':
+      case ',':
+        masks.op |= bit;
+        break;
+      default:
+        break;
+    }
+  }
+}
+
+#ifdef JSONCPP_X86
+void ClassifySse2(const char *block, BlockMasks &masks) {
+  masks = BlockMasks{0, 0, 0, 0};
+  const __m128i quote = _mm_set1_epi8('\"');
+  const __m128i backslash = _mm_set1_epi8('\\');
+  const __m128i space = _mm_set1_epi8(' ');
+  const __m128i tab = _mm_set1_epi8('\t');
+  const __m128i lf = _mm_set1_epi8('\n');
+  const __m128i cr = _mm_set1_epi8('\r');
+  // '['和']'的ASCII码与0x20按位或后分别为'{'和'}'
+  const __m128i lower = _mm_set1_epi8(0x20);
+  const __m128i left_brace = _mm_set1_epi8('{');
+  const __m128i right_brace = _mm_set1_epi8('}');
+  const __m128i colon = _mm_set1_epi8(':');
+  const __m128i comma = _mm_set1_epi8(',');
+
+  for (int i = 0; i < 4; ++i) {
+    __m128i in = _mm_loadu_si128(reinterpret_cast<const __m128i *>(block) + i);
+    __m128i folded = _mm_or_si128(in, lower);
+    __m128i ws = _mm_or_si128(
+        _mm_or_si128(_mm_cmpeq_epi8(in, space), _mm_cmpeq_epi8(in, tab)),
+        _mm_or_si128(_mm_cmpeq_epi8(in, lf), _mm_cmpeq_epi8(in, cr)));
+    __m128i op = _mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(folded, left_brace),
+                                           _mm_cmpeq_epi8(folded, right_brace)),
+                              _mm_or_si128(_mm_cmpeq_epi8(in, colon),
+                                           _mm_cmpeq_epi8(in, comma)));
+    int shift = i * 16;
+    masks.quote |= static_cast<std::uint64_t>(static_cast<std::uint16_t>(
+                       _mm_movemask_epi8(_mm_cmpeq_epi8(in, quote))))
+                   << shift;
+    masks.backslash |= static_cast<std::uint64_t>(static_cast<std::uint16_t>(
+                           _mm_movemask_epi8(_mm_cmpeq_epi8(in, backslash))))
+                       << shift;
+    masks.space |= static_cast<std::uint64_t>(
+                       static_cast<std::uint16_t>(_mm_movemask_epi8(ws)))
+                   << shift;
+    masks.op |= static_cast<std::uint64_t>(
+                    static_cast<std::uint16_t>(_mm_movemask_epi8(op)))
+                << shift;
+  }
+}
+#endif  // JSONCPP_X86
+
+#ifdef JSONCPP_AVX2
+__attribute__((target("avx2"))) void ClassifyAvx2(const char *block,
+                                                  BlockMasks &masks) {
+  masks = BlockMasks{0, 0, 0, 0};
+  const __m256i quote = _mm256_set1_epi8('\"');
+  const __m256i backslash = _mm256_set1_epi8('\\');
+  const __m256i space = _mm256_set1_epi8(' ');
+  const __m256i tab = _mm256_set1_epi8('\t');
+  const __m256i lf = _mm256_set1_epi8('\n');
+  const __m256i cr = _mm256_set1_epi8('\r');
+  const __m256i lower = _mm256_set1_epi8(0x20);
+  const __m256i left_brace = _mm256_set1_epi8('{');
+  const __m256i right_brace = _mm256_set1_epi8('}');
+  const __m256i colon = _mm256_set1_epi8(':');
+  const __m256i comma = _mm256_set1_epi8(',');
+
+  for (int i = 0; i < 2; ++i) {
+    __m256i in =
+        _mm256_loadu_si256(reinterpret_cast<const __m256i *>(block) + i);
+    __m256i folded = _mm256_or_si256(in, lower);
+    __m256i ws = _mm256_or_si256(
+        _mm256_or_si256(_mm256_cmpeq_epi8(in, space),
+                        _mm256_cmpeq_epi8(in, tab)),
+        _mm256_or_si256(_mm256_cmpeq_epi8(in, lf), _mm256_cmpeq_epi8(in, cr)));
+    __m256i op = _mm256_or_si256(
+        _mm256_or_si256(_mm256_cmpeq_epi8(folded, left_brace),
+                        _mm256_cmpeq_epi8(folded, right_brace)),
+        _mm256_or_si256(_mm256_cmpeq_epi8(in, colon),
+                        _mm256_cmpeq_epi8(in, comma)));
+    int shift = i * 32;
+    masks.quote |= static_cast<std::uint64_t>(static_cast<std::uint32_t>(
+                       _mm256_movemask_epi8(_mm256_cmpeq_epi8(in, quote))))
+                   << shift;
+    masks.backslash |=
+        static_cast<std::uint64_t>(static_cast<std::uint32_t>(
+            _mm256_movemask_epi8(_mm256_cmpeq_epi8(in, backslash))))
+        << shift;
+    masks.space |= static_cast<std::uint64_t>(
+                       static_cast<std::uint32_t>(_mm256_movemask_epi8(ws)))
+                   << shift;
+    masks.op |= static_cast<std::uint64_t>(
+                    static_cast<std::uint32_t>(_mm256_movemask_epi8(op)))
+                << shift;
+  }
+}
+#endif  // JSONCPP_AVX2
+
+int CountTrailingZeros(std::uint64_t value) {
+#if defined(__GNUC__) || defined(__clang__)
+  return __builtin_ctzll(value);
+#else
+  int count = 0;
+  while ((value & 1) == 0) {
+    value >>= 1;
+    ++count;
+  }
+  return count;
+#endif
+}
+
+// 计算被转义的字符：每个未被转义的反斜杠都会转义其后的一个字符
+// 反斜杠很少出现，逐位处理即可
+std::uint64_t FindEscaped(std::uint64_t backslash, ScanState &state) {
+  std::uint64_t escaped = state.prev_escaped;
+  std::uint64_t escaper = backslash & ~escaped;
+  state.prev_escaped = 0;
+  while (escaper != 0) {
+    int pos = CountTrailingZeros(escaper);
+    escaper &= escaper - 1;
+    if (pos == 63) {
+      state.prev_escaped = 1;
+    } else {
+      std::uint64_t next = std::uint64_t(1) << (pos + 1);
+      escaped |= next;
+      escaper &= ~next;  // 被转义的反斜杠不再转义后续字符
+    }
+  }
+  return escaped;
+}
+
+// 前缀异或：结果的第i位为输入第0~i位的异或
+std::uint64_t PrefixXor(std::uint64_t bits) {
+  bits ^= bits << 1;
+  bits ^= bits << 2;
+  bits ^= bits << 4;
+  bits ^= bits << 8;
+  bits ^= bits << 16;
+  bits ^= bits << 32;
+  return bits;
+}
+
+// 由字符分类掩码计算结构位置掩码
+std::uint64_t FindStructurals(const BlockMasks &masks, ScanState &state) {
+  std::uint64_t escaped = FindEscaped(masks.backslash, state);
+  std::uint64_t quote = masks.quote & ~escaped;
+
+  // 起始引号和字符串内部字符的位为1，结束引号的位为0
+  std::uint64_t in_string = PrefixXor(quote) ^ (0 - state.prev_in_string);
+  state.prev_in_string = in_string >> 63;
+  // 字符串内部字符(不含两端的引号)
+  std::uint64_t string_interior = in_string & ~quote;
+
+  // 标量字符：既不是空白、结构字符，也不是未被转义的引号
+  std::uint64_t scalar = ~(masks.space | masks.op | quote);
+  std::uint64_t follows_scalar = (scalar << 1) | state.prev_scalar;
+  state.prev_scalar = scalar >> 63;
+  std::uint64_t scalar_start = scalar & ~follows_scalar;
+
+  return (masks.op | quote | scalar_start) & ~string_interior;
+}
+
+int PopCount(std::uint64_t value) {
+#if defined(__GNUC__) || defined(__clang__)
+  return __builtin_popcountll(value);
+#else
+  int count = 0;
+  for (; value != 0; value &= value - 1) {
+    ++count;
+  }
+  return count;
+#endif
+}
+
+std::uint32_t *Flatten(std::uint64_t bits, std::uint32_t base,
+                       std::uint32_t *out) {
+  while (bits != 0) {
+    *out++ = base + CountTrailingZeros(bits);
+    bits &= bits - 1;
+  }
+  return out;
+}
+
+template <typename Classifier>
+void BuildIndex(const char *data, std::size_t length,
+                std::vector<std::uint32_t> &indexes, Classifier classify) {
+  // 先保存每个分块的结构位置掩码并统计总数，再按实际数量一次性分配索引，
+  // 掩码只占输入长度的1/8，避免按输入长度估算而多占或反复扩容
+  std::vector<std::uint64_t> structurals((length + kBlockSize - 1) /
+                                         kBlockSize);
+  std::size_t count = 0;
+
+  ScanState state;
+  BlockMasks masks;
+  std::size_t offset = 0;
+  std::size_t block = 0;
+  for (; offset + kBlockSize <= length; offset += kBlockSize, ++block) {
+    classify(data + offset, masks);
+    structurals[block] = FindStructurals(masks, state);
+    count += PopCount(structurals[block]);
+  }
+
+  if (offset < length) {
+    // 最后一个不完整的分块用空白字符补齐
+    char padded[kBlockSize];
+    std::memset(padded, ' ', kBlockSize);
+    std::memcpy(padded, data + offset, length - offset);
+    classify(padded, masks);
+    structurals[block] = FindStructurals(masks, state);
+    count += PopCount(structurals[block]);
+  }
+
+  // 多预留一个位置，调用者可以追加哨兵而不必重新分配
+  indexes.clear();
+  indexes.reserve(count + 1);
+  indexes.resize(count);
+  std::uint32_t *out = indexes.data();
+  for (block = 0; block < structurals.size(); ++block) {
+    out = Flatten(structurals[block],
+                  static_cast<std::uint32_t>(block * kBlockSize), out);
+  }
+}
+
+}  // namespace
+
+SimdLevel DetectSimdLevel() {
+#ifdef JSONCPP_AVX2
+  static const SimdLevel level =
+      __builtin_cpu_supports("avx2") ? kAvx2 : kSse2;
+  return level;
+#elif defined(JSONCPP_X86)
+  return kSse2;
+#else
+  return kScalar;
+#endif
+}
+
+void BuildStructuralIndex(const char *data, std::size_t length,
+                          std::vector<std::uint32_t> &indexes,
+                          SimdLevel level) {
+  // 不得使用CPU不支持的指令集
+  if (level > DetectSimdLevel()) {
+    level = DetectSimdLevel();
+  }
+
+  switch (level) {
+#ifdef JSONCPP_AVX2
+    case kAvx2:
+      BuildIndex(data, length, indexes, ClassifyAvx2);
+      return;
+#endif
+#ifdef JSONCPP_X86
+    case kSse2:
+      BuildIndex(data, length, indexes, ClassifySse2);
+      return;
+#endif
+    default:
+      BuildIndex(data, length, indexes, ClassifyScalar);
+      return;
+  }
+}
+
+void BuildStructuralIndex(const char *data, std::size_t length,
+                          std::vector<std::uint32_t> &indexes) {
+  BuildStructuralIndex(data, length, indexes, DetectSimdLevel());
+}
+
+}  // namespace jsoncpp
+}  // namespace jiayuancs
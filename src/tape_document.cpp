@@ -0,0 +1,456 @@
+#include "tape_document.h"
+
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+
+#include "handler.h"
+#include "mapped_file.h"
+#include "parser.h"
+
+namespace jiayuancs {
+namespace jsoncpp {
+
+namespace {
+
+const int kTagShift = 56;
+const std::uint64_t kPayloadMask = (std::uint64_t(1) << kTagShift) - 1;
+
+std::uint64_t MakeWord(char tag, std::uint64_t payload) {
+  return (static_cast<std::uint64_t>(static_cast<unsigned char>(tag))
+          << kTagShift) |
+         payload;
+}
+
+char TagOf(std::uint64_t word) { return static_cast<char>(word >> kTagShift); }
+
+std::uint64_t PayloadOf(std::uint64_t word) { return word & kPayloadMask; }
+
+// 跳过index处的值，返回下一个兄弟节点的下标
+std::size_t SkipValue(const std::uint64_t *tape, std::size_t index) {
+  switch (TagOf(tape[index])) {
+    case 'l':
+    case 'd':
+    case 's':
+      return index + 2;
+    case '[':
+    case '{':
+      return PayloadOf(tape[index]) + 1;
+    default:
+      return index + 1;
+  }
+}
+
+StringView StringAt(const std::uint64_t *tape, const char *strings,
+                    std::size_t index) {
+  return StringView(strings + PayloadOf(tape[index]), tape[index + 1]);
+}
+
+// 在事件接口上构建tape
+class TapeBuilder final : public Handler {
+ public:
+  TapeBuilder(std::vector<std::uint64_t> &tape, std::vector<char> &strings)
+      : tape_(tape), strings_(strings) {}
+
+  void OnNull() override {
+    BeginValue();
+    tape_.push_back(MakeWord('n', 0));
+  }
+  void OnBool(bool value) override {
+    BeginValue();
+    tape_.push_back(MakeWord(value ? 't' : 'f', 0));
+  }
+  void OnInt(long long value) override {
+    BeginValue();
+    tape_.push_back(MakeWord('l', 0));
+    tape_.push_back(static_cast<std::uint64_t>(value));
+  }
+  void OnDouble(double value) override {
+    BeginValue();
+    std::uint64_t bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+    tape_.push_back(MakeWord('d', 0));
+    tape_.push_back(bits);
+  }
+  void OnString(const std::string &value) override {
+    BeginValue();
+    AppendString(value.data(), value.size());
+  }
+
+  void OnStartArray() override {
+    BeginValue();
+    StartContainer('[');
+  }
+  void OnEndArray() override { EndContainer(']'); }
+
+  void OnStartObject() override {
+    BeginValue();
+    StartContainer('{');
+  }
+  void OnKey(const std::string &key) override {
+    ++tape_[stack_.back() + 1];
+    AppendString(key.data(), key.size());
+  }
+  void OnEndObject() override { EndContainer('}'); }
+
+ private:
+  // array中的每个值计入元素个数，object的成员个数在OnKey时计入
+  void BeginValue() {
+    if (!stack_.empty() && TagOf(tape_[stack_.back()]) == '[') {
+      ++tape_[stack_.back() + 1];
+    }
+  }
+
+  void StartContainer(char tag) {
+    stack_.push_back(tape_.size());
+    tape_.push_back(MakeWord(tag, 0));
+    tape_.push_back(0);  // 元素个数
+  }
+
+  void EndContainer(char tag) {
+    std::size_t start = stack_.back();
+    stack_.pop_back();
+    tape_[start] |= tape_.size();
+    tape_.push_back(MakeWord(tag, start));
+  }
+
+  // 字符串以'\0'结尾，便于与C接口交互
+  void AppendString(const char *data, std::size_t size) {
+    tape_.push_back(MakeWord('s', strings_.size()));
+    tape_.push_back(size);
+    strings_.insert(strings_.end(), data, data + size);
+    strings_.push_back('\0');
+  }
+
+  std::vector<std::uint64_t> &tape_;
+  std::vector<char> &strings_;
+  std::vector<std::size_t> stack_;  // 尚未结束的容器的开始字下标
+};
+
+// 按Json对象的结构产生事件
+void EmitEvents(const Json &json, Handler &handler) {
+  switch (json.Type()) {
+    case Json::kNull:
+      handler.OnNull();
+      break;
+    case Json::kBool:
+      handler.OnBool(json.GetBool());
+      break;
+    case Json::kInt:
+      handler.OnInt(json.GetInteger());
+      break;
+    case Json::kDouble:
+      handler.OnDouble(json.GetDouble());
+      break;
+    case Json::kString:
+      handler.OnString(json.GetString());
+      break;
+    case Json::kArray:
+      handler.OnStartArray();
+      for (const Json &element : json.GetConstArray()) {
+        EmitEvents(element, handler);
+      }
+      handler.OnEndArray();
+      break;
+    case Json::kObject:
+      handler.OnStartObject();
+      for (const auto &member : json.GetConstObject()) {
+        handler.OnKey(member.first);
+        EmitEvents(member.second, handler);
+      }
+      handler.OnEndObject();
+      break;
+    default:
+      break;
+  }
+}
+
+// 文件头，之后依次为tape和字符串区
+struct FileHeader {
+  char magic[8];
+  std::uint32_t byte_order;  // 按本机字节序写入kByteOrder
+  std::uint32_t version;
+  std::uint64_t tape_size;     // tape中字的个数
+  std::uint64_t strings_size;  // 字符串区的字节数
+};
+
+static_assert(sizeof(FileHeader) == 32, "tape must stay 8-byte aligned");
+
+const char kMagic[8] = {'J', 'S', 'O', 'N', 'T', 'A', 'P', 'E'};
+const std::uint32_t kByteOrder = 0x01020304;
+const std::uint32_t kVersion = 1;
+
+FileHeader MakeHeader(std::size_t tape_size, std::size_t strings_size) {
+  FileHeader header;
+  std::memcpy(header.magic, kMagic, sizeof(kMagic));
+  header.byte_order = kByteOrder;
+  header.version = kVersion;
+  header.tape_size = tape_size;
+  header.strings_size = strings_size;
+  return header;
+}
+
+}  // namespace
+
+JsonView::Iterator::Iterator(const JsonView &container, std::size_t index)
+    : tape_(container.tape_),
+      strings_(container.strings_),
+      is_object_(TagOf(container.tape_[container.index_]) == '{'),
+      index_(index) {}
+
+StringView JsonView::Iterator::Key() const {
+  return StringAt(tape_, strings_, index_);
+}
+
+JsonView JsonView::Iterator::Value() const {
+  return JsonView(tape_, strings_, is_object_ ? index_ + 2 : index_);
+}
+
+JsonView::Iterator &JsonView::Iterator::operator++() {
+  index_ = SkipValue(tape_, is_object_ ? index_ + 2 : index_);
+  return *this;
+}
+
+Json::JsonType JsonView::Type() const {
+  switch (TagOf(tape_[index_])) {
+    case 't':
+    case 'f':
+      return Json::kBool;
+    case 'l':
+      return Json::kInt;
+    case 'd':
+      return Json::kDouble;
+    case 's':
+      return Json::kString;
+    case '[':
+      return Json::kArray;
+    case '{':
+      return Json::kObject;
+    default:
+      return Json::kNull;
+  }
+}
+
+bool JsonView::GetBool() const {
+  if (Type() != Json::kBool) {
+    throw std::logic_error(
+        "function JsonView::GetBool() type error, require bool");
+  }
+  return TagOf(tape_[index_]) == 't';
+}
+
+long long JsonView::GetInteger() const {
+  if (Type() != Json::kInt) {
+    throw std::logic_error(
+        "function JsonView::GetInteger() type error, require Integer");
+  }
+  return static_cast<long long>(tape_[index_ + 1]);
+}
+
+double JsonView::GetDouble() const {
+  if (Type() != Json::kDouble) {
+    throw std::logic_error(
+        "function JsonView::GetDouble() type error, require double");
+  }
+  double value;
+  std::memcpy(&value, &tape_[index_ + 1], sizeof(value));
+  return value;
+}
+
+StringView JsonView::GetString() const {
+  if (Type() != Json::kString) {
+    throw std::logic_error(
+        "function JsonView::GetString() type error, require string");
+  }
+  return StringAt(tape_, strings_, index_);
+}
+
+std::size_t JsonView::Size() const {
+  Json::JsonType type = Type();
+  if (type != Json::kArray && type != Json::kObject) {
+    throw std::logic_error(
+        "function JsonView::Size() type error, requires array or object");
+  }
+  return tape_[index_ + 1];
+}
+
+bool JsonView::Find(StringView key, JsonView &value) const {
+  if (Type() != Json::kObject) {
+    throw std::logic_error(
+        "function JsonView::Find() type error, requires object");
+  }
+  // 与Parser一致，重复的key以最后一次出现的为准
+  bool found = false;
+  std::size_t end = PayloadOf(tape_[index_]);
+  for (std::size_t i = index_ + 2; i != end; i = SkipValue(tape_, i + 2)) {
+    if (StringAt(tape_, strings_, i) == key) {
+      value = JsonView(tape_, strings_, i + 2);
+      found = true;
+    }
+  }
+  return found;
+}
+
+JsonView JsonView::operator[](const char *key) const {
+  JsonView value = *this;
+  if (!Find(key, value)) {
+    throw std::logic_error(std::string("function JsonView::operator[]() key ") +
+                           key + " not found");
+  }
+  return value;
+}
+
+JsonView JsonView::operator[](const std::string &key) const {
+  return (*this)[key.c_str()];
+}
+
+JsonView JsonView::operator[](const int index) const {
+  if (Type() != Json::kArray) {
+    throw std::logic_error(
+        "function JsonView::operator[](const int) type error, requires array");
+  }
+  if (index < 0 || static_cast<std::size_t>(index) >= tape_[index_ + 1]) {
+    throw std::logic_error(
+        "function JsonView::operator[](const int) index out of range");
+  }
+  std::size_t i = index_ + 2;
+  for (int n = 0; n < index; ++n) {
+    i = SkipValue(tape_, i);
+  }
+  return JsonView(tape_, strings_, i);
+}
+
+JsonView::Iterator JsonView::begin() const {
+  Size();  // 检查类型
+  return Iterator(*this, index_ + 2);
+}
+
+JsonView::Iterator JsonView::end() const {
+  Size();
+  return Iterator(*this, PayloadOf(tape_[index_]));
+}
+
+Json JsonView::ToJson() const {
+  switch (Type()) {
+    case Json::kBool:
+      return Json(GetBool());
+    case Json::kInt:
+      return Json(GetInteger());
+    case Json::kDouble:
+      return Json(GetDouble());
+    case Json::kString:
+      return Json(GetString());
+    case Json::kArray: {
+      Json::ArrayType array;
+      array.reserve(Size());
+      for (const Iterator &child : *this) {
+        array.push_back(child.Value().ToJson());
+      }
+      return Json(std::move(array));
+    }
+    case Json::kObject: {
+      Json json(Json::kObject);
+      Json::ObjectType &object = json.GetObject();
+      for (const Iterator &child : *this) {
+        // 重复的key以最后一次出现的值为准，与Find()和Parser一致
+        object[child.Key().ToString()] = child.Value().ToJson();
+      }
+      return json;
+    }
+    default:
+      return Json();
+  }
+}
+
+TapeDocument TapeDocument::Parse(const char *data, std::size_t length) {
+  TapeDocument document;
+  TapeBuilder builder(document.tape_storage_, document.string_storage_);
+  Parser(data, length).Parse(builder);
+  document.Attach();
+  return document;
+}
+
+TapeDocument TapeDocument::FromJson(const Json &json) {
+  TapeDocument document;
+  TapeBuilder builder(document.tape_storage_, document.string_storage_);
+  EmitEvents(json, builder);
+  document.Attach();
+  return document;
+}
+
+TapeDocument TapeDocument::Load(const std::string &path) {
+  std::shared_ptr<MappedFile> file = std::make_shared<MappedFile>(path);
+  TapeDocument document = Load(file->Data(), file->Size());
+  document.file_ = std::move(file);
+  return document;
+}
+
+TapeDocument TapeDocument::Load(const char *data, std::size_t length) {
+  FileHeader header;
+  if (length < sizeof(header)) {
+    throw std::logic_error("invalid tape document: file too short");
+  }
+  std::memcpy(&header, data, sizeof(header));
+  if (std::memcmp(header.magic, kMagic, sizeof(kMagic)) != 0 ||
+      header.byte_order != kByteOrder || header.version != kVersion) {
+    throw std::logic_error("invalid tape document: bad header");
+  }
+  std::size_t available = length - sizeof(header);
+  if (header.tape_size == 0 || header.tape_size > available / 8 ||
+      header.strings_size > available - header.tape_size * 8) {
+    throw std::logic_error("invalid tape document: truncated");
+  }
+
+  TapeDocument document;
+  const char *tape = data + sizeof(header);
+  const char *strings = tape + header.tape_size * 8;
+  if (reinterpret_cast<std::uintptr_t>(tape) % alignof(std::uint64_t) == 0) {
+    document.tape_ = reinterpret_cast<const std::uint64_t *>(tape);
+    document.tape_size_ = header.tape_size;
+    document.strings_ = strings;
+    document.strings_size_ = header.strings_size;
+    return document;
+  }
+
+  // 未对齐时复制到自身的存储
+  document.tape_storage_.resize(header.tape_size);
+  std::memcpy(document.tape_storage_.data(), tape, header.tape_size * 8);
+  document.string_storage_.assign(strings, strings + header.strings_size);
+  document.Attach();
+  return document;
+}
+
+TapeDocument::~TapeDocument() {}
+
+void TapeDocument::Save(const std::string &path) const {
+  // 直接写入文件，不在内存中拼接完整的内容
+  FileHeader header = MakeHeader(tape_size_, strings_size_);
+  std::ofstream ofs(path, std::ios::binary | std::ios::trunc);
+  ofs.write(reinterpret_cast<const char *>(&header), sizeof(header));
+  ofs.write(reinterpret_cast<const char *>(tape_), tape_size_ * 8);
+  ofs.write(strings_, strings_size_);
+  if (!ofs) {
+    throw std::runtime_error("write \"" + path + "\" failed");
+  }
+}
+
+void TapeDocument::Serialize(std::string &output) const {
+  FileHeader header = MakeHeader(tape_size_, strings_size_);
+  output.reserve(output.size() + sizeof(header) + tape_size_ * 8 +
+                 strings_size_);
+  output.append(reinterpret_cast<const char *>(&header), sizeof(header));
+  output.append(reinterpret_cast<const char *>(tape_), tape_size_ * 8);
+  if (strings_size_ != 0) {
+    output.append(strings_, strings_size_);
+  }
+}
+
+void TapeDocument::Attach() {
+  tape_ = tape_storage_.data();
+  tape_size_ = tape_storage_.size();
+  strings_ = string_storage_.data();
+  strings_size_ = string_storage_.size();
+}
+
+}  // namespace jsoncpp
+}  // namespace jiayuancs
@@ -0,0 +1,65 @@
+#include "tracer.h"
+
+#ifdef JSONCPP_TRACE
+
+#include <cstdio>
+#include <sstream>
+
+namespace jiayuancs {
+namespace jsoncpp {
+
+RingBufferTracer::RingBufferTracer(std::size_t capacity)
+    : entries_(capacity > 0 ? capacity : 1) {}
+
+void RingBufferTracer::OnToken(std::size_t offset, int token) {
+  const std::size_t capacity = entries_.size();
+  if (total_ != 0 && entries_[(total_ - 1) % capacity].offset == offset) {
+    return;
+  }
+  entries_[total_ % capacity] = Entry{offset, token};
+  ++total_;
+}
+
+void RingBufferTracer::OnError(std::size_t offset,
+                               const std::string &message) {
+  error_offset_ = offset;
+  error_ = message;
+}
+
+std::vector<RingBufferTracer::Entry> RingBufferTracer::Entries() const {
+  std::vector<Entry> result;
+  std::size_t count = total_ < entries_.size() ? total_ : entries_.size();
+  result.reserve(count);
+  for (std::size_t i = total_ - count; i < total_; ++i) {
+    result.push_back(entries_[i % entries_.size()]);
+  }
+  return result;
+}
+
+std::string RingBufferTracer::Dump() const {
+  std::ostringstream output;
+  for (const Entry &entry : Entries()) {
+    output << entry.offset << ": ";
+    if (entry.token == EOF) {
+      output << "EOF";
+    } else {
+      output << static_cast<char>(entry.token);
+    }
+    output << '\n';
+  }
+  if (!error_.empty()) {
+    output << error_offset_ << ": " << error_ << '\n';
+  }
+  return output.str();
+}
+
+void RingBufferTracer::Clear() {
+  total_ = 0;
+  error_offset_ = 0;
+  error_.clear();
+}
+
+}  // namespace jsoncpp
+}  // namespace jiayuancs
+
+#endif  // JSONCPP_TRACE
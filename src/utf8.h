@@ -0,0 +1,33 @@
+// UTF-8编码(库内部使用)
+
+#ifndef JSONCPP_SRC_UTF8_H_
+#define JSONCPP_SRC_UTF8_H_
+
+#include <string>
+
+namespace jiayuancs {
+namespace jsoncpp {
+
+// 将码点按UTF-8编码追加到output末尾
+inline void AppendUtf8(unsigned code_point, std::string &output) {
+  if (code_point < 0x80) {
+    output += static_cast<char>(code_point);
+  } else if (code_point < 0x800) {
+    output += static_cast<char>(0xC0 | (code_point >> 6));
+    output += static_cast<char>(0x80 | (code_point & 0x3F));
+  } else if (code_point < 0x10000) {
+    output += static_cast<char>(0xE0 | (code_point >> 12));
+    output += static_cast<char>(0x80 | ((code_point >> 6) & 0x3F));
+    output += static_cast<char>(0x80 | (code_point & 0x3F));
+  } else {
+    output += static_cast<char>(0xF0 | (code_point >> 18));
+    output += static_cast<char>(0x80 | ((code_point >> 12) & 0x3F));
+    output += static_cast<char>(0x80 | ((code_point >> 6) & 0x3F));
+    output += static_cast<char>(0x80 | (code_point & 0x3F));
+  }
+}
+
+}  // namespace jsoncpp
+}  // namespace jiayuancs
+
+#endif  // JSONCPP_SRC_UTF8_H_
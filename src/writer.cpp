@@ -0,0 +1,203 @@
+#include "writer.h"
+
+#include "number_writer.h"
+
+#if defined(__SSE2__)
+#define JSONCPP_SSE2 1
+#include <emmintrin.h>
+#endif
+
+namespace jiayuancs {
+namespace jsoncpp {
+
+namespace {
+
+// 需要转义的字符：引号、反斜杠和0x20以下的控制字符
+bool NeedEscape(unsigned char ch) {
+  return ch < 0x20 || ch == '\"' || ch == '\\';
+}
+
+// 返回[cur, end)中第一个需要转义的字符的位置，不存在时返回end
+const char *FindEscape(const char *cur, const char *end) {
+#ifdef JSONCPP_SSE2
+  const __m128i quote = _mm_set1_epi8('\"');
+  const __m128i backslash = _mm_set1_epi8('\\');
+  const __m128i control = _mm_set1_epi8(0x1F);
+  for (; end - cur >= 16; cur += 16) {
+    __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i *>(cur));
+    // 无符号比较：max(ch, 0x1F) == 0x1F即ch <= 0x1F
+    __m128i mask = _mm_or_si128(
+        _mm_or_si128(_mm_cmpeq_epi8(chunk, quote),
+                     _mm_cmpeq_epi8(chunk, backslash)),
+        _mm_cmpeq_epi8(_mm_max_epu8(chunk, control), control));
+    int bits = _mm_movemask_epi8(mask);
+    if (bits != 0) {
+      return cur + __builtin_ctz(static_cast<unsigned>(bits));
+    }
+  }
+#endif
+  while (cur != end && !NeedEscape(static_cast<unsigned char>(*cur))) {
+    ++cur;
+  }
+  return cur;
+}
+
+}  // namespace
+
+void Writer::Write(const Json &json) {
+  output_.reserve(output_.size() + EstimateSize(json));
+  WriteValue(json, 0);
+}
+
+void Writer::WriteValue(const Json &json, unsigned depth) {
+  switch (json.Type()) {
+    case Json::kNull:
+      output_.append("null", 4);
+      break;
+    case Json::kBool:
+      if (json.GetBool()) {
+        output_.append("true", 4);
+      } else {
+        output_.append("false", 5);
+      }
+      break;
+    case Json::kInt: {
+      char buffer[number::kMaxNumberLength];
+      output_.append(buffer, number::WriteInteger(json.GetInteger(), buffer));
+      break;
+    }
+    case Json::kDouble: {
+      char buffer[number::kMaxNumberLength];
+      output_.append(buffer, number::WriteDouble(json.GetDouble(), buffer));
+      break;
+    }
+    case Json::kString:
+      WriteString(json.GetString());
+      break;
+    case Json::kArray: {
+      const Json::ArrayType &array = json.GetConstArray();
+      output_.push_back('[');
+      for (auto it = array.cbegin(); it != array.cend(); ++it) {
+        if (it != array.cbegin()) {
+          output_.append(indent_ == 0 ? ", " : ",");
+        }
+        WriteNewLine(depth + 1);
+        WriteValue(*it, depth + 1);
+      }
+      if (!array.empty()) {
+        WriteNewLine(depth);
+      }
+      output_.push_back(']');
+      break;
+    }
+    case Json::kObject: {
+      const Json::ObjectType &object = json.GetConstObject();
+      output_.push_back('{');
+      for (auto it = object.cbegin(); it != object.cend(); ++it) {
+        if (it != object.cbegin()) {
+          output_.append(indent_ == 0 ? ", " : ",");
+        }
+        WriteNewLine(depth + 1);
+        WriteString(it->first);
+        output_.append(indent_ == 0 ? " : " : ": ");
+        WriteValue(it->second, depth + 1);
+      }
+      if (!object.empty()) {
+        WriteNewLine(depth);
+      }
+      output_.push_back('}');
+      break;
+    }
+    default:
+      break;
+  }
+}
+
+void Writer::WriteString(StringView value) {
+  static const char kHexDigits[] = "0123456789abcdef";
+
+  output_.push_back('\"');
+  const char *cur = value.begin();
+  const char *end = value.end();
+  for (;;) {
+    // 整段复制不需要转义的字符
+    const char *run = cur;
+    cur = FindEscape(cur, end);
+    output_.append(run, cur);
+    if (cur == end) {
+      break;
+    }
+
+    unsigned char ch = static_cast<unsigned char>(*cur++);
+    switch (ch) {
+      case '\"':
+        output_.append("\\\"", 2);
+        break;
+      case '\\':
+        output_.append("\\\\", 2);
+        break;
+      case '\b':
+        output_.append("\\b", 2);
+        break;
+      case '\f':
+        output_.append("\\f", 2);
+        break;
+      case '\n':
+        output_.append("\\n", 2);
+        break;
+      case '\r':
+        output_.append("\\r", 2);
+        break;
+      case '\t':
+        output_.append("\\t", 2);
+        break;
+      default: {
+        char escape[] = {'\\', 'u', '0', '0', kHexDigits[ch >> 4],
+                         kHexDigits[ch & 0xF]};
+        output_.append(escape, sizeof(escape));
+        break;
+      }
+    }
+  }
+  output_.push_back('\"');
+}
+
+void Writer::WriteNewLine(unsigned depth) {
+  if (indent_ == 0) {
+    return;
+  }
+  output_.push_back('\n');
+  output_.append(static_cast<std::size_t>(depth) * indent_, ' ');
+}
+
+std::size_t Writer::EstimateSize(const Json &json) {
+  switch (json.Type()) {
+    case Json::kNull:
+    case Json::kBool:
+      return 5;
+    case Json::kInt:
+    case Json::kDouble:
+      return 20;
+    case Json::kString:
+      return json.GetString().size() + 2;
+    case Json::kArray: {
+      std::size_t size = 2;
+      for (const Json &element : json.GetConstArray()) {
+        size += EstimateSize(element) + 2;
+      }
+      return size;
+    }
+    case Json::kObject: {
+      std::size_t size = 2;
+      for (const auto &member : json.GetConstObject()) {
+        size += member.first.size() + 5 + EstimateSize(member.second);
+      }
+      return size;
+    }
+    default:
+      return 0;
+  }
+}
+
+}  // namespace jsoncpp
+}  // namespace jiayuancs
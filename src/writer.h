@@ -0,0 +1,41 @@
+// 将Json对象序列化到连续的字符缓冲区(库内部使用)
+
+#ifndef JSONCPP_SRC_WRITER_H_
+#define JSONCPP_SRC_WRITER_H_
+
+#include <cstddef>
+#include <string>
+
+#include "json.h"
+
+namespace jiayuancs {
+namespace jsoncpp {
+
+// 序列化结果追加到output末尾，写入前按估算的长度预留空间
+// indent为0时输出紧凑格式，否则每个元素单独一行，每层缩进indent个空格
+// 字符串中的引号、反斜杠和控制字符按JSON规则转义
+class Writer final {
+ public:
+  Writer(std::string &output, unsigned indent)
+      : output_(output), indent_(indent) {}
+
+  void Write(const Json &json);
+  // 输出一个带引号的字符串，也供binding::Output使用
+  void WriteString(StringView value);
+
+ private:
+  void WriteValue(const Json &json, unsigned depth);
+  // 换行并缩进到第depth层(仅indent_不为0时)
+  void WriteNewLine(unsigned depth);
+
+  // 估算序列化结果的长度(不含缩进)
+  static std::size_t EstimateSize(const Json &json);
+
+  std::string &output_;
+  unsigned indent_;
+};
+
+}  // namespace jsoncpp
+}  // namespace jiayuancs
+
+#endif  // JSONCPP_SRC_WRITER_H_
@@ -0,0 +1,122 @@
+// 测试Arena及基于Arena的Json对象树
+
+#include "arena.h"
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "json.h"
+#include "parser.h"
+
+using namespace jiayuancs::jsoncpp;
+using namespace std;
+
+namespace {
+
+int cleanup_count = 0;
+
+void CountCleanup(void *object) {
+  cleanup_count += *static_cast<int *>(object);
+}
+
+const char *kDocument =
+    "{\"short\": \"abc\", \"a key that is longer than inline capacity\": "
+    "\"a string value that is longer than the inline capacity\", "
+    "\"array\": [1, 2.5, true, null, [\"nested\", {\"x\": []}]], "
+    "\"dup\": 1, \"dup\": \"a duplicated key with a long string value\"}";
+
+}  // namespace
+
+TEST(ArenaTest, Allocate) {
+  Arena arena(128);
+  EXPECT_EQ(arena.BytesUsed(), 0);
+
+  for (size_t alignment : {1, 2, 4, 8, 16}) {
+    void *pointer = arena.Allocate(3, alignment);
+    EXPECT_EQ(reinterpret_cast<uintptr_t>(pointer) % alignment, 0);
+  }
+  EXPECT_EQ(arena.BytesUsed(), 15);
+
+  // 超过内存块大小的分配
+  char *large = static_cast<char *>(arena.Allocate(1000, 8));
+  large[999] = 'x';
+  EXPECT_GE(arena.BytesReserved(), 1000);
+
+  arena.Reset();
+  EXPECT_EQ(arena.BytesUsed(), 0);
+  EXPECT_EQ(arena.BytesReserved(), 0);
+};
+
+TEST(ArenaTest, CallerBuffer) {
+  alignas(8) char buffer[256];
+  Arena arena(buffer, sizeof(buffer));
+  char *pointer = static_cast<char *>(arena.Allocate(100, 8));
+  EXPECT_TRUE(pointer >= buffer && pointer + 100 <= buffer + sizeof(buffer));
+  EXPECT_EQ(arena.BytesReserved(), 0);
+
+  // 缓冲区用完后从堆上分配
+  arena.Allocate(200, 8);
+  EXPECT_GT(arena.BytesReserved(), 0);
+
+  arena.Reset();
+  EXPECT_EQ(arena.Allocate(100, 8), pointer);
+};
+
+TEST(ArenaTest, Cleanup) {
+  cleanup_count = 0;
+  int one = 1;
+  int ten = 10;
+  {
+    Arena arena;
+    arena.AddCleanup(CountCleanup, &one);
+    arena.AddCleanup(CountCleanup, &ten);
+    arena.Reset();
+    EXPECT_EQ(cleanup_count, 11);
+
+    arena.AddCleanup(CountCleanup, &one);
+  }
+  EXPECT_EQ(cleanup_count, 12);
+};
+
+TEST(ArenaTest, ParseIntoArena) {
+  Json heap = Parser(kDocument).Parse();
+
+  Arena arena(1024);
+  {
+    Json json = Parser(kDocument).Parse(arena);
+    EXPECT_EQ(json, heap);
+    EXPECT_GT(arena.BytesUsed(), 0);
+    EXPECT_EQ(json["dup"], "a duplicated key with a long string value");
+
+    // 拷贝得到的对象位于堆上，不受arena释放的影响
+    Json copy = json;
+    Json array_copy = json["array"];
+    arena.Reset();
+    EXPECT_EQ(copy, heap);
+    EXPECT_EQ(array_copy, heap["array"]);
+  }
+
+  // 重置后可以继续使用
+  Json json = Parser("[\"again\", {\"k\": [1, 2, 3]}]").Parse(arena);
+  EXPECT_EQ(json, Parser("[\"again\", {\"k\": [1, 2, 3]}]").Parse());
+};
+
+TEST(ArenaTest, ArenaConstructors) {
+  Arena arena;
+  Json array(Json::kArray, arena);
+  EXPECT_TRUE(array.IsArray());
+  array.GetArray().emplace_back(string(100, 'x'), arena);
+  array.GetArray().emplace_back(42);
+  array.GetArray().emplace_back(Json::kObject, arena);
+  array[2]["key"] = 3.5;
+  EXPECT_EQ(array, Json({string(100, 'x'), 42, Json(Json::ObjectType{
+                                                    {"key", 3.5}})}));
+
+  Json moved = std::move(array);
+  EXPECT_TRUE(array.IsNull());
+  EXPECT_EQ(moved[1], 42);
+  EXPECT_EQ(Json(Json::kString, arena), "");
+  EXPECT_EQ(Json(Json::kInt, arena), 0);
+};
@@ -0,0 +1,148 @@
+// 测试ArrayIndex
+
+#include "array_index.h"
+
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "json.h"
+#include "parser.h"
+
+using namespace jiayuancs::jsoncpp;
+using namespace std;
+
+TEST(ArrayIndexTest, Find) {
+  Json users = Parser(
+                   "[{\"id\": 3, \"name\": \"a\", \"tag\": \"x\"},"
+                   " {\"id\": 1, \"name\": \"b\", \"tag\": \"y\"},"
+                   " {\"name\": \"c\", \"tag\": \"x\"},"
+                   " {\"id\": 1.0, \"name\": \"d\", \"tag\": [1]},"
+                   " 5,"
+                   " {\"id\": 7, \"name\": \"e\", \"tag\": \"x\"}]")
+                   .Parse();
+
+  ArrayIndex by_id(users, "id");
+  EXPECT_EQ(by_id.Size(), 4);
+  size_t position = 0;
+  ASSERT_TRUE(by_id.Find(1, position));
+  EXPECT_EQ(position, 1);
+  ASSERT_TRUE(by_id.Find(1.0, position));  // 整数与浮点数不相等
+  EXPECT_EQ(position, 3);
+  ASSERT_TRUE(by_id.Find(7, position));
+  EXPECT_EQ(users[static_cast<int>(position)]["name"].GetString(), "e");
+  EXPECT_FALSE(by_id.Find(2, position));
+  EXPECT_FALSE(by_id.Find("1", position));
+  EXPECT_FALSE(by_id.Find(Json(Json::kArray), position));
+
+  // 重复的值按下标升序返回，值为array的元素不被索引
+  ArrayIndex by_tag(users, "tag");
+  EXPECT_EQ(by_tag.Size(), 4);
+  EXPECT_EQ(by_tag.FindAll("x"), vector<size_t>({0, 2, 5}));
+  EXPECT_EQ(by_tag.Count("x"), 3);
+  EXPECT_EQ(by_tag.Count("y"), 1);
+  EXPECT_TRUE(by_tag.FindAll("z").empty());
+
+  // 按元素自身的值索引
+  ArrayIndex by_self(users, "");
+  EXPECT_EQ(by_self.Size(), 1);
+  ASSERT_TRUE(by_self.Find(5, position));
+  EXPECT_EQ(position, 4);
+
+  EXPECT_THROW(ArrayIndex(users[0], "id"), logic_error);
+
+  // 大量元素，只有少数几种不同的值
+  Json records(Json::kArray);
+  for (int i = 0; i < 100000; ++i) {
+    Json &record = records.EmplaceBack(Json::kObject);
+    record["id"] = "user" + to_string(i);
+    record["group"] = i % 3;
+  }
+  ArrayIndex by_name(records, "id");
+  ASSERT_TRUE(by_name.Find("user54321", position));
+  EXPECT_EQ(position, 54321);
+  EXPECT_EQ(ArrayIndex(records, "group").Count(2), 33333);
+}
+
+TEST(ArrayIndexTest, JsonPointer) {
+  Json items = Parser(
+                   "[{\"user\": {\"id\": \"u1\"}, \"a/b\": 1, \"m~n\": 2,"
+                   "  \"list\": [10, 20]},"
+                   " {\"user\": {\"id\": \"u2\"}, \"a/b\": 3, \"m~n\": 4,"
+                   "  \"list\": [30]},"
+                   " {\"user\": null}]")
+                   .Parse();
+
+  size_t position = 0;
+  ArrayIndex by_user(items, "/user/id");
+  EXPECT_EQ(by_user.Size(), 2);
+  ASSERT_TRUE(by_user.Find("u2", position));
+  EXPECT_EQ(position, 1);
+
+  ASSERT_TRUE(ArrayIndex(items, "/a~1b").Find(3, position));
+  EXPECT_EQ(position, 1);
+  ASSERT_TRUE(ArrayIndex(items, "/m~0n").Find(2, position));
+  EXPECT_EQ(position, 0);
+  ASSERT_TRUE(ArrayIndex(items, "/list/1").Find(20, position));
+  EXPECT_EQ(position, 0);
+  EXPECT_EQ(ArrayIndex(items, "/list/01").Size(), 0);
+  // 不以'/'开头时视为字段名
+  EXPECT_EQ(ArrayIndex(items, "user/id").Size(), 0);
+
+  EXPECT_THROW(ArrayIndex(items, "/a~2b"), logic_error);
+  EXPECT_THROW(ArrayIndex(items, "/a~"), logic_error);
+}
+
+TEST(ArrayIndexTest, Rebuild) {
+  Json users(Json::kArray);
+  users.GetArray().reserve(4);
+  users.PushBack(Parser("{\"id\": 1}").Parse());
+  users.PushBack(Parser("{\"id\": 2}").Parse());
+
+  ArrayIndex index(users, "id");
+  EXPECT_FALSE(index.Stale());
+
+  size_t position = 0;
+  users.GetArray().push_back(Parser("{\"id\": 3}").Parse());
+  EXPECT_TRUE(index.Stale());
+  EXPECT_THROW(index.Find(3, position), logic_error);
+  EXPECT_THROW(index.FindAll(3), logic_error);
+  index.Rebuild();
+  EXPECT_FALSE(index.Stale());
+  ASSERT_TRUE(index.Find(3, position));
+  EXPECT_EQ(position, 2);
+
+  // 通过operator[]原地修改被索引的字段不会被检测到，需要手动重建
+  users[0]["id"] = 10;
+  EXPECT_FALSE(index.Stale());
+  EXPECT_FALSE(index.Find(1, position));
+  index.Rebuild();
+  ASSERT_TRUE(index.Find(10, position));
+  EXPECT_EQ(position, 0);
+
+  // 元素个数和存储位置不变的修改通过修改计数检测
+  users.GetArray().pop_back();
+  users.GetArray().push_back(Parser("{\"id\": 4}").Parse());
+  EXPECT_TRUE(index.Stale());
+  index.Rebuild();
+  EXPECT_EQ(users.GetConstArray().size(), 3);
+  EXPECT_FALSE(index.Stale());
+  users.PushBack(Parser("{\"id\": 5}").Parse());
+  EXPECT_TRUE(index.Stale());
+  index.Rebuild();
+
+  // 整体赋值，即使新array恰好复用了原来的存储空间
+  Json same_size(Json::kArray);
+  same_size.GetArray().resize(4);
+  users = same_size;
+  EXPECT_TRUE(index.Stale());
+  index.Rebuild();
+  users = Json("short");
+  users = same_size;
+  EXPECT_TRUE(index.Stale());
+
+  users = Json();
+  EXPECT_TRUE(index.Stale());
+  EXPECT_THROW(index.Rebuild(), logic_error);
+}
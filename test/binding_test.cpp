@@ -0,0 +1,136 @@
+// 测试结构体与JSON的直接绑定
+
+#include "binding.h"
+
+#include <map>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "json.h"
+#include "parser.h"
+
+using namespace jiayuancs::jsoncpp;
+using namespace std;
+
+namespace shop {
+
+struct Item {
+  string sku;
+  int count = 0;
+};
+JSONCPP_BIND(Item, sku, count)
+
+struct Order {
+  long long id = 0;
+  double price = 0;
+  bool paid = false;
+  vector<Item> items;
+  map<string, vector<unsigned>> tags;
+};
+JSONCPP_BIND(Order, id, price, paid, items, tags)
+
+}  // namespace shop
+
+namespace {
+
+const char *kOrder =
+    "{\"id\": 42, \"price\": 10, \"paid\": true, \"unknown\": {\"a\": [1, {}]},"
+    " \"items\": [{\"sku\": \"a\\\"b\", \"count\": 2}, {\"sku\": \"c\"}],"
+    " \"tags\": {\"x\": [1, 2], \"y\": []}, \"extra\": null}";
+
+}  // namespace
+
+TEST(BindingTest, Parse) {
+  shop::Order order;
+  binding::Parse(kOrder, order);
+  EXPECT_EQ(order.id, 42);
+  EXPECT_EQ(order.price, 10.0);
+  EXPECT_TRUE(order.paid);
+  ASSERT_EQ(order.items.size(), 2u);
+  EXPECT_EQ(order.items[0].sku, "a\"b");
+  EXPECT_EQ(order.items[0].count, 2);
+  EXPECT_EQ(order.items[1].sku, "c");
+  EXPECT_EQ(order.items[1].count, 0);
+  EXPECT_EQ(order.tags.size(), 2u);
+  EXPECT_EQ(order.tags["x"], (vector<unsigned>{1, 2}));
+  EXPECT_TRUE(order.tags["y"].empty());
+
+  // 再次解析时容器被清空，未出现的成员保持原值
+  binding::Parse("{\"items\": [{\"count\": 1}], \"tags\": {}}", order);
+  EXPECT_EQ(order.id, 42);
+  ASSERT_EQ(order.items.size(), 1u);
+  EXPECT_EQ(order.items[0].count, 1);
+  EXPECT_TRUE(order.tags.empty());
+
+  // 顶层也可以是容器或标量
+  vector<shop::Item> items;
+  binding::Parse("[{\"sku\": \"s\", \"count\": -3}]", items);
+  ASSERT_EQ(items.size(), 1u);
+  EXPECT_EQ(items[0].count, -3);
+  double value = 0;
+  Parser parser("1.5");
+  binding::Parse(parser, value);
+  EXPECT_EQ(value, 1.5);
+}
+
+TEST(BindingTest, Dump) {
+  shop::Order order;
+  binding::Parse(kOrder, order);
+  string text = binding::Dump(order);
+  EXPECT_EQ(Parser(text).Parse(),
+            Parser("{\"id\": 42, \"price\": 10.0, \"paid\": true,"
+                   " \"items\": [{\"sku\": \"a\\\"b\", \"count\": 2},"
+                   " {\"sku\": \"c\", \"count\": 0}],"
+                   " \"tags\": {\"x\": [1, 2], \"y\": []}}")
+                .Parse());
+
+  // 输出格式与Json::dump()相同，成员按绑定的顺序输出
+  shop::Item item{"s\n", 7};
+  EXPECT_EQ(binding::Dump(item), "{\"sku\" : \"s\\n\", \"count\" : 7}");
+  EXPECT_EQ(binding::Dump(vector<int>{}), "[]");
+  EXPECT_EQ(binding::Dump(map<string, int>{{"a", 1}, {"b", 2}}),
+            "{\"a\" : 1, \"b\" : 2}");
+
+  // 无符号整数按完整的取值范围输出
+  EXPECT_EQ(binding::Dump(vector<unsigned long long>{18446744073709551615ULL,
+                                                     0}),
+            "[18446744073709551615, 0]");
+  EXPECT_EQ(binding::Dump(vector<long long>{-9223372036854775807LL - 1}),
+            "[-9223372036854775808]");
+  unsigned long long large = 0;
+  binding::Parse("9223372036854775807", large);
+  EXPECT_EQ(large, 9223372036854775807ULL);
+  // 大于INT64_MAX的整数被解析为double，不能读入整数成员
+  EXPECT_THROW(binding::Parse("9223372036854775808", large), logic_error);
+
+  // 序列化后再解析得到相同的结构体
+  shop::Order copy;
+  binding::Parse(text, copy);
+  EXPECT_EQ(binding::Dump(copy), text);
+}
+
+TEST(BindingTest, Errors) {
+  shop::Order order;
+  EXPECT_THROW(binding::Parse("{\"id\": \"42\"}", order), logic_error);
+  EXPECT_THROW(binding::Parse("{\"id\": 1.5}", order), logic_error);
+  EXPECT_THROW(binding::Parse("{\"items\": {}}", order), logic_error);
+  EXPECT_THROW(binding::Parse("{\"items\": [1]}", order), logic_error);
+  EXPECT_THROW(binding::Parse("{\"paid\": null}", order), logic_error);
+  EXPECT_THROW(binding::Parse("[]", order), logic_error);
+  // 整数超出成员类型的范围
+  EXPECT_THROW(binding::Parse("{\"tags\": {\"x\": [-1]}}", order),
+               logic_error);
+  EXPECT_THROW(binding::Parse("{\"items\": [{\"count\": 4294967296}]}", order),
+               logic_error);
+  // 语法错误
+  EXPECT_THROW(binding::Parse("{\"id\": 1", order), logic_error);
+
+  try {
+    binding::Parse("{\"price\": \"free\"}", order);
+    FAIL();
+  } catch (const logic_error &e) {
+    EXPECT_STREQ(e.what(), "binding error: expected number, but got string");
+  }
+}
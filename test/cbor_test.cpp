@@ -0,0 +1,126 @@
+// 测试Json与CBOR之间的转换
+
+#include "cbor.h"
+
+#include <cmath>
+#include <cstdlib>
+#include <limits>
+#include <stdexcept>
+#include <string>
+
+#include "gtest/gtest.h"
+#include "json.h"
+#include "parser.h"
+
+using namespace jiayuancs::jsoncpp;
+using namespace std;
+
+namespace {
+
+// 十六进制字符串转为字节
+string Bytes(const string &hex) {
+  string bytes;
+  for (size_t i = 0; i < hex.size(); i += 2) {
+    bytes += static_cast<char>(strtol(hex.substr(i, 2).c_str(), nullptr, 16));
+  }
+  return bytes;
+}
+
+}  // namespace
+
+// RFC 8949附录A中的示例
+TEST(CborTest, Encode) {
+  EXPECT_EQ(cbor::Encode(Json(0)), Bytes("00"));
+  EXPECT_EQ(cbor::Encode(Json(23)), Bytes("17"));
+  EXPECT_EQ(cbor::Encode(Json(24)), Bytes("1818"));
+  EXPECT_EQ(cbor::Encode(Json(1000)), Bytes("1903e8"));
+  EXPECT_EQ(cbor::Encode(Json(1000000)), Bytes("1a000f4240"));
+  EXPECT_EQ(cbor::Encode(Json(1000000000000LL)), Bytes("1b000000e8d4a51000"));
+  EXPECT_EQ(cbor::Encode(Json(-1)), Bytes("20"));
+  EXPECT_EQ(cbor::Encode(Json(-1000)), Bytes("3903e7"));
+  EXPECT_EQ(cbor::Encode(Json(numeric_limits<long long>::min())),
+            Bytes("3b7fffffffffffffff"));
+  EXPECT_EQ(cbor::Encode(Json(1.1)), Bytes("fb3ff199999999999a"));
+  EXPECT_EQ(cbor::Encode(Json(false)), Bytes("f4"));
+  EXPECT_EQ(cbor::Encode(Json(true)), Bytes("f5"));
+  EXPECT_EQ(cbor::Encode(Json()), Bytes("f6"));
+  EXPECT_EQ(cbor::Encode(Json("a")), Bytes("6161"));
+  EXPECT_EQ(cbor::Encode(Json("水")), Bytes("63e6b0b4"));
+  EXPECT_EQ(cbor::Encode(Parser("[1, [2, 3], [4, 5]]").Parse()),
+            Bytes("8301820203820405"));
+  EXPECT_EQ(cbor::Encode(Parser("{\"a\": 1, \"b\": [2, 3]}").Parse()),
+            Bytes("a26161016162820203"));
+}
+
+TEST(CborTest, Decode) {
+  EXPECT_EQ(cbor::Decode(Bytes("1b000000e8d4a51000")), Json(1000000000000LL));
+  EXPECT_EQ(cbor::Decode(Bytes("3903e7")), Json(-1000));
+  // 超出long long范围的整数转为double
+  EXPECT_EQ(cbor::Decode(Bytes("1bffffffffffffffff")),
+            Json(18446744073709551615.0));
+  EXPECT_EQ(cbor::Decode(Bytes("3bffffffffffffffff")),
+            Json(-18446744073709551616.0));
+  // float16和float32
+  EXPECT_EQ(cbor::Decode(Bytes("f93c00")), Json(1.0));
+  EXPECT_EQ(cbor::Decode(Bytes("f97bff")), Json(65504.0));
+  EXPECT_EQ(cbor::Decode(Bytes("f90001")), Json(5.960464477539063e-8));
+  EXPECT_EQ(cbor::Decode(Bytes("f9c400")), Json(-4.0));
+  EXPECT_TRUE(std::isinf(cbor::Decode(Bytes("f97c00")).GetDouble()));
+  EXPECT_EQ(cbor::Decode(Bytes("fa47c35000")), Json(100000.0));
+  EXPECT_EQ(cbor::Decode(Bytes("f7")), Json());
+  // 标签被忽略
+  EXPECT_EQ(cbor::Decode(Bytes("c11a514b67b0")), Json(1363896240));
+  // 不定长的字符串、数组和映射
+  EXPECT_EQ(cbor::Decode(Bytes("7f657374726561646d696e67ff")),
+            Json("streaming"));
+  EXPECT_EQ(cbor::Decode(Bytes("9f018202039f0405ffff")),
+            Parser("[1, [2, 3], [4, 5]]").Parse());
+  EXPECT_EQ(cbor::Decode(Bytes("bf61610161629f0203ffff")),
+            Parser("{\"a\": 1, \"b\": [2, 3]}").Parse());
+
+  const char *invalid[] = {"",       "18",       "1c",   "4161", "62616263",
+                           "830102", "a1016161", "9f01", "ff",   "f800",
+                           "0000"};
+  for (const char *hex : invalid) {
+    EXPECT_THROW(cbor::Decode(Bytes(hex)), logic_error) << hex;
+  }
+  // 声明的长度远超输入时不会预先分配
+  EXPECT_THROW(cbor::Decode(Bytes("9bffffffffffffffff")), logic_error);
+}
+
+TEST(CborTest, NestingLimit) {
+  // 每层数组、映射或标签只占1个字节，嵌套最多1000层
+  string nested;
+  for (int i = 0; i < 1000; ++i) {
+    nested += i % 2 == 0 ? "\x81" : "\xA1\x61\x61";
+  }
+  EXPECT_NO_THROW(cbor::Decode(nested + '\x00'));
+  for (const char *head : {"\x81", "\x9F", "\xC1"}) {
+    string hostile;
+    for (int i = 0; i < 100000; ++i) {
+      hostile += head;
+    }
+    try {
+      cbor::Decode(hostile + '\x00');
+      FAIL();
+    } catch (const logic_error &e) {
+      EXPECT_STREQ(e.what(), "invalid CBOR at byte 1001: nesting too deep");
+    }
+  }
+  EXPECT_THROW(cbor::Decode("\xC1" + nested + '\x00'), logic_error);
+}
+
+TEST(CborTest, RoundTrip) {
+  Json json = Parser(
+                  "{\"id\": 12345678901, \"name\": \"jsoncpp \\u4e2d\\u6587\", "
+                  "\"values\": [0, -1, 255, -129, 65536, 0.1, -2.5e-300, "
+                  "1e300, true, false, null], \"empty\": {\"a\": [], \"b\": "
+                  "{}}, \"long\": \"" +
+                  string(300, 'x') + "\"}")
+                  .Parse();
+  EXPECT_EQ(cbor::Decode(cbor::Encode(json)), json);
+
+  string output = "prefix";
+  cbor::Encode(json, output);
+  EXPECT_EQ(output.substr(6), cbor::Encode(json));
+}
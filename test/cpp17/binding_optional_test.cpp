@@ -0,0 +1,77 @@
+// 测试std::optional成员的绑定，该文件以C++17编译
+
+#include "binding.h"
+
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "json.h"
+#include "parser.h"
+
+using namespace jiayuancs::jsoncpp;
+using namespace std;
+
+namespace shop {
+
+struct Parcel {
+  long long id = 0;
+  optional<string> note;
+  optional<vector<int>> sizes;
+};
+JSONCPP_BIND(Parcel, id, note, sizes)
+
+}  // namespace shop
+
+TEST(BindingOptionalTest, Parse) {
+  shop::Parcel parcel;
+  binding::Parse("{\"id\": 1, \"note\": \"fragile\", \"sizes\": [3, 4]}",
+                 parcel);
+  EXPECT_EQ(parcel.note, "fragile");
+  EXPECT_EQ(parcel.sizes, (vector<int>{3, 4}));
+
+  // null清空optional，未出现的成员保持原值
+  binding::Parse("{\"note\": null}", parcel);
+  EXPECT_FALSE(parcel.note.has_value());
+  EXPECT_EQ(parcel.sizes, (vector<int>{3, 4}));
+
+  // 类型不匹配时的错误信息使用内部类型
+  try {
+    binding::Parse("{\"note\": 1}", parcel);
+    FAIL();
+  } catch (const logic_error &e) {
+    EXPECT_STREQ(e.what(), "binding error: expected string, but got integer");
+  }
+
+  // 顶层也可以是optional
+  optional<vector<int>> values;
+  binding::Parse("[1, 2]", values);
+  EXPECT_EQ(values, (vector<int>{1, 2}));
+  binding::Parse("null", values);
+  EXPECT_FALSE(values.has_value());
+}
+
+TEST(BindingOptionalTest, Dump) {
+  // 空的optional成员不输出
+  shop::Parcel parcel;
+  parcel.id = 7;
+  EXPECT_EQ(binding::Dump(parcel), "{\"id\" : 7}");
+
+  parcel.note = "a";
+  parcel.sizes = vector<int>{};
+  string text = binding::Dump(parcel);
+  EXPECT_EQ(text, "{\"id\" : 7, \"note\" : \"a\", \"sizes\" : []}");
+
+  // 序列化后再解析得到相同的结构体
+  shop::Parcel copy;
+  binding::Parse(text, copy);
+  EXPECT_EQ(copy.note, "a");
+  EXPECT_EQ(copy.sizes, vector<int>{});
+  EXPECT_EQ(Parser(text).Parse(), Parser(binding::Dump(copy)).Parse());
+
+  // 不是成员时，空的optional输出为null
+  EXPECT_EQ(binding::Dump(optional<int>()), "null");
+  EXPECT_EQ(binding::Dump(optional<int>(3)), "3");
+}
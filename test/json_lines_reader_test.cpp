@@ -0,0 +1,114 @@
+// 测试JsonLinesReader
+
+#include "json_lines_reader.h"
+
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "json.h"
+
+using namespace jiayuancs::jsoncpp;
+using namespace std;
+
+namespace {
+
+// 生成n行文档，第i行为{"id": i, "tag": "..."}
+string MakeLines(int n) {
+  string input;
+  for (int i = 0; i < n; ++i) {
+    input += "{\"id\": " + to_string(i) + ", \"tag\": \"line" + to_string(i) +
+             "\"}\n";
+  }
+  return input;
+}
+
+vector<JsonLinesRecord> ReadAll(JsonLinesReader &reader) {
+  vector<JsonLinesRecord> records;
+  JsonLinesRecord record;
+  while (reader.Next(record)) {
+    records.push_back(std::move(record));
+  }
+  return records;
+}
+
+}  // namespace
+
+TEST(JsonLinesReaderTest, InputOrder) {
+  string input = MakeLines(2000);
+  JsonLinesOptions options;
+  options.threads = 4;
+  options.chunk_size = 100;  // 大量小分块，检验乱序完成时仍按顺序返回
+  options.max_pending_chunks = 3;
+
+  JsonLinesReader reader(input, options);
+  vector<JsonLinesRecord> records = ReadAll(reader);
+  ASSERT_EQ(records.size(), 2000);
+  for (int i = 0; i < 2000; ++i) {
+    ASSERT_TRUE(records[i].ok()) << records[i].error;
+    EXPECT_EQ(records[i].line_no, i + 1);
+    EXPECT_EQ(records[i].value["id"].GetInteger(), i);
+  }
+
+  istringstream is(input);
+  JsonLinesReader stream_reader(is, options);
+  vector<JsonLinesRecord> stream_records = ReadAll(stream_reader);
+  ASSERT_EQ(stream_records.size(), 2000);
+  for (int i = 0; i < 2000; ++i) {
+    EXPECT_EQ(stream_records[i].line_no, i + 1);
+    EXPECT_EQ(stream_records[i].value, records[i].value);
+  }
+}
+
+TEST(JsonLinesReaderTest, Errors) {
+  string input =
+      "[1, 2]\n"
+      "\n"
+      "  \r\n"
+      "{\"a\": }\n"
+      "true false\n"
+      "\"last\"";  // 最后一行没有换行符
+  for (size_t chunk_size : {1, 4, 1 << 20}) {
+    JsonLinesOptions options;
+    options.threads = 2;
+    options.chunk_size = chunk_size;
+    istringstream is(input);
+    JsonLinesReader memory_reader(input, options);
+    JsonLinesReader stream_reader(is, options);
+
+    for (JsonLinesReader *reader : {&memory_reader, &stream_reader}) {
+      vector<JsonLinesRecord> records = ReadAll(*reader);
+      ASSERT_EQ(records.size(), 4);  // 空行被跳过
+      EXPECT_TRUE(records[0].ok());
+      EXPECT_EQ(records[0].value, Json({1, 2}));
+      EXPECT_EQ(records[0].line_no, 1);
+
+      EXPECT_FALSE(records[1].ok());
+      EXPECT_EQ(records[1].line_no, 4);
+      EXPECT_TRUE(records[1].value.IsNull());
+      EXPECT_EQ(records[1].error.find("syntax error in line 4:"), 0);
+
+      EXPECT_FALSE(records[2].ok());
+      EXPECT_EQ(records[2].line_no, 5);
+      EXPECT_EQ(records[2].error.find("syntax error in line 5:"), 0);
+
+      EXPECT_TRUE(records[3].ok());
+      EXPECT_EQ(records[3].line_no, 6);
+      EXPECT_EQ(records[3].value, Json("last"));
+    }
+  }
+}
+
+TEST(JsonLinesReaderTest, EarlyDestruction) {
+  // 调用者只读取部分文档就销毁读取器，阻塞中的解析线程应能正常退出
+  string input = MakeLines(10000);
+  JsonLinesOptions options;
+  options.threads = 4;
+  options.chunk_size = 64;
+  options.max_pending_chunks = 2;
+  JsonLinesReader reader(input, options);
+  JsonLinesRecord record;
+  ASSERT_TRUE(reader.Next(record));
+  EXPECT_EQ(record.value["id"].GetInteger(), 0);
+}
@@ -2,12 +2,18 @@
 
 #include "json.h"
 
+#include <cstdint>
+#include <cstring>
 #include <iostream>
+#include <limits>
+#include <random>
+#include <sstream>
 #include <stdexcept>
 #include <string>
 #include <vector>
 
 #include "gtest/gtest.h"
+#include "parser.h"
 
 using namespace jiayuancs::jsoncpp;
 using namespace std;
@@ -201,11 +207,227 @@ TEST(JsonDumpTest, DumpTest) {
   json_array[5]["tag"] = "object";
   json_array[5]["value"] = 42;
 
+#ifdef JSONCPP_FLAT_OBJECT
+  // object的成员按插入顺序序列化
+  const string target =
+      "[{\"hello\" : \"world\", \"kint\" : 42, \"kdouble\" : 23.4, "
+      "\"kbool\" : false, \"knull\" : null, \"karray\" : [1, 2, 3, \"ceshi\", "
+      "34.4, true, null, [[1, 2], [\"3\", 4]], [\"nihao\", \"shijie\", "
+      "[1, 2, 3], \"hello\"], {}]}, 42, 24.42, false, [1, 2, 3], "
+      "{\"tag\" : \"object\", \"value\" : 42}]";
+#else
+  // object的成员按key排序后序列化
   const string target =
       "[{\"hello\" : \"world\", \"karray\" : [1, 2, 3, \"ceshi\", 34.4, true, "
       "null, [[1, 2], [\"3\", 4]], [\"nihao\", \"shijie\", [1, 2, 3], "
       "\"hello\"], {}], \"kbool\" : false, \"kdouble\" : 23.4, \"kint\" : 42, "
       "\"knull\" : null}, 42, 24.42, false, [1, 2, 3], {\"tag\" : \"object\", "
       "\"value\" : 42}]";
+#endif
   EXPECT_EQ(json_array.dump(), target);
 };
+
+// 测试字符串转义
+TEST(JsonDumpTest, DumpEscape) {
+  EXPECT_EQ(Json("say \"hi\"\\").dump(), "\"say \\\"hi\\\"\\\\\"");
+  EXPECT_EQ(Json("\b\f\n\r\t").dump(), "\"\\b\\f\\n\\r\\t\"");
+  EXPECT_EQ(Json(string("\x01\0\x1f", 3)).dump(), "\"\\u0001\\u0000\\u001f\"");
+  EXPECT_EQ(Json("\xE4\xBD\xA0\xE5\xA5\xBD").dump(),
+            "\"\xE4\xBD\xA0\xE5\xA5\xBD\"");
+
+  // 长字符串中各个位置的转义字符
+  string text(100, 'a');
+  for (size_t i = 0; i < text.size(); i += 7) {
+    text[i] = "\"\\\n\x7f\x80"[i % 5];
+  }
+  Json json = Json::ObjectType{{text, text}};
+  EXPECT_EQ(Parser(json.dump()).Parse(), json);
+};
+
+// 测试缩进
+TEST(JsonDumpTest, DumpIndent) {
+  Json json = Json::ObjectType{
+      {"array", {1, Json(Json::kArray), Json::ObjectType{{"k", "v"}}}},
+      {"empty", Json(Json::kObject)},
+      {"null", Json()}};
+  const string target =
+      "{\n"
+      "  \"array\": [\n"
+      "    1,\n"
+      "    [],\n"
+      "    {\n"
+      "      \"k\": \"v\"\n"
+      "    }\n"
+      "  ],\n"
+      "  \"empty\": {},\n"
+      "  \"null\": null\n"
+      "}";
+  EXPECT_EQ(json.dump(2), target);
+  EXPECT_EQ(Parser(json.dump(4)).Parse(), json);
+
+  ostringstream oss;
+  json.dump(oss, 2);
+  EXPECT_EQ(oss.str(), target);
+};
+
+// 测试数字的序列化
+TEST(JsonDumpTest, DumpNumber) {
+  EXPECT_EQ(Json(0).dump(), "0");
+  EXPECT_EQ(Json(-1234567890123LL).dump(), "-1234567890123");
+  EXPECT_EQ(Json(numeric_limits<long long>::min()).dump(),
+            "-9223372036854775808");
+
+  // 能精确还原的表示，整数值保留小数部分
+  EXPECT_EQ(Json(0.1).dump(), "0.1");
+  EXPECT_EQ(Json(1.0 / 3).dump(), "0.3333333333333333");
+  EXPECT_EQ(Json(100.0).dump(), "100.0");
+  EXPECT_EQ(Json(-0.0).dump(), "-0.0");
+  EXPECT_EQ(Json(1e21).dump(), "1e21");
+  EXPECT_EQ(Json(1.5e-7).dump(), "1.5e-7");
+  EXPECT_EQ(Json(0.000001).dump(), "0.000001");
+  EXPECT_EQ(Json(5e-324).dump(), "5e-324");
+  EXPECT_EQ(Json(1.7976931348623157e308).dump(), "1.7976931348623157e308");
+  EXPECT_EQ(Json(numeric_limits<double>::infinity()).dump(), "null");
+  EXPECT_EQ(Json(numeric_limits<double>::quiet_NaN()).dump(), "null");
+
+  // 序列化结果解析后得到相同的值
+  mt19937_64 random(11);
+  for (int i = 0; i < 10000; ++i) {
+    uint64_t bits = random();
+    double value;
+    memcpy(&value, &bits, sizeof(value));
+    if (value != value || value - value != 0) {
+      continue;
+    }
+    Json json = Parser(Json(value).dump()).Parse();
+    ASSERT_TRUE(json.IsDouble());
+    double result = json.GetDouble();
+    ASSERT_EQ(memcmp(&value, &result, sizeof(value)), 0) << value;
+  }
+};
+
+// 测试移动构造和移动赋值
+TEST(JsonConstructor, MoveConstructor) {
+  Json json = {1, "two", Json::ObjectType{{"three", 3}}};
+  Json target = json;
+
+  Json moved(std::move(json));
+  EXPECT_TRUE(json.IsNull());
+  EXPECT_EQ(moved, target);
+
+  json = std::move(moved);
+  EXPECT_TRUE(moved.IsNull());
+  EXPECT_EQ(json, target);
+
+  json = std::move(json);
+  EXPECT_EQ(json, target);
+};
+
+// 用自身的子节点替换自身
+TEST(JsonConstructor, AssignFromChild) {
+  Json json = Json::ObjectType{{"a", {1, string(100, 'x')}}, {"b", 2}};
+  json = std::move(json["a"]);
+  EXPECT_EQ(json, Json({1, string(100, 'x')}));
+  json = std::move(json[1]);
+  EXPECT_EQ(json, string(100, 'x'));
+
+  json = Json::ObjectType{{"a", Json::ObjectType{{"b", {true}}}}};
+  json = json["a"];
+  EXPECT_EQ(json, Json(Json::ObjectType{{"b", {true}}}));
+  json = json["b"][0];
+  EXPECT_EQ(json, true);
+};
+
+// 测试基于移动语义的构造和取值
+TEST(JsonConstructor, RvalueConstructor) {
+  string long_string(100, 'x');
+  const char *data = long_string.data();
+  Json json_string(std::move(long_string));
+  EXPECT_EQ(json_string.GetString(), string(100, 'x'));
+  // 移动后直接接管原字符串的缓冲区
+  EXPECT_EQ(json_string.GetString().data(), data);
+
+  string taken = std::move(json_string).TakeString();
+  EXPECT_EQ(taken.data(), data);
+  EXPECT_EQ(json_string.GetString(), "");
+
+  Json::ArrayType array = {1, 2, 3};
+  const Json *elements = array.data();
+  Json json_array(std::move(array));
+  EXPECT_EQ(json_array.GetConstArray().data(), elements);
+  EXPECT_EQ(json_array, Json({1, 2, 3}));
+  Json::ArrayType taken_array = std::move(json_array).TakeArray();
+  EXPECT_EQ(taken_array.data(), elements);
+
+  Json::ObjectType object = {{"key", "value"}};
+  Json json_object(std::move(object));
+  EXPECT_EQ(json_object["key"], "value");
+  EXPECT_EQ(std::move(json_object).TakeObject().size(), 1);
+
+  EXPECT_THROW(std::move(json_object).TakeString(), logic_error);
+  EXPECT_THROW(std::move(json_object).TakeArray(), logic_error);
+  EXPECT_THROW(std::move(json_array).TakeObject(), logic_error);
+};
+
+// 测试PushBack、EmplaceBack和Emplace
+TEST(JsonTypeTest, Builders) {
+  Json json_array;
+  json_array.PushBack(1);
+  Json element = "two";
+  json_array.PushBack(element);
+  json_array.PushBack(Json({3}));
+  json_array.EmplaceBack(Json::kObject)["four"] = 4;
+  json_array.EmplaceBack(string("five"));
+  EXPECT_EQ(json_array, Json({1, "two", {3}, Json::ObjectType{{"four", 4}},
+                              "five"}));
+  EXPECT_THROW(element.PushBack(1), logic_error);
+
+  Json json_object;
+  json_object.Emplace("a", 1);
+  json_object.Emplace("b", Json::kArray).PushBack(2);
+  json_object.Emplace("a", "replaced");
+  EXPECT_EQ(json_object,
+            Json(Json::ObjectType{{"a", "replaced"}, {"b", {2}}}));
+  EXPECT_THROW(json_array.Emplace("key", 1), logic_error);
+};
+
+// 测试短字符串内联存储
+TEST(JsonTypeTest, ShortString) {
+  EXPECT_LE(sizeof(Json), 16);
+
+  string inline_max(14, 'a');
+  string heap_min(15, 'b');
+  Json short_json = inline_max;
+  Json long_json = heap_min;
+  EXPECT_TRUE(short_json.IsString());
+  EXPECT_EQ(short_json.Type(), Json::kString);
+  EXPECT_EQ(short_json.GetString(), inline_max);
+  EXPECT_EQ(long_json.GetString(), heap_min);
+  // 内联存储的字符串位于Json对象内部
+  const char *begin = reinterpret_cast<const char *>(&short_json);
+  EXPECT_TRUE(short_json.GetString().data() >= begin &&
+              short_json.GetString().data() < begin + sizeof(Json));
+
+  // 字符串中可以包含'\0'
+  Json zero = StringView("a\0b", 3);
+  EXPECT_EQ(zero.GetString().size(), 3);
+  EXPECT_NE(zero, Json("a"));
+
+  // 拷贝、移动、比较与类型转换
+  Json copy = short_json;
+  EXPECT_EQ(copy, short_json);
+  Json moved = std::move(copy);
+  EXPECT_TRUE(copy.IsNull());
+  EXPECT_EQ(moved, inline_max);
+  EXPECT_NE(short_json, long_json);
+  short_json = long_json;
+  EXPECT_EQ(short_json.GetString(), heap_min);
+  long_json = "short";
+  EXPECT_EQ(long_json.dump(), "\"short\"");
+  EXPECT_THROW(long_json[0], logic_error);  // 字符串不能转为array
+  EXPECT_EQ(std::move(moved).TakeString(), inline_max);
+  EXPECT_EQ(moved.GetString(), "");
+
+  std::string converted = Json("view").GetString();
+  EXPECT_EQ(converted, "view");
+};
@@ -0,0 +1,129 @@
+// 测试KeyPool及解析器的key驻留
+
+#include "key_pool.h"
+
+#include <string>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "handler.h"
+#include "json.h"
+#include "parser.h"
+
+using namespace jiayuancs::jsoncpp;
+using namespace std;
+
+namespace {
+
+// 记录每个key的地址
+class KeyAddressHandler : public Handler {
+ public:
+  void OnKey(const string &key) override { addresses.push_back(&key); }
+
+  vector<const string *> addresses;
+};
+
+}  // namespace
+
+TEST(KeyPoolTest, Intern) {
+  KeyPool pool;
+  const string *id = pool.Intern("id");
+  EXPECT_EQ(*id, "id");
+  EXPECT_EQ(pool.Intern(string("id")), id);
+  EXPECT_EQ(pool.Find("id"), id);
+  EXPECT_EQ(pool.Find("name"), nullptr);
+  EXPECT_NE(pool.Intern("name"), id);
+  EXPECT_EQ(pool.Size(), 2);
+
+  pool.Clear();
+  EXPECT_EQ(pool.Size(), 0);
+  EXPECT_EQ(pool.Find("id"), nullptr);
+};
+
+TEST(KeyPoolTest, MaxKeys) {
+  KeyPool pool(2);
+  const string *a = pool.Intern("a");
+  EXPECT_NE(pool.Intern("b"), nullptr);
+  EXPECT_EQ(pool.Intern("c"), nullptr);
+  EXPECT_EQ(pool.Intern("a"), a);  // 已驻留的key仍可返回
+};
+
+// 同一个KeyPool在多个文档之间共享，相同的key具有相同的地址
+TEST(KeyPoolTest, SharedAcrossParsers) {
+  const char *documents[] = {
+      "{\"id\": 1, \"name\": \"a\", \"tags\": [{\"id\": 2}]}",
+      "{\"name\": \"b\", \"id\": 3}",
+  };
+
+  KeyPool pool;
+  KeyAddressHandler first;
+  KeyAddressHandler second;
+  Parser parser1(documents[0]);
+  parser1.UseKeyPool(pool);
+  parser1.Parse(first);
+  Parser parser2(documents[1]);
+  parser2.UseKeyPool(pool);
+  parser2.Parse(second);
+
+  EXPECT_EQ(pool.Size(), 3);
+  ASSERT_EQ(first.addresses.size(), 4);
+  ASSERT_EQ(second.addresses.size(), 2);
+  EXPECT_EQ(first.addresses[0], pool.Find("id"));
+  EXPECT_EQ(first.addresses[3], pool.Find("id"));
+  EXPECT_EQ(second.addresses[0], first.addresses[1]);
+  EXPECT_EQ(second.addresses[1], first.addresses[0]);
+
+  // 驻留不影响构建出的Json对象
+  for (const char *document : documents) {
+    Parser parser(document);
+    parser.UseKeyPool(pool);
+    EXPECT_EQ(parser.Parse(), Parser(document).Parse());
+  }
+
+  // 驻留表已满时仍能正确解析
+  KeyPool full(1);
+  Parser parser(documents[0]);
+  parser.UseKeyPool(full);
+  EXPECT_EQ(parser.Parse(), Parser(documents[0]).Parse());
+};
+
+// Parse()构建的object直接引用驻留的key
+TEST(KeyPoolTest, InternedKeysInJson) {
+  KeyPool pool;
+  Parser parser1("{\"id\": 1, \"a_rather_long_key\": {\"id\": 2}}");
+  parser1.UseKeyPool(pool);
+  Json first = parser1.Parse();
+  Parser parser2("{\"a_rather_long_key\": 3}");
+  parser2.UseKeyPool(pool);
+  Json second = parser2.Parse();
+
+  const string *id = pool.Find("id");
+  const string *long_key = pool.Find("a_rather_long_key");
+  ASSERT_NE(id, nullptr);
+  ASSERT_NE(long_key, nullptr);
+  for (const auto &member : first.GetConstObject()) {
+    EXPECT_TRUE(member.first.IsInterned());
+  }
+  const ObjectKey &key = second.GetConstObject().begin()->first;
+  EXPECT_TRUE(key.IsInterned());
+  EXPECT_EQ(key.data(), long_key->data());
+  EXPECT_EQ(first["a_rather_long_key"]["id"], 2);
+  EXPECT_EQ(first.GetConstObject().find("id")->first.data(), id->data());
+
+  // 拷贝仍引用驻留的key，新增的key被复制
+  Json copy = first;
+  copy["extra"] = 1;
+  EXPECT_EQ(copy.GetConstObject().find("id")->first.data(), id->data());
+  EXPECT_FALSE(copy.GetConstObject().find("extra")->first.IsInterned());
+  EXPECT_EQ(Json(first), first);
+
+  // 未使用KeyPool或驻留表已满时复制key
+  Json plain = Parser("{\"id\": 1}").Parse();
+  EXPECT_FALSE(plain.GetConstObject().begin()->first.IsInterned());
+  KeyPool full(0);
+  Parser parser3("{\"id\": 1}");
+  parser3.UseKeyPool(full);
+  Json copied = parser3.Parse();
+  EXPECT_FALSE(copied.GetConstObject().begin()->first.IsInterned());
+  EXPECT_EQ(copied, plain);
+}
@@ -0,0 +1,94 @@
+// 测试按需解析的JSON文档
+
+#include "lazy_document.h"
+
+#include <stdexcept>
+#include <string>
+
+#include "gtest/gtest.h"
+#include "parser.h"
+
+using namespace jiayuancs::jsoncpp;
+using namespace std;
+
+namespace {
+
+const char *kDocument =
+    "{\"skip\": {\"nested\": [1, 2, {\"deep\": \"}]\\\"\"}], \"x\": null},\n"
+    " \"user\": {\"name\": \"jsoncpp\", \"id\": 42, \"score\": 98.5,\n"
+    "           \"admin\": false, \"tags\": [\"a\", \"b\", \"c\"]},\n"
+    " \"esc\\\"key\": \"escaped\"}";
+
+}  // namespace
+
+TEST(LazyDocumentTest, Navigation) {
+  LazyDocument doc(kDocument);
+  EXPECT_TRUE(doc.Root().IsObject());
+
+  LazyValue user = doc["user"];
+  EXPECT_TRUE(user.IsObject());
+  EXPECT_EQ(user["id"].GetInteger(), 42);
+  EXPECT_TRUE(user["id"].IsInteger());
+  EXPECT_EQ(user["name"].GetString(), "jsoncpp");
+  EXPECT_DOUBLE_EQ(user["score"].GetDouble(), 98.5);
+  EXPECT_TRUE(user["score"].IsDouble());
+  EXPECT_FALSE(user["admin"].GetBool());
+  EXPECT_EQ(user["tags"][2].GetString(), "c");
+  EXPECT_TRUE(doc["skip"]["x"].IsNull());
+  EXPECT_EQ(doc["esc\"key"].GetString(), "escaped");
+
+  EXPECT_TRUE(LazyDocument("[1e5]")[0].IsDouble());
+  EXPECT_TRUE(LazyDocument("[-9223372036854775809]")[0].IsDouble());
+
+  LazyValue value = doc.Root();
+  EXPECT_FALSE(doc.Root().Find("missing", value));
+  EXPECT_TRUE(user.Find("tags", value));
+  EXPECT_EQ(value.ToJson(), Json({"a", "b", "c"}));
+};
+
+TEST(LazyDocumentTest, ToJson) {
+  string document = kDocument;
+  LazyDocument doc(document);
+  Json full = Parser(document).Parse();
+  EXPECT_EQ(doc["skip"].ToJson(), full["skip"]);
+  EXPECT_EQ(doc["skip"]["nested"][2].ToJson(),
+            Json(Json::ObjectType{{"deep", "}]\""}}));
+
+  LazyDocument array_doc(string(" [1, [2, 3], {\"a\": []}, \"x\"] "));
+  EXPECT_EQ(array_doc[1][1].GetInteger(), 3);
+  EXPECT_EQ(array_doc.Root().ToJson(),
+            Parser("[1, [2, 3], {\"a\": []}, \"x\"]").Parse());
+};
+
+TEST(LazyDocumentTest, DuplicateKeys) {
+  // 与Parser一致，重复的key以最后一次出现的为准
+  string document =
+      "{\"a\": 1, \"b\": {\"c\": [1], \"c\": [2]}, \"a\": \"last\","
+      " \"\\u0061\": 3.5, \"d\": null}";
+  LazyDocument doc(document);
+  Json full = Parser(document).Parse();
+  EXPECT_EQ(doc["a"].GetDouble(), 3.5);
+  EXPECT_EQ(doc["a"].ToJson(), full["a"]);
+  EXPECT_EQ(doc["b"]["c"].ToJson(), Json({2}));
+  EXPECT_EQ(doc["b"].ToJson(), full["b"]);
+  EXPECT_TRUE(doc["d"].IsNull());
+
+  // 查找需要扫描到object末尾，之后的语法错误也会被发现
+  EXPECT_THROW(LazyDocument("{\"a\": 1, \"b\" 2}").Root()["a"],
+               logic_error);
+};
+
+TEST(LazyDocumentTest, Errors) {
+  LazyDocument doc(kDocument);
+  EXPECT_THROW(doc["missing"], logic_error);
+  EXPECT_THROW(doc[0], logic_error);
+  EXPECT_THROW(doc["user"]["tags"][3], logic_error);
+  EXPECT_THROW(doc["user"]["tags"][-1], logic_error);
+  EXPECT_THROW(doc["user"]["id"].GetString(), logic_error);
+  EXPECT_THROW(doc["user"]["id"]["x"], logic_error);
+
+  EXPECT_THROW(LazyDocument("").Root().Type(), logic_error);
+  EXPECT_THROW(LazyDocument("{\"a\": [1, 2").Root()["b"], logic_error);
+  EXPECT_THROW(LazyDocument("{\"a\" 1}").Root()["a"], logic_error);
+  EXPECT_THROW(LazyDocument("[1 2]").Root()[1], logic_error);
+};
@@ -0,0 +1,108 @@
+// 测试Json与MessagePack之间的转换
+
+#include "msgpack.h"
+
+#include <cstdlib>
+#include <limits>
+#include <stdexcept>
+#include <string>
+
+#include "gtest/gtest.h"
+#include "json.h"
+#include "parser.h"
+
+using namespace jiayuancs::jsoncpp;
+using namespace std;
+
+namespace {
+
+// 十六进制字符串转为字节
+string Bytes(const string &hex) {
+  string bytes;
+  for (size_t i = 0; i < hex.size(); i += 2) {
+    bytes += static_cast<char>(strtol(hex.substr(i, 2).c_str(), nullptr, 16));
+  }
+  return bytes;
+}
+
+}  // namespace
+
+TEST(MsgpackTest, Encode) {
+  EXPECT_EQ(msgpack::Encode(Json()), Bytes("c0"));
+  EXPECT_EQ(msgpack::Encode(Json(false)), Bytes("c2"));
+  EXPECT_EQ(msgpack::Encode(Json(true)), Bytes("c3"));
+  // 整数使用最短的格式
+  EXPECT_EQ(msgpack::Encode(Json(0)), Bytes("00"));
+  EXPECT_EQ(msgpack::Encode(Json(127)), Bytes("7f"));
+  EXPECT_EQ(msgpack::Encode(Json(128)), Bytes("cc80"));
+  EXPECT_EQ(msgpack::Encode(Json(256)), Bytes("cd0100"));
+  EXPECT_EQ(msgpack::Encode(Json(65536)), Bytes("ce00010000"));
+  EXPECT_EQ(msgpack::Encode(Json(4294967296LL)), Bytes("cf0000000100000000"));
+  EXPECT_EQ(msgpack::Encode(Json(-1)), Bytes("ff"));
+  EXPECT_EQ(msgpack::Encode(Json(-32)), Bytes("e0"));
+  EXPECT_EQ(msgpack::Encode(Json(-33)), Bytes("d0df"));
+  EXPECT_EQ(msgpack::Encode(Json(-129)), Bytes("d1ff7f"));
+  EXPECT_EQ(msgpack::Encode(Json(-32769)), Bytes("d2ffff7fff"));
+  EXPECT_EQ(msgpack::Encode(Json(numeric_limits<long long>::min())),
+            Bytes("d38000000000000000"));
+  EXPECT_EQ(msgpack::Encode(Json(1.5)), Bytes("cb3ff8000000000000"));
+  EXPECT_EQ(msgpack::Encode(Json("abc")), Bytes("a3616263"));
+  EXPECT_EQ(msgpack::Encode(Json(string(32, 'a'))).substr(0, 2),
+            Bytes("d920"));
+  EXPECT_EQ(msgpack::Encode(Json(string(256, 'a'))).substr(0, 3),
+            Bytes("da0100"));
+  EXPECT_EQ(msgpack::Encode(Parser("{\"a\": [1, 2]}").Parse()),
+            Bytes("81a161920102"));
+  Json array(Json::kArray);
+  array.GetArray().resize(16);
+  EXPECT_EQ(msgpack::Encode(array).substr(0, 3), Bytes("dc0010"));
+}
+
+TEST(MsgpackTest, Decode) {
+  EXPECT_EQ(msgpack::Decode(Bytes("d0df")), Json(-33));
+  EXPECT_EQ(msgpack::Decode(Bytes("cc80")), Json(128));
+  EXPECT_EQ(msgpack::Decode(Bytes("cdffff")), Json(65535));
+  // 超出long long范围的uint64转为double
+  EXPECT_EQ(msgpack::Decode(Bytes("cfffffffffffffffff")),
+            Json(18446744073709551615.0));
+  EXPECT_EQ(msgpack::Decode(Bytes("ca3fc00000")), Json(1.5));
+  EXPECT_EQ(msgpack::Decode(Bytes("d903616263")), Json("abc"));
+  EXPECT_EQ(msgpack::Decode(Bytes("de0001d90161dc00020102")),
+            Parser("{\"a\": [1, 2]}").Parse());
+
+  const char *invalid[] = {"",     "c1",     "c40161", "d40100", "a2",
+                           "9201", "8101c0", "0000",   "dd0000"};
+  for (const char *hex : invalid) {
+    EXPECT_THROW(msgpack::Decode(Bytes(hex)), logic_error) << hex;
+  }
+  EXPECT_THROW(msgpack::Decode(Bytes("ddffffffff")), logic_error);
+}
+
+TEST(MsgpackTest, NestingLimit) {
+  // 每层array或map只占1个字节，嵌套最多1000层
+  string nested;
+  for (int i = 0; i < 1000; ++i) {
+    nested += i % 2 == 0 ? "\x91" : "\x81\xA1\x61";
+  }
+  EXPECT_NO_THROW(msgpack::Decode(nested + '\x00'));
+  EXPECT_THROW(msgpack::Decode("\x91" + nested + '\x00'), logic_error);
+
+  string hostile(100000, '\x91');
+  try {
+    msgpack::Decode(hostile + '\x00');
+    FAIL();
+  } catch (const logic_error &e) {
+    EXPECT_NE(string(e.what()).find("nesting too deep"), string::npos);
+  }
+}
+
+TEST(MsgpackTest, RoundTrip) {
+  Json json = Parser(
+                  "{\"id\": 12345678901, \"name\": \"jsoncpp \\u4e2d\\u6587\", "
+                  "\"values\": [0, -1, 255, -129, 65536, 0.1, -2.5e-300, "
+                  "1e300, true, false, null], \"empty\": {\"a\": [], \"b\": "
+                  "{}}, \"long\": \"" +
+                  string(70000, 'x') + "\"}")
+                  .Parse();
+  EXPECT_EQ(msgpack::Decode(msgpack::Encode(json)), json);
+}
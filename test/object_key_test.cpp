@@ -0,0 +1,70 @@
+// 测试ObjectKey
+
+#include "object_key.h"
+
+#include <map>
+#include <string>
+#include <utility>
+
+#include "gtest/gtest.h"
+#include "string_view.h"
+
+using namespace jiayuancs::jsoncpp;
+using namespace std;
+
+TEST(ObjectKeyTest, Storage) {
+  ObjectKey empty;
+  EXPECT_TRUE(empty.empty());
+  EXPECT_EQ(empty, "");
+
+  // 短key内联存放，长key分配在堆上，两者都复制内容
+  string short_text = "short";
+  string long_text(100, 'k');
+  ObjectKey short_key(short_text);
+  ObjectKey long_key(long_text);
+  EXPECT_EQ(short_key, short_text);
+  EXPECT_EQ(long_key, long_text);
+  EXPECT_NE(long_key.data(), long_text.data());
+  EXPECT_FALSE(long_key.IsInterned());
+
+  ObjectKey copy = long_key;
+  EXPECT_EQ(copy, long_key);
+  EXPECT_NE(copy.data(), long_key.data());
+  ObjectKey moved = std::move(copy);
+  EXPECT_EQ(moved, long_text);
+  EXPECT_TRUE(copy.empty());
+  moved = short_key;
+  EXPECT_EQ(moved, "short");
+  moved = moved;
+  EXPECT_EQ(moved.ToString(), "short");
+
+  // 驻留的key只引用原字符串，拷贝也引用同一个字符串
+  ObjectKey interned = ObjectKey::FromInterned(long_text);
+  EXPECT_TRUE(interned.IsInterned());
+  EXPECT_EQ(interned.data(), long_text.data());
+  ObjectKey interned_copy = interned;
+  EXPECT_EQ(interned_copy.data(), long_text.data());
+  EXPECT_EQ(interned_copy, long_key);
+}
+
+TEST(ObjectKeyTest, Compare) {
+  ObjectKey key("b");
+  EXPECT_EQ(key, "b");
+  EXPECT_EQ(key, string("b"));
+  EXPECT_EQ(key, StringView("b"));
+  EXPECT_NE(key, "bb");
+  EXPECT_TRUE(ObjectKey("a") < key);
+  string text = key;
+  EXPECT_EQ(text, "b");
+
+  // ObjectKeyLess是透明比较器，按字节的字典序排列
+  map<ObjectKey, int, ObjectKeyLess> keys = {
+      {"b", 1}, {"a", 2}, {"\xE4\xB8\xAD", 3}, {"ab", 4}};
+  string order;
+  for (const auto &entry : keys) {
+    order += entry.first;
+  }
+  EXPECT_EQ(order, "aabb\xE4\xB8\xAD");
+  EXPECT_EQ(keys.find(string("ab"))->second, 4);
+  EXPECT_EQ(keys.count("c"), 0);
+}
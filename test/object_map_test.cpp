@@ -0,0 +1,81 @@
+// 测试ObjectMap
+
+#include "object_map.h"
+
+#include <map>
+#include <stdexcept>
+#include <string>
+
+#include "gtest/gtest.h"
+#include "json.h"
+
+using namespace jiayuancs::jsoncpp;
+using namespace std;
+
+TEST(ObjectMapTest, InsertionOrder) {
+  ObjectMap<int> object = {{"b", 1}, {"a", 2}, {"b", 3}};
+  EXPECT_EQ(object.size(), 2);
+  EXPECT_EQ(object["b"], 1);  // 重复的key只保留第一次出现的值
+  object["c"] = 4;
+  EXPECT_TRUE(object.emplace("a", 5).second == false);
+  EXPECT_TRUE(object.insert(make_pair(string("d"), 6)).second);
+
+  string keys;
+  for (const auto &entry : object) {
+    keys += entry.first;
+  }
+  EXPECT_EQ(keys, "bacd");
+
+  EXPECT_EQ(object.erase("a"), 1);
+  EXPECT_EQ(object.erase("a"), 0);
+  EXPECT_EQ(object.begin()->first, "b");
+  EXPECT_EQ((object.begin() + 1)->first, "c");
+  EXPECT_EQ(object.at("d"), 6);
+  EXPECT_THROW(object.at("a"), out_of_range);
+  EXPECT_EQ(object.count("c"), 1);
+};
+
+// 成员较多时经由哈希索引查找，结果应与std::map一致
+TEST(ObjectMapTest, HashIndex) {
+  ObjectMap<int> object;
+  map<string, int> reference;
+  for (int i = 0; i < 1000; ++i) {
+    string key = "key" + to_string(i * 7 % 513);
+    if (object.count(key) == 0) {
+      object[key] = i;
+    }
+    reference.emplace(key, i);
+    // 删除成员会重建索引
+    if (i % 10 == 0) {
+      reference.erase(object.begin()->first);
+      object.erase(object.begin());
+    }
+  }
+  EXPECT_EQ(object.size(), reference.size());
+  EXPECT_GT(object.size(), ObjectMap<int>::kIndexThreshold);
+  for (const auto &entry : object) {
+    EXPECT_EQ(object.find(entry.first)->second, entry.second);
+    EXPECT_EQ(reference.at(entry.first), entry.second);
+  }
+  EXPECT_TRUE(object.find("missing") == object.end());
+
+  ObjectMap<int> copy = object;
+  EXPECT_TRUE(copy == object);
+  copy.erase(copy.begin());
+  EXPECT_TRUE(copy != object);
+};
+
+// 比较与成员顺序无关
+TEST(ObjectMapTest, Equal) {
+  ObjectMap<int> lhs = {{"a", 1}, {"b", 2}, {"c", 3}};
+  ObjectMap<int> rhs = {{"a", 1}, {"c", 3}, {"b", 2}};
+  EXPECT_TRUE(lhs == rhs);
+  rhs["b"] = 4;
+  EXPECT_TRUE(lhs != rhs);
+  rhs = {{"a", 1}, {"b", 2}, {"d", 3}};
+  EXPECT_TRUE(lhs != rhs);
+
+  Json::ObjectType ordered = {{"x", 1}, {"y", "two"}};
+  Json::ObjectType reversed = {{"y", "two"}, {"x", 1}};
+  EXPECT_EQ(Json(ordered), Json(reversed));
+};
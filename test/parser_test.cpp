@@ -2,12 +2,22 @@
 
 #include "parser.h"
 
+#include <cerrno>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
 #include <iostream>
+#include <limits>
+#include <random>
+#include <sstream>
 #include <stdexcept>
 #include <string>
 #include <vector>
 
 #include "gtest/gtest.h"
+#include "mapped_file.h"
 
 using namespace jiayuancs::jsoncpp;
 using namespace std;
@@ -71,6 +81,70 @@ TEST(ParserTest, DoubleTest) {
   EXPECT_THROW(Parser("-f.23").Parse(), logic_error);
 };
 
+TEST(ParserTest, NumberTest) {
+  // 指数
+  EXPECT_EQ(Parser("1e10").Parse(), 1e10);
+  EXPECT_EQ(Parser("-2.5E-3").Parse(), -2.5e-3);
+  EXPECT_EQ(Parser("1e+2").Parse(), 100.0);
+  EXPECT_TRUE(Parser("1e2").Parse().IsDouble());
+  EXPECT_EQ(Parser("1e-400").Parse(), 0.0);
+  EXPECT_THROW(Parser("1e400").Parse(), logic_error);
+
+  // 超出long long范围的整数转为double
+  EXPECT_EQ(Parser("9223372036854775807").Parse(),
+            numeric_limits<long long>::max());
+  EXPECT_EQ(Parser("-9223372036854775808").Parse(),
+            numeric_limits<long long>::min());
+  EXPECT_EQ(Parser("9223372036854775808").Parse(), 9223372036854775808.0);
+  EXPECT_EQ(Parser("123456789012345678901234567890").Parse(),
+            123456789012345678901234567890.0);
+  EXPECT_EQ(Parser("0.1234567890123456789012345").Parse(),
+            0.1234567890123456789012345);
+
+  // 非规格化数和边界值
+  EXPECT_EQ(Parser("4.9e-324").Parse(), 4.9e-324);
+  EXPECT_EQ(Parser("2.2250738585072011e-308").Parse(),
+            2.2250738585072011e-308);
+  EXPECT_EQ(Parser("1.7976931348623157e308").Parse(),
+            1.7976931348623157e308);
+
+  // 不合法的数字
+  EXPECT_THROW(Parser("1.").Parse(), logic_error);
+  EXPECT_THROW(Parser("1.e5").Parse(), logic_error);
+  EXPECT_THROW(Parser("1e").Parse(), logic_error);
+  EXPECT_THROW(Parser("1e+").Parse(), logic_error);
+  EXPECT_THROW(Parser("-a").Parse(), logic_error);
+  // 不允许多余的前导零
+  EXPECT_THROW(Parser("0123").Parse(), logic_error);
+  EXPECT_THROW(Parser("-00").Parse(), logic_error);
+  EXPECT_THROW(Parser("[01]").Parse(), logic_error);
+  EXPECT_EQ(Parser("0").Parse(), 0);
+  EXPECT_EQ(Parser("-0.5").Parse(), -0.5);
+};
+
+// 与strtod的结果逐位对比
+TEST(ParserTest, NumberMatchesStrtod) {
+  mt19937_64 random(2023);
+  char buffer[64];
+  for (int i = 0; i < 100000; ++i) {
+    uint64_t bits = random();
+    double value;
+    memcpy(&value, &bits, sizeof(value));
+    if (value != value || value - value != 0) {  // NaN或inf
+      continue;
+    }
+    snprintf(buffer, sizeof(buffer), "%.*g", 1 + static_cast<int>(i % 20),
+             value);
+    double target = strtod(buffer, nullptr);
+    if (target - target != 0) {
+      continue;
+    }
+    Json json = Parser(buffer).Parse();
+    double result = json.IsInteger() ? json.GetInteger() : json.GetDouble();
+    ASSERT_EQ(memcmp(&result, &target, sizeof(result)), 0) << buffer;
+  }
+};
+
 TEST(ParserTest, StringTest) {
   Json json;
 
@@ -90,6 +164,20 @@ TEST(ParserTest, StringTest) {
   EXPECT_THROW(Parser("\"").Parse(), logic_error);
 };
 
+TEST(ParserTest, UnicodeEscape) {
+  EXPECT_EQ(Parser("\"\\u0041\\u00e9\"").Parse(), "A\xC3\xA9");
+  EXPECT_EQ(Parser("\"\\u4F60\\u597d\"").Parse(), "\xE4\xBD\xA0\xE5\xA5\xBD");
+  EXPECT_EQ(Parser("\"\\u0000\"").Parse(), string(1, '\0'));
+  // 代理对
+  EXPECT_EQ(Parser("\"\\ud83d\\ude00\"").Parse(), "\xF0\x9F\x98\x80");
+
+  EXPECT_THROW(Parser("\"\\u12\"").Parse(), logic_error);
+  EXPECT_THROW(Parser("\"\\u00g0\"").Parse(), logic_error);
+  EXPECT_THROW(Parser("\"\\ud83d\"").Parse(), logic_error);
+  EXPECT_THROW(Parser("\"\\ud83d\\u0041\"").Parse(), logic_error);
+  EXPECT_THROW(Parser("\"\\ude00\"").Parse(), logic_error);
+};
+
 TEST(ParserTest, ArrayTest) {
   Json json;
 
@@ -172,3 +260,182 @@ TEST(ParserTest, DumpAndParser) {
 
   EXPECT_EQ(json_array, json_recover);
 };
+
+TEST(ParserTest, BufferInput) {
+  // 输入缓冲区无需以'\0'结尾
+  const char buf[] = {'[', '1', ',', ' ', '2', ']', '3', '4'};
+  EXPECT_EQ(Parser(buf, 6).Parse(), Json({1, 2}));
+  EXPECT_EQ(Parser(buf, 7).Parse(), Json({1, 2}));
+  EXPECT_THROW(Parser(buf, 5).Parse(), logic_error);
+  EXPECT_EQ(Parser(buf + 6, 1).Parse(), 3);
+
+  // 右值字符串由解析器持有
+  Parser parser(string("{\"key\": \"value\"}"));
+  Json json = parser.Parse();
+  EXPECT_EQ(json["key"], "value");
+
+  // 同一解析器可连续解析多个值
+  string values = "1 \"two\" [3]";
+  Parser multi(values);
+  EXPECT_EQ(multi.Parse(), 1);
+  EXPECT_EQ(multi.Parse(), "two");
+  EXPECT_EQ(multi.Parse(), Json({3}));
+  EXPECT_THROW(multi.Parse(), logic_error);
+};
+
+TEST(ParserTest, StreamInput) {
+  istringstream iss("{\"array\": [1, 2.5, \"str\"],\n \"null\": null}");
+  Json json = Parser(iss).Parse();
+  Json target = Json::ObjectType{{"array", {1, 2.5, "str"}}, {"null", Json()}};
+  EXPECT_EQ(json, target);
+
+  istringstream empty("");
+  EXPECT_THROW(Parser(empty).Parse(), logic_error);
+};
+
+TEST(ParserTest, FileInput) {
+  const char *path = "parser_test_input.json";
+  const string content =
+      "{\"name\": \"jsoncpp\", \"values\": [1, 2.5, \"\\u4e2d\"]}";
+  {
+    ofstream ofs(path, ios::binary);
+    ofs << content;
+  }
+  Json json = Parser::ParseFile(path);
+  EXPECT_EQ(json["name"], Json("jsoncpp"));
+  EXPECT_EQ(json["values"], Json({1, 2.5, "\u4e2d"}));
+
+  Arena arena;
+  EXPECT_EQ(Parser::ParseFile(path, arena), json);
+
+  MappedFile file(path);
+  EXPECT_EQ(string(file.Data(), file.Size()), content);
+
+  { ofstream empty(path, ios::trunc); }
+  EXPECT_THROW(Parser::ParseFile(path), logic_error);
+  remove(path);
+  EXPECT_THROW(Parser::ParseFile(path), runtime_error);
+  // 错误信息包含失败原因
+  try {
+    MappedFile missing(path);
+    FAIL();
+  } catch (const runtime_error &e) {
+    EXPECT_NE(string(e.what()).find(strerror(ENOENT)), string::npos);
+  }
+};
+
+TEST(ParserTest, ErrorLineNo) {
+  try {
+    Parser("[1,\n2,\n\n x]").Parse();
+    FAIL();
+  } catch (const logic_error &e) {
+    EXPECT_NE(string(e.what()).find("line 4"), string::npos);
+  }
+};
+
+// 将事件记录为字符串，便于检查事件顺序
+class RecordHandler : public Handler {
+ public:
+  void OnNull() override { events_ += "null "; }
+  void OnBool(bool value) override { events_ += value ? "true " : "false "; }
+  void OnInt(long long value) override {
+    events_ += "int:" + to_string(value) + " ";
+  }
+  void OnDouble(double value) override {
+    events_ += "double:" + to_string(value) + " ";
+  }
+  void OnString(const string &value) override {
+    events_ += "string:" + value + " ";
+  }
+  void OnStartArray() override { events_ += "[ "; }
+  void OnEndArray() override { events_ += "] "; }
+  void OnStartObject() override { events_ += "{ "; }
+  void OnKey(const string &key) override { events_ += "key:" + key + " "; }
+  void OnEndObject() override { events_ += "} "; }
+
+  const string &events() const { return events_; }
+
+ private:
+  string events_;
+};
+
+TEST(ParserTest, HandlerEvents) {
+  RecordHandler handler;
+  Parser(
+      "{\"a\": [null, true, false, -12, 2.5, \"s\"], \"b\": {}, \"c\": [[]]}")
+      .Parse(handler);
+  EXPECT_EQ(handler.events(),
+            "{ key:a [ null true false int:-12 double:2.500000 string:s ] "
+            "key:b { } key:c [ [ ] ] } ");
+
+  RecordHandler error_handler;
+  EXPECT_THROW(Parser("[1, 2").Parse(error_handler), logic_error);
+  EXPECT_EQ(error_handler.events(), "[ int:1 int:2 ");
+};
+
+TEST(ParserTest, HandlerOnlyCounts) {
+  // 只关心部分事件的Handler
+  class CountHandler : public Handler {
+   public:
+    void OnInt(long long value) override { sum_ += value; }
+    long long sum_ = 0;
+  } handler;
+
+  Parser("[1, {\"x\": 2, \"y\": [3, \"4\"]}, 5.5, 6]").Parse(handler);
+  EXPECT_EQ(handler.sum_, 12);
+};
+
+TEST(ParserTest, DuplicateKey) {
+  EXPECT_EQ(Parser("{\"a\": 1, \"a\": [2]}").Parse(),
+            Json(Json::ObjectType{{"a", {2}}}));
+};
+
+// 解析输入并返回异常信息，解析成功时返回空字符串
+template <typename ParseFunction>
+string ErrorMessage(ParseFunction parse) {
+  try {
+    parse();
+  } catch (const logic_error &e) {
+    return e.what();
+  }
+  return "";
+}
+
+TEST(ParserTest, ParallelParse) {
+  // 字符串中包含括号、逗号和转义的引号，检验深度为1的切分
+  string array = "[";
+  string object = "{";
+  for (int i = 0; i < 40000; ++i) {
+    string element = "{\"id\": " + to_string(i) +
+                     ", \"text\": \"a[b]{c}, \\\"d\\\" \\\\\", \"values\": [" +
+                     to_string(i * 0.5) + ", null, true, [{}]]}";
+    array += (i == 0 ? "" : ",\n ") + element;
+    // 每个key出现两次，以最后一次出现的值为准
+    object += (i == 0 ? "" : ", ") + string("\"k") + to_string(i % 20000) +
+              "\": " + element;
+  }
+  array += "]";
+  object += "}";
+
+  for (const string *input : {&array, &object}) {
+    Json expected = Parser(*input).Parse();
+    EXPECT_EQ(Parser(*input).ParseParallel(4), expected);
+    EXPECT_EQ(Parser(*input).ParseParallel(3), expected);
+  }
+  EXPECT_EQ(Parser(object).ParseParallel(4).GetConstObject().size(), 20000);
+
+  // 出错时与串行解析的异常信息相同
+  string broken = array;
+  broken.replace(broken.size() / 2, 1, "]");
+  string serial_error = ErrorMessage([&]() { Parser(broken).Parse(); });
+  EXPECT_NE(serial_error, "");
+  EXPECT_EQ(ErrorMessage([&]() { Parser(broken).ParseParallel(4); }),
+            serial_error);
+  EXPECT_THROW(Parser(array.substr(0, array.size() - 1)).ParseParallel(4),
+               logic_error);
+
+  // 较小的输入和标量直接串行解析
+  EXPECT_EQ(Parser("[1, 2]").ParseParallel(4), Json({1, 2}));
+  EXPECT_EQ(Parser(" 12").ParseParallel(4), Json(12));
+  EXPECT_THROW(Parser("").ParseParallel(4), logic_error);
+};
@@ -0,0 +1,114 @@
+// 测试Projection及Parser的投影解析
+
+#include "projection.h"
+
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "json.h"
+#include "parser.h"
+
+using namespace jiayuancs::jsoncpp;
+using namespace std;
+
+namespace {
+
+const char *kRecord =
+    "{\"user\": {\"id\": 7, \"name\": \"a\\u0062c\", \"tags\": [1, 2]},"
+    " \"items\": [{\"price\": 1.5, \"sku\": \"x\"}, {\"sku\": \"y\"},"
+    "             {\"price\": 3, \"sku\": \"z\", \"extra\": {\"k\": [null]}}],"
+    " \"payload\": {\"big\": [[[\"\\\"]\"]]], \"n\": -1e9},"
+    " \"flag\": true}";
+
+// 检查投影解析的结果
+Json Project(const Projection &projection, const char *text = kRecord) {
+  Parser parser(text);
+  Json result = parser.Parse(projection);
+  EXPECT_TRUE(parser.AtEnd());
+  return result;
+}
+
+Json Expected(const char *text) { return Parser(text).Parse(); }
+
+}  // namespace
+
+TEST(ProjectionTest, Select) {
+  EXPECT_EQ(Project({"/user/id"}), Expected("{\"user\":{\"id\":7}}"));
+  EXPECT_EQ(Project({"/user/name", "/flag"}),
+            Expected("{\"flag\":true,\"user\":{\"name\":\"abc\"}}"));
+  EXPECT_EQ(Project({"/user"})["user"], Parser(kRecord).Parse()["user"]);
+
+  // 通配符，array只保留匹配的元素，路径经过的容器保留为空
+  EXPECT_EQ(Project({"/items/*/price"}),
+            Expected("{\"items\":[{\"price\":1.5},{},{\"price\":3}]}"));
+  EXPECT_EQ(Project({"/items/1"}), Expected("{\"items\":[{\"sku\":\"y\"}]}"));
+  EXPECT_EQ(
+      Project({"/items/*/price", "/items/2/sku"}),
+      Expected("{\"items\":[{\"price\":1.5},{},{\"price\":3,\"sku\":\"z\"}]}"));
+  EXPECT_EQ(Project({"/*/id"}),
+            Expected("{\"items\":[],\"payload\":{},\"user\":{\"id\":7}}"));
+  EXPECT_EQ(Project({"/user/tags/1"}), Expected("{\"user\":{\"tags\":[2]}}"));
+
+  // 路径遇到标量时不匹配
+  EXPECT_EQ(Project({"/flag/x"}), Expected("{}"));
+  EXPECT_EQ(Project({"/missing"}), Expected("{}"));
+  EXPECT_EQ(Project({}), Expected("{}"));
+  EXPECT_EQ(Project({""}), Parser(kRecord).Parse());
+  EXPECT_TRUE(Project({"/a"}, " 42 ").IsNull());
+  EXPECT_EQ(Project({""}, "42"), Json(42));
+
+  EXPECT_THROW(Projection({"user"}), logic_error);
+  EXPECT_THROW(Projection({"/a~2"}), logic_error);
+}
+
+TEST(ProjectionTest, Events) {
+  // 只为选中的部分产生事件，key驻留同样生效
+  class CountHandler : public Handler {
+   public:
+    void OnInt(long long) override { ++ints; }
+    void OnDouble(double) override { ++doubles; }
+    void OnString(const std::string &) override { ++strings; }
+    void OnKey(const std::string &key) override { keys.push_back(&key); }
+    int ints = 0;
+    int doubles = 0;
+    int strings = 0;
+    vector<const string *> keys;
+  };
+
+  KeyPool pool;
+  CountHandler handler;
+  Parser parser(kRecord);
+  parser.UseKeyPool(pool);
+  parser.Parse(Projection({"/items/*/price"}), handler);
+  EXPECT_EQ(handler.ints, 1);
+  EXPECT_EQ(handler.doubles, 1);
+  EXPECT_EQ(handler.strings, 0);
+  ASSERT_EQ(handler.keys.size(), 3);
+  EXPECT_EQ(handler.keys[1], pool.Find("price"));
+  EXPECT_EQ(handler.keys[1], handler.keys[2]);
+}
+
+TEST(ProjectionTest, Errors) {
+  Projection projection({"/a"});
+  // 选中部分的错误与Parse()相同
+  EXPECT_THROW(Parser("{\"a\": tru}").Parse(projection), logic_error);
+  EXPECT_THROW(Parser("{\"a\": 1,}").Parse(projection), logic_error);
+  EXPECT_THROW(Parser("{\"a\" 1}").Parse(projection), logic_error);
+  // 跳过的部分只检查括号和字符串边界
+  EXPECT_EQ(Parser("{\"b\": tru, \"a\": 1}").Parse(projection),
+            Expected("{\"a\":1}"));
+  EXPECT_THROW(Parser("{\"b\": [1, 2}").Parse(projection), logic_error);
+  EXPECT_THROW(Parser("{\"b\": \"abc}").Parse(projection), logic_error);
+  EXPECT_THROW(Parser("{\"b\": ,\"a\": 1}").Parse(projection), logic_error);
+  EXPECT_THROW(Parser("{\"b\": 1").Parse(projection), logic_error);
+  try {
+    Parser("{\n\"b\": [\n1,").Parse(projection);
+    FAIL();
+  } catch (const logic_error &error) {
+    EXPECT_STREQ(error.what(),
+                 "syntax error in line 3: expected more characters, but got "
+                 "eof");
+  }
+}
@@ -0,0 +1,114 @@
+// 测试PushParser
+
+#include "push_parser.h"
+
+#include <string>
+
+#include "gtest/gtest.h"
+#include "handler.h"
+#include "json.h"
+#include "parser.h"
+
+using namespace jiayuancs::jsoncpp;
+using namespace std;
+
+TEST(PushParserTest, EverySplitPoint) {
+  // 在每个位置断开，分块的边界会落在字符串、转义序列、数字和字面量的中间
+  const string input =
+      "{\"name\": \"a\\\"b\\\\c\\u4e2d\\ud83d\\ude00\",\n"
+      " \"values\": [-12, 2.5e-3, 123456789012, true, false, null, [], {}],\n"
+      " \"nested\": {\"x\": [{\"y\": \"\"}]}}";
+  const Json expected = Parser(input).Parse();
+
+  for (size_t i = 0; i <= input.size(); ++i) {
+    PushParser parser;
+    EXPECT_EQ(parser.Feed(input.data(), i), i == input.size()
+                                                ? PushParser::kComplete
+                                                : PushParser::kNeedMoreData);
+    if (i != input.size()) {
+      ASSERT_EQ(parser.Feed(input.data() + i, input.size() - i),
+                PushParser::kComplete)
+          << parser.Error();
+    }
+    EXPECT_EQ(parser.Value(), expected);
+  }
+
+  // 逐字节输入
+  PushParser parser;
+  for (char ch : input) {
+    ASSERT_NE(parser.Feed(&ch, 1), PushParser::kError) << parser.Error();
+  }
+  EXPECT_EQ(parser.Value(), expected);
+}
+
+TEST(PushParserTest, TopLevelNumber) {
+  PushParser parser;
+  EXPECT_EQ(parser.Feed("12"), PushParser::kNeedMoreData);
+  EXPECT_EQ(parser.Feed("34"), PushParser::kNeedMoreData);
+  EXPECT_EQ(parser.Finish(), PushParser::kComplete);
+  EXPECT_EQ(parser.Value(), Json(1234));
+
+  parser.Reset();
+  EXPECT_EQ(parser.Feed("-0.5 "), PushParser::kComplete);
+  EXPECT_EQ(parser.Value(), Json(-0.5));
+}
+
+TEST(PushParserTest, Pipelined) {
+  // 值结束后剩余的字节属于下一个文档
+  const string input = "[1, 2] {\"a\": 3}";
+  PushParser parser;
+  EXPECT_EQ(parser.Feed(input), PushParser::kComplete);
+  EXPECT_EQ(parser.Consumed(), 6);
+  EXPECT_EQ(parser.Value(), Json({1, 2}));
+
+  parser.Reset();
+  EXPECT_EQ(parser.Feed(input.substr(6)), PushParser::kComplete);
+  EXPECT_EQ(parser.Value()["a"], Json(3));
+  // 值结束后不再读取
+  EXPECT_EQ(parser.Feed("xyz"), PushParser::kComplete);
+  EXPECT_EQ(parser.Consumed(), 0);
+}
+
+TEST(PushParserTest, Errors) {
+  const char *invalid[] = {
+      "[1 2]", "{\"a\" 1}", "{\"a\": 1 \"b\": 2}", "tru!", "nul", "[01]",
+      "[1.]", "\"\\u12g4\"", "\"\\ud800x\"", "1e999", "-"};
+  for (const char *input : invalid) {
+    PushParser parser;
+    PushParser::Status status = parser.Feed(input);
+    if (status == PushParser::kNeedMoreData) {
+      status = parser.Finish();
+    }
+    EXPECT_EQ(status, PushParser::kError) << input;
+    EXPECT_EQ(parser.Error().find("syntax error in line "), 0) << input;
+  }
+
+  PushParser parser;
+  EXPECT_EQ(parser.Feed("[1,\n2,\n\n x]"), PushParser::kError);
+  EXPECT_NE(parser.Error().find("line 4"), string::npos);
+  // 出错后不再读取
+  EXPECT_EQ(parser.Feed("[]"), PushParser::kError);
+  EXPECT_EQ(parser.Consumed(), 0);
+
+  parser.Reset();
+  EXPECT_EQ(parser.Feed("[1, "), PushParser::kNeedMoreData);
+  EXPECT_EQ(parser.Finish(), PushParser::kError);
+}
+
+TEST(PushParserTest, HandlerEvents) {
+  class CountHandler : public Handler {
+   public:
+    void OnInt(long long value) override { sum_ += value; }
+    void OnKey(const string &key) override { keys_ += key; }
+    long long sum_ = 0;
+    string keys_;
+  } handler;
+
+  PushParser parser(handler);
+  EXPECT_EQ(parser.Feed("[1, {\"ab"), PushParser::kNeedMoreData);
+  EXPECT_EQ(parser.Feed("c\": 2, \"d\": [3"), PushParser::kNeedMoreData);
+  EXPECT_EQ(parser.Feed("]}]"), PushParser::kComplete);
+  EXPECT_EQ(handler.sum_, 6);
+  EXPECT_EQ(handler.keys_, "abcd");
+  EXPECT_TRUE(parser.Value().IsNull());
+}
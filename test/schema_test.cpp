@@ -0,0 +1,296 @@
+// 测试Schema的编译和校验
+
+#include "schema.h"
+
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "json.h"
+#include "parser.h"
+
+using namespace jiayuancs::jsoncpp;
+using namespace std;
+
+namespace {
+
+const char *kOrderSchema = R"({
+  "$schema": "https://json-schema.org/draft/2020-12/schema",
+  "title": "order",
+  "type": "object",
+  "required": ["id", "items"],
+  "properties": {
+    "id": {"type": "integer", "minimum": 1},
+    "status": {"enum": ["new", "paid", 3]},
+    "code": {"type": "string", "pattern": "^[A-Z]{2}-[0-9]+$",
+             "minLength": 4, "maxLength": 8},
+    "items": {
+      "type": "array", "minItems": 1, "maxItems": 3,
+      "items": {
+        "type": "object",
+        "required": ["sku"],
+        "properties": {"sku": {"type": "string"},
+                       "price": {"type": "number", "exclusiveMinimum": 0}},
+        "additionalProperties": false
+      }
+    },
+    "tags": {"type": ["array", "null"], "items": {"type": "string"}},
+    "point": {"const": [1, 2]}
+  },
+  "additionalProperties": {"type": ["string", "boolean"]}
+})";
+
+// 合法的items成员，使每个用例只有一处错误
+const string kItems = "\"items\": [{\"sku\": \"a\"}]";
+
+Schema OrderSchema() { return Schema(Parser(kOrderSchema).Parse()); }
+
+// 分别用Validate()和流式校验检查text，两者的结果应当相同
+string Check(const Schema &schema, const string &text) {
+  string tree_error;
+  schema.Validate(Parser(text).Parse(), &tree_error);
+
+  string stream_error;
+  try {
+    Parser parser(text);
+    schema.Parse(parser);
+  } catch (const logic_error &e) {
+    stream_error = e.what();
+  }
+  EXPECT_EQ(tree_error, stream_error) << text;
+  return tree_error;
+}
+
+}  // namespace
+
+TEST(SchemaTest, Valid) {
+  Schema schema = OrderSchema();
+  EXPECT_EQ(Check(schema, "{\"id\": 1, \"items\": [{\"sku\": \"a\"}]}"), "");
+  EXPECT_EQ(Check(schema,
+                  "{\"id\": 2.0, \"status\": 3.0, \"code\": \"AB-12\","
+                  " \"items\": [{\"sku\": \"a\", \"price\": 0.5},"
+                  " {\"sku\": \"b\"}], \"tags\": null, \"point\": [1, 2],"
+                  " \"note\": \"x\", \"gift\": true}"),
+            "");
+
+  // Schema::Parse()构建与Parser::Parse()相同的Json对象
+  const char *text = "{\"id\": 7, \"items\": [{\"sku\": \"z\"}], \"tags\": []}";
+  Parser parser(text);
+  EXPECT_EQ(schema.Parse(parser), Parser(text).Parse());
+
+  // true和空schema接受任何值
+  EXPECT_TRUE(Schema(Json(true)).Validate(Parser("[{}, 1]").Parse()));
+  EXPECT_TRUE(Schema(Parser("{}").Parse()).Validate(Json()));
+}
+
+TEST(SchemaTest, Violations) {
+  Schema schema = OrderSchema();
+  EXPECT_EQ(Check(schema, "[]"), "schema violation at \"\": type mismatch");
+  EXPECT_EQ(Check(schema, "{\"items\": [{\"sku\": \"a\"}]}"),
+            "schema violation at \"\": missing required property \"id\"");
+  EXPECT_EQ(Check(schema, "{\"id\": 0, " + kItems + "}"),
+            "schema violation at \"/id\": number below minimum");
+  EXPECT_EQ(Check(schema, "{\"id\": 1.5, " + kItems + "}"),
+            "schema violation at \"/id\": type mismatch");
+  EXPECT_EQ(Check(schema, "{\"id\": 1, \"items\": []}"),
+            "schema violation at \"/items\": too few items");
+  EXPECT_EQ(Check(schema, "{\"id\": 1, \"items\": [{\"sku\": \"a\"},"
+                          " {\"sku\": \"b\"}, {\"sku\": \"c\"}, 4]}"),
+            "schema violation at \"/items/3\": too many items");
+  EXPECT_EQ(Check(schema, "{\"id\": 1, \"items\": [{\"sku\": \"a\"},"
+                          " {\"sku\": \"b\", \"price\": 0}]}"),
+            "schema violation at \"/items/1/price\": number below minimum");
+  EXPECT_EQ(
+      Check(schema, "{\"id\": 1, \"items\": [{\"sku\": \"a\", \"n\": 1}]}"),
+      "schema violation at \"/items/0/n\": additional property not allowed");
+  EXPECT_EQ(Check(schema, "{\"id\": 1, \"items\": [{\"price\": 1}]}"),
+            "schema violation at \"/items/0\": missing required property "
+            "\"sku\"");
+  EXPECT_EQ(Check(schema, "{\"id\": 1, \"status\": \"old\", " + kItems + "}"),
+            "schema violation at \"/status\": value not in enum");
+  EXPECT_EQ(Check(schema, "{\"code\": \"ab-12\", \"id\": 1, " + kItems + "}"),
+            "schema violation at \"/code\": string does not match pattern");
+  EXPECT_EQ(Check(schema, "{\"code\": \"AB-123456\", \"id\": 1}"),
+            "schema violation at \"/code\": string longer than maxLength");
+  EXPECT_EQ(Check(schema, "{\"id\": 1, \"tags\": [\"a\", 1], " + kItems + "}"),
+            "schema violation at \"/tags/1\": type mismatch");
+  EXPECT_EQ(Check(schema, "{\"id\": 1, \"point\": [1, 3], " + kItems + "}"),
+            "schema violation at \"/point\": value not in enum");
+  EXPECT_EQ(Check(schema, "{\"id\": 1, \"a/b\": 1, " + kItems + "}"),
+            "schema violation at \"/a~1b\": type mismatch");
+
+  // minLength按码点计算
+  Schema length(Parser("{\"minLength\": 2, \"maxLength\": 2}").Parse());
+  EXPECT_TRUE(length.Validate(Parser("\"\xE4\xB8\xAD\xE6\x96\x87\"").Parse()));
+  EXPECT_FALSE(length.Validate(Parser("\"\xE4\xB8\xAD\"").Parse()));
+  EXPECT_FALSE(Schema(Json(false)).Validate(Json()));
+}
+
+TEST(SchemaTest, NumericComparison) {
+  // enum和const中嵌套的数字同样按数值比较
+  Schema nested(Parser("{\"enum\": [{\"a\": 1}, [1, [2.5]]]}").Parse());
+  EXPECT_EQ(Check(nested, "{\"a\": 1.0}"), "");
+  EXPECT_EQ(Check(nested, "[1.0, [2.5]]"), "");
+  EXPECT_EQ(Check(nested, "{\"a\": 1.5}"),
+            "schema violation at \"\": value not in enum");
+  EXPECT_EQ(Check(nested, "{\"a\": 1, \"b\": 1}"),
+            "schema violation at \"\": value not in enum");
+  EXPECT_EQ(Check(nested, "[1, [2.5], 3]"),
+            "schema violation at \"\": value not in enum");
+  Schema constant(Parser("{\"const\": {\"x\": [0]}}").Parse());
+  EXPECT_EQ(Check(constant, "{\"x\": [0.0]}"), "");
+  EXPECT_EQ(Check(constant, "{\"x\": [\"0\"]}"),
+            "schema violation at \"\": value not in enum");
+
+  // 超过2^53的整数精确比较，不经过double舍入
+  Schema minimum(Parser("{\"minimum\": 9007199254740993}").Parse());
+  EXPECT_EQ(Check(minimum, "9007199254740993"), "");
+  EXPECT_EQ(Check(minimum, "9007199254740992"),
+            "schema violation at \"\": number below minimum");
+  EXPECT_EQ(Check(minimum, "9007199254740992.0"),
+            "schema violation at \"\": number below minimum");
+  Schema maximum(Parser("{\"exclusiveMaximum\": 9223372036854775807}").Parse());
+  EXPECT_EQ(Check(maximum, "9223372036854775806"), "");
+  EXPECT_EQ(Check(maximum, "9223372036854775807"),
+            "schema violation at \"\": number above maximum");
+  EXPECT_EQ(Check(maximum, "9223372036854775807.0"),
+            "schema violation at \"\": number above maximum");
+  EXPECT_FALSE(Schema(Parser("{\"const\": 9007199254740993}").Parse())
+                   .Validate(Parser("9007199254740992").Parse()));
+
+  // 整数与double混合时，范围外的double和小数部分都参与比较
+  Schema mixed(Parser("{\"minimum\": -1.5, \"maximum\": 2}").Parse());
+  EXPECT_EQ(Check(mixed, "-1"), "");
+  EXPECT_EQ(Check(mixed, "2.0"), "");
+  EXPECT_EQ(Check(mixed, "-2"),
+            "schema violation at \"\": number below minimum");
+  EXPECT_EQ(Check(mixed, "2.000001"),
+            "schema violation at \"\": number above maximum");
+  EXPECT_EQ(Check(Schema(Parser("{\"maximum\": 1e300}").Parse()),
+                  "-9223372036854775808"),
+            "");
+  EXPECT_EQ(Check(Schema(Parser("{\"minimum\": 1e19}").Parse()),
+                  "9223372036854775807"),
+            "schema violation at \"\": number below minimum");
+}
+
+TEST(SchemaTest, Streaming) {
+  // 流式校验在第一处错误时停止，之后的语法错误不会被读到
+  Schema schema(Parser("{\"items\": {\"type\": \"integer\"}, \"maxItems\": 2}")
+                    .Parse());
+  Parser parser("[1, 2, 3, oops");
+  try {
+    schema.Parse(parser);
+    FAIL();
+  } catch (const logic_error &e) {
+    EXPECT_STREQ(e.what(), "schema violation at \"/2\": too many items");
+  }
+
+  // object的关键字不约束array，array的关键字也不约束object
+  for (const char *text :
+       {"{\"required\": [\"a\"]}", "{\"minProperties\": 1}",
+        "{\"maxProperties\": 0}", "{\"additionalProperties\": false}",
+        "{\"properties\": {\"a\": false}, \"required\": [\"a\"]}"}) {
+    Schema object_schema(Parser(text).Parse());
+    EXPECT_EQ(Check(object_schema, "[1, [2]]"), "") << text;
+    EXPECT_EQ(Check(object_schema, "[]"), "") << text;
+  }
+  for (const char *text :
+       {"{\"minItems\": 1}", "{\"maxItems\": 0}", "{\"items\": false}"}) {
+    Schema array_schema(Parser(text).Parse());
+    EXPECT_EQ(Check(array_schema, "{\"a\": [1]}"), "") << text;
+    EXPECT_EQ(Check(array_schema, "{}"), "") << text;
+  }
+  // 嵌套时同样如此
+  Schema nested(Parser("{\"items\": {\"required\": [\"a\"]}}").Parse());
+  EXPECT_EQ(Check(nested, "[[1], {\"a\": 1}]"), "");
+  EXPECT_EQ(Check(nested, "[[], {}]"),
+            "schema violation at \"/1\": missing required property \"a\"");
+
+  // 只校验，不构建Json对象
+  SchemaValidator validator(schema);
+  Parser valid("[1, 2]");
+  EXPECT_NO_THROW(valid.Parse(validator));
+}
+
+TEST(SchemaTest, Pattern) {
+  auto matches = [](const string &pattern, const string &text) {
+    Json schema;
+    schema["pattern"] = pattern;
+    Json value = text;
+    return Schema(schema).Validate(value);
+  };
+  // 未锚定时在字符串中搜索
+  EXPECT_TRUE(matches("b+", "abbc"));
+  EXPECT_FALSE(matches("^b+", "abbc"));
+  EXPECT_TRUE(matches("^(?:ab|cd){2,3}$", "abcdab"));
+  EXPECT_FALSE(matches("^(?:ab|cd){2,3}$", "ab"));
+  EXPECT_TRUE(matches("^[^\\d\\s]+\\.x?$", "a_b."));
+  EXPECT_FALSE(matches("^[^\\d\\s]+\\.x?$", "a b."));
+  EXPECT_TRUE(matches("\\bcat\\b", "a cat!"));
+  EXPECT_FALSE(matches("\\bcat\\b", "concat"));
+  EXPECT_TRUE(matches("a{,2}", "a{,2}"));  // 不构成量词的'{'是普通字符
+  // 按码点匹配
+  EXPECT_TRUE(matches("^.$", "\xE4\xB8\xAD"));
+  EXPECT_TRUE(matches("^[\\u4e00-\\u9fff]+$", "\xE4\xB8\xAD\xE6\x96\x87"));
+
+  // 匹配不回溯，很长的字符串也不会耗尽栈空间
+  Schema schema(Parser("{\"type\": \"string\", \"pattern\": \"^(a|b)*$\"}")
+                    .Parse());
+  string text = "\"" + string(100000, 'a') + "\"";
+  EXPECT_EQ(Check(schema, text), "");
+  text.insert(text.size() - 1, "c");
+  EXPECT_EQ(Check(schema, text),
+            "schema violation at \"\": string does not match pattern");
+  EXPECT_FALSE(matches("^(a*)*b$", string(100000, 'a')));
+}
+
+TEST(SchemaTest, InvalidSchema) {
+  EXPECT_THROW(Schema(Json(1)), logic_error);
+  EXPECT_THROW(Schema(Parser("{\"type\": \"float\"}").Parse()), logic_error);
+  EXPECT_THROW(Schema(Parser("{\"minItems\": -1}").Parse()), logic_error);
+  EXPECT_THROW(Schema(Parser("{\"pattern\": \"(\"}").Parse()), logic_error);
+  // 需要回溯的语法不受支持
+  EXPECT_THROW(Schema(Parser("{\"pattern\": \"(a)\\\\1\"}").Parse()),
+               logic_error);
+  EXPECT_THROW(Schema(Parser("{\"pattern\": \"a(?=b)\"}").Parse()),
+               logic_error);
+  EXPECT_THROW(Schema(Parser("{\"pattern\": \"a{3,2}\"}").Parse()),
+               logic_error);
+  // 超出std::size_t范围的计数按不限处理
+  Schema unlimited(Parser("{\"maxLength\": 1e300}").Parse());
+  EXPECT_TRUE(unlimited.Validate(Json("abc")));
+  EXPECT_THROW(Schema(Parser("{\"required\": [1]}").Parse()), logic_error);
+  try {
+    Schema(Parser("{\"properties\": {\"a\": {\"oneOf\": []}}}").Parse());
+    FAIL();
+  } catch (const logic_error &e) {
+    EXPECT_STREQ(e.what(),
+                 "invalid schema at \"/properties/a\": unsupported keyword "
+                 "\"oneOf\"");
+  }
+}
+
+TEST(SchemaTest, SharedAcrossThreads) {
+  // 编译一次，多个线程同时使用同一个Schema
+  const Schema schema = OrderSchema();
+  const Json valid =
+      Parser("{\"id\": 1, \"items\": [{\"sku\": \"a\"}]}").Parse();
+  const Json invalid = Parser("{\"id\": 1, \"items\": [{\"sku\": 1}]}").Parse();
+  vector<int> results(4, 0);
+  vector<thread> threads;
+  for (int i = 0; i < 4; ++i) {
+    threads.emplace_back([&, i]() {
+      Schema copy = schema;
+      for (int j = 0; j < 200; ++j) {
+        results[i] += copy.Validate(valid) && !schema.Validate(invalid);
+      }
+    });
+  }
+  for (thread &t : threads) {
+    t.join();
+  }
+  EXPECT_EQ(results, vector<int>(4, 200));
+}
@@ -0,0 +1,125 @@
+// 测试解析统计和内存分配钩子，需以-DJSONCPP_STATS=ON构建
+
+#include "stats.h"
+
+#ifdef JSONCPP_STATS
+
+#include <string>
+
+#include "arena.h"
+#include "gtest/gtest.h"
+#include "json.h"
+#include "parser.h"
+#include "projection.h"
+
+using namespace jiayuancs::jsoncpp;
+using namespace std;
+
+namespace {
+
+// 记录当前仍未释放的字节数
+class CountingHook final : public AllocationHook {
+ public:
+  void OnAllocate(size_t bytes) override {
+    ++allocations;
+    live_bytes += bytes;
+  }
+  void OnDeallocate(size_t bytes) override { live_bytes -= bytes; }
+
+  size_t allocations = 0;
+  long long live_bytes = 0;
+};
+
+}  // namespace
+
+TEST(StatsTest, Collect) {
+  const string text =
+      "{\"name\": \"a\\tb\", \"list\": [1, 2.5, [true, null]],"
+      " \"long\": \"0123456789abcdefghij\\u0041\"}";
+  ParseStats stats;
+  Parser parser(text);
+  parser.CollectStats(&stats);
+  Json json = parser.Parse();
+
+  EXPECT_EQ(stats.parses, 1u);
+  EXPECT_EQ(stats.bytes_consumed, text.size());
+  EXPECT_EQ(stats.node_counts[Json::kNull], 1u);
+  EXPECT_EQ(stats.node_counts[Json::kBool], 1u);
+  EXPECT_EQ(stats.node_counts[Json::kInt], 1u);
+  EXPECT_EQ(stats.node_counts[Json::kDouble], 1u);
+  EXPECT_EQ(stats.node_counts[Json::kString], 2u);
+  EXPECT_EQ(stats.node_counts[Json::kArray], 2u);
+  EXPECT_EQ(stats.node_counts[Json::kObject], 1u);
+  EXPECT_EQ(stats.max_depth, 3u);
+  // key: name list long，值: "a\tb" "0123456789abcdefghijA"
+  EXPECT_EQ(stats.string_bytes, 12u + 3u + 21u);
+  EXPECT_EQ(stats.escape_count, 2u);
+  EXPECT_GT(stats.allocation_count, 0u);
+  EXPECT_GT(stats.allocation_bytes, 0u);
+
+  // 统计在多次解析间累加，投影解析只统计选中的部分
+  Parser projected(text);
+  projected.CollectStats(&stats);
+  projected.Parse(Projection{"/name"});
+  EXPECT_EQ(stats.parses, 2u);
+  EXPECT_EQ(stats.bytes_consumed, text.size() * 2);
+  EXPECT_EQ(stats.node_counts[Json::kObject], 2u);
+  EXPECT_EQ(stats.node_counts[Json::kString], 3u);
+
+  stats.Reset();
+  EXPECT_EQ(stats.parses, 0u);
+  EXPECT_EQ(stats.allocation_count, 0u);
+
+  // 停止统计后不再累加
+  Parser stopped(text);
+  stopped.CollectStats(&stats);
+  stopped.CollectStats(nullptr);
+  stopped.Parse();
+  EXPECT_EQ(stats.parses, 0u);
+}
+
+TEST(StatsTest, Errors) {
+  // 出错的解析不计入消耗的字节数，已产生的事件仍被统计
+  ParseStats stats;
+  Parser parser("[1, 2,");
+  parser.CollectStats(&stats);
+  EXPECT_THROW(parser.Parse(), logic_error);
+  EXPECT_EQ(stats.parses, 1u);
+  EXPECT_EQ(stats.bytes_consumed, 0u);
+  EXPECT_EQ(stats.node_counts[Json::kInt], 2u);
+}
+
+TEST(StatsTest, AllocationHook) {
+  CountingHook hook;
+  {
+    ScopedAllocationHook scope(&hook);
+    EXPECT_EQ(GetAllocationHook(), &hook);
+    {
+      Json json = Parser("{\"key\": [\"0123456789abcdefghij\", [1]]}").Parse();
+      Json copy = json;
+      EXPECT_GT(hook.allocations, 0u);
+      EXPECT_GT(hook.live_bytes, 0);
+    }
+    // 分配和释放的字节数一一对应
+    EXPECT_EQ(hook.live_bytes, 0);
+
+    {
+      Arena arena(256);
+      Parser("[\"0123456789abcdefghij\", [1, 2, 3]]").Parse(arena);
+      EXPECT_GE(hook.live_bytes, 256);
+    }
+    EXPECT_EQ(hook.live_bytes, 0);
+
+    // 解析时的统计同时转发给外层的钩子
+    size_t allocations = hook.allocations;
+    ParseStats stats;
+    Parser parser("[[1], {\"k\": [2]}]");
+    parser.CollectStats(&stats);
+    Json json = parser.Parse();
+    EXPECT_EQ(hook.allocations - allocations, stats.allocation_count);
+    EXPECT_EQ(GetAllocationHook(), &hook);
+  }
+  EXPECT_EQ(GetAllocationHook(), nullptr);
+}
+
+#endif  // JSONCPP_STATS
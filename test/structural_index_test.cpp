@@ -0,0 +1,198 @@
+// 测试结构字符索引及两阶段解析
+
+#include "structural_index.h"
+
+#include <cstdint>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "parser.h"
+#include "projection.h"
+
+using namespace jiayuancs::jsoncpp;
+using namespace std;
+
+namespace {
+
+bool IsSpaceChar(char ch) {
+  return ch == ' ' || ch == '\t' || ch == '\n' || ch == '\r';
+}
+
+bool IsOpChar(char ch) {
+  return ch == '{' || ch == '}' || ch == '[' || ch == ']' || ch == ':' ||
+         ch == ',';
+}
+
+// 逐字节计算结构位置，作为各指令集实现的参照
+// 与SIMD实现一致，字符串外的反斜杠同样会转义其后的字符(这种输入本身不合法)
+vector<uint32_t> ReferenceIndex(const string &input) {
+  vector<uint32_t> result;
+  bool in_string = false;
+  bool escaped = false;
+  bool prev_scalar = false;  // 前一个字符是否为标量字符
+  for (size_t i = 0; i < input.size(); ++i) {
+    char ch = input[i];
+    bool quote = ch == '\"' && !escaped;
+    escaped = ch == '\\' && !escaped;
+    if (in_string) {
+      // 结束引号也是结构位置
+      if (quote) {
+        result.push_back(i);
+        in_string = false;
+      }
+      prev_scalar = false;
+      continue;
+    }
+    if (IsOpChar(ch) || quote) {
+      result.push_back(i);
+      in_string = quote;
+      prev_scalar = false;
+    } else if (IsSpaceChar(ch)) {
+      prev_scalar = false;
+    } else {
+      if (!prev_scalar) {
+        result.push_back(i);
+      }
+      prev_scalar = true;
+    }
+  }
+  return result;
+}
+
+string RandomInput(mt19937 &rng, size_t length) {
+  static const char kAlphabet[] = "{}[]:,\"\\\\   \t\n\ra1-.e";
+  uniform_int_distribution<size_t> pick(0, sizeof(kAlphabet) - 2);
+  string input(length, ' ');
+  for (auto &ch : input) {
+    ch = kAlphabet[pick(rng)];
+  }
+  return input;
+}
+
+// 解析text，返回结果及其后是否还有多余字符，或者错误信息
+string ParseResult(const string &text, bool use_index) {
+  try {
+    Parser parser(text);
+    if (use_index) {
+      parser.UseStructuralIndex();
+    }
+    Json json = parser.Parse();
+    return json.dump() + (parser.AtEnd() ? "" : " (trailing)");
+  } catch (const logic_error &e) {
+    return e.what();
+  }
+}
+
+const char *kDocument =
+    "{\n  \"name\" : \"jsoncpp \\\"index\\\" \\\\\",\n"
+    "  \"values\" : [ 1 , -2.5 , true , false , null , \"[{,:}]\" ],\n"
+    "  \"nested\" : { \"empty\" : { } , \"list\" : [ [ ] , [ 1 ] ] }\n}\n";
+
+}  // namespace
+
+TEST(StructuralIndexTest, SimpleInput) {
+  string input = "{\"a\" : [1, \"x,y\", true]}";
+  vector<uint32_t> indexes;
+  BuildStructuralIndex(input.data(), input.size(), indexes, kScalar);
+  vector<uint32_t> target = {0, 1, 3, 5, 7, 8, 9, 11, 15, 16, 18, 22, 23};
+  EXPECT_EQ(indexes, target);
+  // 按实际的结构位置数量分配空间，另留一个位置给哨兵
+  EXPECT_EQ(indexes.capacity(), target.size() + 1);
+
+  // 重复使用时先清空原有内容
+  BuildStructuralIndex("  [ ]", 5, indexes, kScalar);
+  EXPECT_EQ(indexes, (vector<uint32_t>{2, 4}));
+};
+
+TEST(StructuralIndexTest, AllLevelsMatchReference) {
+  mt19937 rng(20240601);
+  for (size_t length : {0, 1, 63, 64, 65, 127, 128, 1000, 4096}) {
+    for (int round = 0; round < 20; ++round) {
+      string input = RandomInput(rng, length);
+      vector<uint32_t> target = ReferenceIndex(input);
+      for (SimdLevel level : {kScalar, kSse2, kAvx2}) {
+        vector<uint32_t> indexes;
+        BuildStructuralIndex(input.data(), input.size(), indexes, level);
+        EXPECT_EQ(indexes, target) << "level " << level << ": " << input;
+      }
+    }
+  }
+};
+
+TEST(StructuralIndexTest, ParserWithIndex) {
+  string document = kDocument;
+  Json target = Parser(document).Parse();
+
+  Parser parser(document);
+  parser.UseStructuralIndex();
+  EXPECT_EQ(parser.Parse(), target);
+
+  // 跨越多个分块的长文档
+  string long_document = "[";
+  for (int i = 0; i < 200; ++i) {
+    long_document += (i == 0 ? "\n  " : " ,\n  ");
+    long_document += document;
+  }
+  long_document += "\n]";
+  Parser long_parser(long_document);
+  long_parser.UseStructuralIndex();
+  Json json = long_parser.Parse();
+  ASSERT_EQ(json.GetConstArray().size(), 200);
+  EXPECT_EQ(json.GetConstArray()[199], target);
+};
+
+TEST(StructuralIndexTest, ParserErrorsWithIndex) {
+  for (const char *input :
+       {"[truex]", "[1 2]", "[1, \"abc\"x]", "{\"a\" 1}", "[1, 2",
+        "\"unterminated", "{\"a\": [1, }", "  "}) {
+    Parser parser(input);
+    parser.UseStructuralIndex();
+    EXPECT_THROW(parser.Parse(), logic_error) << input;
+  }
+
+  try {
+    Parser parser("[1,\n2,\n\n x]");
+    parser.UseStructuralIndex();
+    parser.Parse();
+    FAIL();
+  } catch (const logic_error &e) {
+    EXPECT_NE(string(e.what()).find("line 4"), string::npos);
+  }
+};
+
+// 两阶段解析与逐字节解析的结果和错误信息完全相同
+TEST(StructuralIndexTest, MatchesParserWithoutIndex) {
+  // 跨越分块边界的长字符串，含转义字符和不含转义字符各一个
+  string long_text(100, 'x');
+  string escaped = long_text + "\\\"\\u00e9\\n" + long_text;
+  string document = string(kDocument) + " ";
+  for (const string &text :
+       {document, "[\"" + long_text + "\", \"" + escaped + "\"]",
+        "{\"" + escaped + "\": \"" + long_text + "\"}", string("1 x"),
+        string("[1\"a\"]"), string("\"a\" \"b\""), string("[\"a\\\"]")}) {
+    EXPECT_EQ(ParseResult(text, true), ParseResult(text, false)) << text;
+  }
+
+  // 按投影解析时不使用索引
+  Projection projection({"/values", "/nested/list/1"});
+  Parser projected(document);
+  projected.UseStructuralIndex();
+  EXPECT_EQ(projected.Parse(projection), Parser(document).Parse(projection));
+  EXPECT_TRUE(projected.AtEnd());
+
+  // 随机修改合法文档中的字符
+  static const char kAlphabet[] = "{}[]:,\"\\ \n1-.etx";
+  mt19937 rng(20240602);
+  uniform_int_distribution<size_t> pick(0, sizeof(kAlphabet) - 2);
+  for (int round = 0; round < 2000; ++round) {
+    string text = document;
+    uniform_int_distribution<size_t> position(0, text.size() - 1);
+    for (int i = 0; i < 3; ++i) {
+      text[position(rng)] = kAlphabet[pick(rng)];
+    }
+    EXPECT_EQ(ParseResult(text, true), ParseResult(text, false)) << text;
+  }
+};
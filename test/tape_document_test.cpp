@@ -0,0 +1,117 @@
+// 测试TapeDocument和JsonView
+
+#include "tape_document.h"
+
+#include <cstdio>
+#include <stdexcept>
+#include <string>
+
+#include "gtest/gtest.h"
+#include "json.h"
+#include "parser.h"
+
+using namespace jiayuancs::jsoncpp;
+using namespace std;
+
+namespace {
+
+const char *kDocument =
+    "{\"name\": \"jsoncpp\", \"version\": 3, \"ratio\": -2.5, "
+    "\"tags\": [\"json\", \"c++\", {\"nested\": [[]]}], "
+    "\"flags\": {\"ok\": true, \"bad\": false, \"none\": null}, "
+    "\"text\": \"line\\nbreak \\u4e2d\"}";
+
+}  // namespace
+
+TEST(TapeDocumentTest, Navigation) {
+  TapeDocument document = TapeDocument::Parse(kDocument);
+  JsonView root = document.Root();
+  EXPECT_TRUE(root.IsObject());
+  EXPECT_EQ(root.Size(), 6);
+  EXPECT_EQ(document["name"].GetString(), "jsoncpp");
+  EXPECT_EQ(document["version"].GetInteger(), 3);
+  EXPECT_EQ(document["ratio"].GetDouble(), -2.5);
+  EXPECT_EQ(document["text"].GetString(), "line\nbreak \u4e2d");
+
+  JsonView tags = root["tags"];
+  EXPECT_TRUE(tags.IsArray());
+  EXPECT_EQ(tags.Size(), 3);
+  EXPECT_EQ(tags[1].GetString(), "c++");
+  EXPECT_EQ(tags[2]["nested"][0].Size(), 0);
+  EXPECT_TRUE(root["flags"]["ok"].GetBool());
+  EXPECT_FALSE(root["flags"]["bad"].GetBool());
+  EXPECT_TRUE(root["flags"]["none"].IsNull());
+
+  JsonView value = root;
+  EXPECT_TRUE(root.Find("ratio", value));
+  EXPECT_TRUE(value.IsDouble());
+  EXPECT_FALSE(root.Find("missing", value));
+
+  string keys;
+  for (const JsonView::Iterator &child : root) {
+    keys += child.Key().ToString() + " ";
+  }
+  EXPECT_EQ(keys, "name version ratio tags flags text ");
+  int count = 0;
+  for (const JsonView::Iterator &child : tags) {
+    EXPECT_EQ(child.Value().Type(), tags[count++].Type());
+  }
+  EXPECT_EQ(count, 3);
+
+  EXPECT_THROW(root["missing"], logic_error);
+  EXPECT_THROW(tags[3], logic_error);
+  EXPECT_THROW(tags["name"], logic_error);
+  EXPECT_THROW(root["name"].GetInteger(), logic_error);
+  EXPECT_THROW(root["version"].begin(), logic_error);
+  EXPECT_THROW(TapeDocument::Parse("[1, 2"), logic_error);
+}
+
+TEST(TapeDocumentTest, ToJson) {
+  Json json = Parser(kDocument).Parse();
+  EXPECT_EQ(TapeDocument::Parse(kDocument).Root().ToJson(), json);
+  EXPECT_EQ(TapeDocument::FromJson(json).Root().ToJson(), json);
+  EXPECT_EQ(TapeDocument::Parse("12").Root().ToJson(), Json(12));
+}
+
+TEST(TapeDocumentTest, DuplicateKeys) {
+  // 与Parser一致，重复的key以最后一次出现的为准
+  const char *document =
+      "{\"a\": 1, \"b\": {\"c\": [1], \"c\": [2]}, \"a\": \"x\", \"a\": 3.5}";
+  TapeDocument tape = TapeDocument::Parse(document);
+  EXPECT_EQ(tape.Root().Size(), 4);
+  EXPECT_EQ(tape["a"].GetDouble(), 3.5);
+  EXPECT_EQ(tape["b"]["c"][0].GetInteger(), 2);
+  EXPECT_EQ(tape.Root().ToJson(), Parser(document).Parse());
+}
+
+TEST(TapeDocumentTest, SaveAndLoad) {
+  Json json = Parser(kDocument).Parse();
+  TapeDocument document = TapeDocument::Parse(kDocument);
+
+  const char *path = "tape_document_test.tape";
+  document.Save(path);
+  {
+    TapeDocument loaded = TapeDocument::Load(path);
+    EXPECT_EQ(loaded["tags"][2]["nested"][0].Size(), 0);
+    EXPECT_EQ(loaded.Root().ToJson(), json);
+  }
+  remove(path);
+  EXPECT_THROW(TapeDocument::Load(path), runtime_error);
+
+  // 对齐的缓冲区直接使用，未对齐时复制
+  string buffer;
+  document.Serialize(buffer);
+  EXPECT_EQ(TapeDocument::Load(buffer.data(), buffer.size()).Root().ToJson(),
+            json);
+  string unaligned = "x" + buffer;
+  EXPECT_EQ(TapeDocument::Load(unaligned.data() + 1, buffer.size())
+                .Root()
+                .ToJson(),
+            json);
+
+  EXPECT_THROW(TapeDocument::Load(buffer.data(), 16), logic_error);
+  EXPECT_THROW(TapeDocument::Load(buffer.data(), buffer.size() - 1),
+               logic_error);
+  buffer[0] = 'X';
+  EXPECT_THROW(TapeDocument::Load(buffer.data(), buffer.size()), logic_error);
+}
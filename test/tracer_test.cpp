@@ -0,0 +1,79 @@
+// 测试解析器的token跟踪，需以-DJSONCPP_TRACE=ON构建
+
+#include "tracer.h"
+
+#ifdef JSONCPP_TRACE
+
+#include <cstdio>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "parser.h"
+
+using namespace jiayuancs::jsoncpp;
+using namespace std;
+
+TEST(TracerTest, Tokens) {
+  RingBufferTracer tracer;
+  Parser parser("[1, {\"a\": null}]");
+  parser.SetTracer(&tracer);
+  parser.Parse();
+  EXPECT_TRUE(parser.AtEnd());
+
+  vector<RingBufferTracer::Entry> entries = tracer.Entries();
+  ASSERT_EQ(entries.size(), 9u);
+  const string tokens = "[1,{\":n}]";
+  const size_t offsets[] = {0, 1, 2, 4, 5, 8, 10, 14, 15};
+  for (size_t i = 0; i < entries.size(); ++i) {
+    EXPECT_EQ(entries[i].token, tokens[i]);
+    EXPECT_EQ(entries[i].offset, offsets[i]);
+  }
+  EXPECT_EQ(tracer.TotalTokens(), 9u);
+  EXPECT_TRUE(tracer.Error().empty());
+}
+
+TEST(TracerTest, RingBuffer) {
+  // 只保留最近的capacity个token
+  RingBufferTracer tracer(3);
+  Parser parser("[1, 2, 3]");
+  parser.SetTracer(&tracer);
+  parser.Parse();
+
+  vector<RingBufferTracer::Entry> entries = tracer.Entries();
+  ASSERT_EQ(entries.size(), 3u);
+  EXPECT_EQ(entries[0].token, ',');
+  EXPECT_EQ(entries[1].token, '3');
+  EXPECT_EQ(entries[2].token, ']');
+  EXPECT_EQ(tracer.TotalTokens(), 7u);
+  EXPECT_EQ(tracer.Dump(), "5: ,\n7: 3\n8: ]\n");
+
+  tracer.Clear();
+  EXPECT_TRUE(tracer.Entries().empty());
+  EXPECT_EQ(tracer.Dump(), "");
+}
+
+TEST(TracerTest, Error) {
+  // 出错时tracer保留出错之前的token和错误信息
+  RingBufferTracer tracer;
+  Parser parser("{\"a\":\n[1 2]}");
+  parser.SetTracer(&tracer);
+  EXPECT_THROW(parser.Parse(), logic_error);
+
+  EXPECT_EQ(tracer.Error(), "syntax error in line 2: invalid array");
+  EXPECT_EQ(tracer.Dump(),
+            "0: {\n1: \"\n4: :\n6: [\n7: 1\n9: 2\n"
+            "10: syntax error in line 2: invalid array\n");
+
+  // 在输入末尾读取token时记录EOF，同一位置重复读取的只记录一次
+  RingBufferTracer eof_tracer;
+  Parser truncated("[");
+  truncated.SetTracer(&eof_tracer);
+  EXPECT_THROW(truncated.Parse(), logic_error);
+  ASSERT_EQ(eof_tracer.Entries().size(), 2u);
+  EXPECT_EQ(eof_tracer.Entries()[1].token, EOF);
+  EXPECT_EQ(eof_tracer.Entries()[1].offset, 1u);
+}
+
+#endif  // JSONCPP_TRACE